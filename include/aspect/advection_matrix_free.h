@@ -0,0 +1,287 @@
+/*
+  Copyright (C) 2020 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef _aspect_advection_matrix_free_h
+#define _aspect_advection_matrix_free_h
+
+#include <aspect/global.h>
+
+#include <aspect/simulator.h>
+
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/operators.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+namespace aspect
+{
+  using namespace dealii;
+
+  /**
+   * This namespace contains the matrix-free operators used in the solvers
+   * for the temperature and compositional field equations.
+   */
+  namespace MatrixFreeAdvectionOperators
+  {
+    /**
+     * Operator for the advection-diffusion equation of a single temperature
+     * or compositional field. Per quadrature point, the operator applies
+     * @f[
+     *   (\phi_i, m \phi_j) + (\phi_i, \mathbf a \cdot \nabla \phi_j)
+     *   + (\nabla \phi_i, d \nabla \phi_j),
+     * @f]
+     * where the mass coefficient $m$, the advection coefficient $\mathbf a$
+     * and the diffusion coefficient $d$ (which includes the entropy viscosity
+     * stabilization) are provided through fill_cell_data(). Note that this
+     * operator is not symmetric.
+     */
+    template <int dim, int degree, typename number>
+    class AdvectionOperator
+      : public MatrixFreeOperators::Base<dim, dealii::LinearAlgebra::distributed::Vector<number> >
+    {
+      public:
+
+        /**
+         * Constructor.
+         */
+        AdvectionOperator ();
+
+        /**
+         * Reset object.
+         */
+        void clear () override;
+
+        /**
+         * Sets the tables that store the mass, advection and diffusion
+         * coefficients for every cell batch and quadrature point. The
+         * tables are not copied, so they need to stay alive as long as the
+         * operator is used.
+         */
+        void fill_cell_data (const Table<2, VectorizedArray<number>> &mass_coefficient_table,
+                             const Table<2, Tensor<1, dim, VectorizedArray<number>>> &advection_coefficient_table,
+                             const Table<2, VectorizedArray<number>> &diffusion_coefficient_table);
+
+        /**
+         * Computes the diagonal of the matrix. Since matrix-free operators have not access
+         * to matrix elements, we must apply the matrix-free operator to the unit vectors to
+         * recover the diagonal.
+         */
+        void compute_diagonal () override;
+
+      private:
+
+        /**
+         * Performs the application of the matrix-free operator. This function is called by
+         * vmult() functions MatrixFreeOperators::Base.
+         */
+        void apply_add (dealii::LinearAlgebra::distributed::Vector<number> &dst,
+                        const dealii::LinearAlgebra::distributed::Vector<number> &src) const override;
+
+        /**
+         * Defines the application of the cell matrix.
+         */
+        void local_apply (const dealii::MatrixFree<dim, number> &data,
+                          dealii::LinearAlgebra::distributed::Vector<number> &dst,
+                          const dealii::LinearAlgebra::distributed::Vector<number> &src,
+                          const std::pair<unsigned int, unsigned int> &cell_range) const;
+
+        /**
+         * Computes the diagonal contribution from a cell matrix.
+         */
+        void local_compute_diagonal (const MatrixFree<dim,number>                     &data,
+                                     dealii::LinearAlgebra::distributed::Vector<number>  &dst,
+                                     const unsigned int                               &dummy,
+                                     const std::pair<unsigned int,unsigned int>       &cell_range) const;
+
+        /**
+         * Tables which store the coefficients of the operator on each cell
+         * batch and quadrature point.
+         */
+        const Table<2, VectorizedArray<number>> *mass_coefficient;
+        const Table<2, Tensor<1, dim, VectorizedArray<number>>> *advection_coefficient;
+        const Table<2, VectorizedArray<number>> *diffusion_coefficient;
+    };
+  }
+
+  /**
+   * Base class for the matrix-free advection solver. The template argument
+   * for the polynomial degree of the advected fields is introduced in the
+   * derived class AdvectionMatrixFreeHandlerImplementation. This way, the
+   * Simulator does not need to know about the degree.
+   */
+  template<int dim>
+  class AdvectionMatrixFreeHandler
+  {
+    public:
+      /**
+       * Destructor.
+       */
+      virtual ~AdvectionMatrixFreeHandler() = default;
+
+      /**
+       * Allocates and sets up the DoFHandlers, constraints and the
+       * MatrixFree object used for temperature and all compositional
+       * fields. This is called by Simulator<dim>::setup_dofs().
+       */
+      virtual void setup_dofs() = 0;
+
+      /**
+       * Reinitializes the MatrixFree object, for example after the mesh
+       * has been deformed.
+       */
+      virtual void setup_operators() = 0;
+
+      /**
+       * Return whether the given field is solved with the matrix-free
+       * solver. This is the case for temperature and all compositional
+       * fields that are advected with the field method.
+       */
+      virtual bool is_applicable (const typename Simulator<dim>::AdvectionField &advection_field) const = 0;
+
+      /**
+       * Evaluate the material and heating models for the given field, compute
+       * the coefficients of the operator, and write the right-hand side
+       * (corrected for inhomogeneous boundary values) into the corresponding
+       * block of Simulator::system_rhs. No matrix is assembled. This is
+       * called by Simulator<dim>::assemble_advection_system().
+       */
+      virtual void assemble (const typename Simulator<dim>::AdvectionField &advection_field) = 0;
+
+      /**
+       * Solve the linear system for the given field with a Jacobi
+       * preconditioned GMRES method. The vector @p solution contains the
+       * initial guess with all constrained entries set to zero on input, and
+       * the solution (again with zero constrained entries) on output.
+       * Returns the residual of the initial guess. This is called by
+       * Simulator<dim>::solve_advection().
+       */
+      virtual double solve (const typename Simulator<dim>::AdvectionField &advection_field,
+                            SolverControl &solver_control,
+                            LinearAlgebra::Vector &solution) = 0;
+  };
+
+  /**
+   * Main class of the matrix-free advection solver. Temperature and
+   * compositional fields each have their own DoFHandler and constraints,
+   * but share a single MatrixFree object.
+   */
+  template<int dim, int degree>
+  class AdvectionMatrixFreeHandlerImplementation: public AdvectionMatrixFreeHandler<dim>
+  {
+    public:
+      /**
+       * Initialize this class and check that the model only uses features
+       * supported by the matrix-free advection solver.
+       */
+      AdvectionMatrixFreeHandlerImplementation(Simulator<dim> &);
+
+      /**
+       * Destructor.
+       */
+      ~AdvectionMatrixFreeHandlerImplementation() override = default;
+
+      /**
+       * See AdvectionMatrixFreeHandler::setup_dofs().
+       */
+      void setup_dofs() override;
+
+      /**
+       * See AdvectionMatrixFreeHandler::setup_operators().
+       */
+      void setup_operators() override;
+
+      /**
+       * See AdvectionMatrixFreeHandler::is_applicable().
+       */
+      bool is_applicable (const typename Simulator<dim>::AdvectionField &advection_field) const override;
+
+      /**
+       * See AdvectionMatrixFreeHandler::assemble().
+       */
+      void assemble (const typename Simulator<dim>::AdvectionField &advection_field) override;
+
+      /**
+       * See AdvectionMatrixFreeHandler::solve().
+       */
+      double solve (const typename Simulator<dim>::AdvectionField &advection_field,
+                    SolverControl &solver_control,
+                    LinearAlgebra::Vector &solution) override;
+
+    private:
+      /**
+       * Evaluate the material and heating models on all cells of the
+       * MatrixFree object and fill the coefficient tables as well as the
+       * table of right-hand side values for the given field.
+       */
+      void evaluate_material_model (const typename Simulator<dim>::AdvectionField &advection_field);
+
+      /**
+       * Return the operator that belongs to the given field.
+       */
+      MatrixFreeAdvectionOperators::AdvectionOperator<dim,degree,double> &
+      get_operator (const typename Simulator<dim>::AdvectionField &advection_field);
+
+      /**
+       * Copy between the block of a Trilinos vector that belongs to an
+       * advected field and a vector of the matrix-free DoFHandler. Both use
+       * the same numbering and parallel partitioning.
+       */
+      static void copy (dealii::LinearAlgebra::distributed::Vector<double> &out,
+                        const LinearAlgebra::Vector &in);
+      static void copy (LinearAlgebra::Vector &out,
+                        const dealii::LinearAlgebra::distributed::Vector<double> &in);
+
+      Simulator<dim> &sim;
+
+      DoFHandler<dim> dof_handler_temperature;
+      DoFHandler<dim> dof_handler_composition;
+
+      FE_Q<dim> fe;
+
+      AffineConstraints<double> constraints_temperature;
+      AffineConstraints<double> constraints_composition;
+
+      std::shared_ptr<MatrixFree<dim,double> > matrix_free;
+
+      /**
+       * The timestep number for which the MatrixFree object was last set
+       * up. Used to recompute the mapping data once per time step if the
+       * mesh is deformed.
+       */
+      unsigned int setup_timestep_number;
+
+      Table<2, VectorizedArray<double>> mass_coefficient_table;
+      Table<2, Tensor<1, dim, VectorizedArray<double>>> advection_coefficient_table;
+      Table<2, VectorizedArray<double>> diffusion_coefficient_table;
+      Table<2, VectorizedArray<double>> rhs_table;
+
+      using AdvectionMatrixType = MatrixFreeAdvectionOperators::AdvectionOperator<dim,degree,double>;
+
+      AdvectionMatrixType temperature_matrix;
+      AdvectionMatrixType composition_matrix;
+  };
+}
+
+
+#endif
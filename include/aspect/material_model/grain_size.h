@@ -45,6 +45,8 @@ namespace aspect
 
         std::vector<double> get_nth_output(const unsigned int idx) const override;
 
+        std::unique_ptr<AdditionalMaterialOutputs<dim> > clone () const override;
+
         /**
          * Dislocation viscosities at the evaluation points passed to
          * the instance of MaterialModel::Interface::evaluate() that fills
@@ -236,6 +238,16 @@ namespace aspect
          */
         bool advect_log_grainsize;
 
+        /**
+         * Whether to integrate the grain size evolution with an error
+         * controlled time stepping scheme (if true), or with the original
+         * scheme that adapts the sub-timestep size based on the relative
+         * change of grain size (if false), and the relative tolerance used
+         * by the error controlled scheme.
+         */
+        bool use_adaptive_grain_size_evolution;
+        double grain_size_evolution_relative_tolerance;
+
 
         double viscosity (const double                  temperature,
                           const double                  pressure,
@@ -313,6 +325,67 @@ namespace aspect
                            const std::vector<double> &compositional_fields,
                            const Point<dim> &position) const;
 
+        /**
+         * The quantities that are needed to compute the rates of grain size
+         * growth and reduction at one point and that do not depend on the
+         * grain size. They stay the same during the sub-timestepping in
+         * grain_size_change(), so we compute them only once per point.
+         */
+        struct GrainSizeEvolutionCoefficients
+        {
+          /**
+           * The phase used for grain size growth and reduction.
+           */
+          unsigned int phase_index;
+
+          /**
+           * The grain growth rate is this value divided by the grain size to
+           * the power of the grain growth exponent minus one.
+           */
+          double grain_growth_prefactor;
+
+          double second_strain_rate_invariant;
+
+          /**
+           * The diffusion viscosity is this prefactor times the grain size
+           * to the power of the given exponent.
+           */
+          double diffusion_viscosity_prefactor;
+          double diffusion_viscosity_grain_size_exponent;
+
+          /**
+           * The dislocation viscosity for the full strain rate. The
+           * dislocation viscosity for a fraction $r$ of the strain rate is
+           * $r$ to the power of the given exponent times this value.
+           */
+          double dislocation_viscosity_full_strain_rate;
+          double dislocation_viscosity_strain_rate_exponent;
+        };
+
+        /**
+         * Compute the quantities needed for the grain size evolution at one
+         * point. The grain size in @p compositional_fields must be positive.
+         */
+        GrainSizeEvolutionCoefficients
+        compute_grain_size_evolution_coefficients (const double                  temperature,
+                                                   const double                  pressure,
+                                                   const std::vector<double>    &compositional_fields,
+                                                   const SymmetricTensor<2,dim> &strain_rate,
+                                                   const Point<dim>             &position) const;
+
+        /**
+         * Return the rates of grain size growth (first entry) and reduction
+         * (second entry) for the grain size @p grain_size. The dislocation
+         * viscosity is computed iteratively as in dislocation_viscosity(),
+         * starting from @p dislocation_viscosity unless it is zero. On
+         * return, @p dislocation_viscosity contains the new value, so that it
+         * can be used as the guess for the next call.
+         */
+        std::pair<double,double>
+        grain_size_growth_and_reduction_rates (const GrainSizeEvolutionCoefficients &coefficients,
+                                               const double                          grain_size,
+                                               double                               &dislocation_viscosity) const;
+
         /**
          * Rate of grain size growth (Ostwald ripening) or reduction
          * (due to dynamic recrystallization and phase transformations)
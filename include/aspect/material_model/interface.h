@@ -305,6 +305,17 @@ namespace aspect
        */
       MaterialModelInputs (const MaterialModelInputs &source);
 
+      /**
+       * Constructor. Concatenate the points of all of the given @p inputs,
+       * for example the quadrature points of several cells, into a single
+       * object. The current cell of the new object is invalid, and it
+       * requests all properties that any of the @p inputs requests.
+       *
+       * None of the @p inputs may have additional input data attached, and
+       * either all or none of them need to provide strain rates.
+       */
+      MaterialModelInputs (const std::vector<const MaterialModelInputs<dim> *> &inputs);
+
       /**
        * Move constructor. This constructor simply moves all members.
        */
@@ -509,6 +520,17 @@ namespace aspect
       */
       unsigned int n_evaluation_points() const;
 
+      /**
+       * Copy the material properties of the points
+       * @p first_point ... @p first_point + n_evaluation_points() - 1
+       * of @p source into this object. This is the inverse of concatenating
+       * several MaterialModelInputs objects into one, see the corresponding
+       * constructor of MaterialModelInputs. Additional outputs are not
+       * copied.
+       */
+      void copy_points_from (const MaterialModelOutputs<dim> &source,
+                             const unsigned int first_point);
+
       /**
        * Viscosity $\eta$ values at the given positions.
        */
@@ -809,6 +831,18 @@ namespace aspect
                               const FullMatrix<double>  &/*projection_matrix*/,
                               const FullMatrix<double>  &/*expansion_matrix*/)
         {}
+
+        /**
+         * Return a copy of this object, or a null pointer if the derived
+         * class does not support being copied, which is the default. This
+         * function is used by MaterialModelOutputCache to store additional
+         * outputs; material model evaluations with additional outputs that
+         * can not be copied are not cached.
+         */
+        virtual std::unique_ptr<AdditionalMaterialOutputs<dim> > clone () const
+        {
+          return nullptr;
+        }
     };
 
 
@@ -907,6 +941,8 @@ namespace aspect
 
         std::vector<double> get_nth_output(const unsigned int idx) const override;
 
+        std::unique_ptr<AdditionalMaterialOutputs<dim> > clone () const override;
+
         /**
          * Seismic s-wave velocities at the evaluation points passed to
          * the instance of MaterialModel::Interface::evaluate() that fills
@@ -952,6 +988,8 @@ namespace aspect
 
         std::vector<double> get_nth_output(const unsigned int idx) const override;
 
+        std::unique_ptr<AdditionalMaterialOutputs<dim> > clone () const override;
+
         /**
          * Reaction rates for all compositional fields at the evaluation points
          * that are passed to the instance of MaterialModel::Interface::evaluate()
@@ -990,6 +1028,8 @@ namespace aspect
 
         std::vector<double> get_nth_output(const unsigned int idx) const override;
 
+        std::unique_ptr<AdditionalMaterialOutputs<dim> > clone () const override;
+
         /**
          * Prescribed field outputs for all compositional fields at the evaluation points
          * that are passed to the instance of MaterialModel::Interface::evaluate()
@@ -1021,6 +1061,8 @@ namespace aspect
 
         std::vector<double> get_nth_output(const unsigned int idx) const override;
 
+        std::unique_ptr<AdditionalMaterialOutputs<dim> > clone () const override;
+
         /**
          * Prescribed field outputs for the temperature field at the evaluation points
          * that are passed to the instance of MaterialModel::Interface::evaluate()
@@ -1106,6 +1148,8 @@ namespace aspect
          */
         virtual std::vector<double> get_nth_output(const unsigned int idx) const;
 
+        std::unique_ptr<AdditionalMaterialOutputs<dim> > clone () const override;
+
         /**
          * A scalar value per evaluation point that specifies the prescribed dilation
          * in that point.
@@ -1268,6 +1312,24 @@ namespace aspect
         virtual
         void evaluate (const MaterialModel::MaterialModelInputs<dim> &in,
                        MaterialModel::MaterialModelOutputs<dim> &out) const = 0;
+
+        /**
+         * Compute the material properties for several sets of inputs at
+         * once, for example for the quadrature points of several cells.
+         * The properties for <code>*inputs[i]</code> are stored in
+         * <code>*outputs[i]</code>.
+         *
+         * The default implementation calls evaluate() for every set of
+         * inputs. Material models whose properties at a point only depend
+         * on the inputs at this point can override this function and
+         * call evaluate_pointwise_batch(), which evaluates all points in a
+         * single call to evaluate(). This reduces the overhead per call and
+         * gives the compiler longer loops to optimize.
+         */
+        virtual
+        void evaluate_batch (const std::vector<const MaterialModel::MaterialModelInputs<dim> *> &inputs,
+                             const std::vector<MaterialModel::MaterialModelOutputs<dim> *> &outputs) const;
+
         /**
          * @name Functions used in dealing with run-time parameters
          * @{
@@ -1320,6 +1382,19 @@ namespace aspect
                                               const Introspection<dim>                &introspection) const;
 
       protected:
+        /**
+         * An implementation of evaluate_batch() for material models whose
+         * properties at a point only depend on the inputs at this point.
+         * It concatenates all @p inputs into one MaterialModelInputs object,
+         * calls evaluate() once, and copies the results back into the
+         * @p outputs. If any of the inputs or outputs has additional inputs or
+         * outputs attached, or if the inputs do not agree on whether strain
+         * rates are provided, it falls back to calling evaluate() for each
+         * set of inputs separately.
+         */
+        void evaluate_pointwise_batch (const std::vector<const MaterialModel::MaterialModelInputs<dim> *> &inputs,
+                                       const std::vector<MaterialModel::MaterialModelOutputs<dim> *> &outputs) const;
+
         /**
          * A structure that describes how each of the model's
          * output variables (such as viscosity, density, etc) depend
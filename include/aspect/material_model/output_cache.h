@@ -0,0 +1,176 @@
+/*
+  Copyright (C) 2020 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _aspect_material_model_output_cache_h
+#define _aspect_material_model_output_cache_h
+
+#include <aspect/global.h>
+#include <aspect/material_model/interface.h>
+
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+
+namespace aspect
+{
+  namespace MaterialModel
+  {
+    using namespace dealii;
+
+    /**
+     * A cache for the outputs of the material model. Many postprocessors
+     * and mesh refinement criteria evaluate the material model on the same
+     * cells and at the same points for the same solution, for example at
+     * the quadrature points of the cell or at the support points of the
+     * temperature element. For expensive material models, this can cost as
+     * much as assembling the Stokes system. This class stores the outputs of
+     * every evaluation together with its inputs, and returns the stored
+     * outputs if the material model is evaluated again with identical inputs
+     * on the same cell.
+     *
+     * Because material models may depend on more than their inputs (for
+     * example on the current time, or on the solution on the cell), the
+     * owner of this object needs to call clear() whenever the solution or
+     * the mesh changes. In ASPECT, the Simulator does so at the beginning
+     * of every time step, before postprocessing, and after mesh refinement,
+     * so that postprocessors and mesh refinement criteria can share the
+     * cached outputs.
+     *
+     * Evaluations are only cached if the inputs refer to a valid cell, have
+     * no additional inputs, and if all additional outputs can be copied (see
+     * AdditionalMaterialOutputs::clone()). The memory used by the cache is
+     * bounded; once the limit is reached, no further evaluations are stored.
+     *
+     * @ingroup MaterialModels
+     */
+    template <int dim>
+    class MaterialModelOutputCache
+    {
+      public:
+        /**
+         * Constructor. The cache is disabled until a positive memory limit
+         * is set with set_memory_limit().
+         */
+        MaterialModelOutputCache ();
+
+        /**
+         * Set the maximal amount of memory (in bytes) the cache may use. A
+         * value of zero disables the cache. This function also clears the
+         * cache.
+         */
+        void set_memory_limit (const std::size_t memory_limit);
+
+        /**
+         * Remove all stored evaluations.
+         */
+        void clear ();
+
+        /**
+         * Fill @p out with the outputs of @p material_model for the inputs
+         * @p in. If the same inputs have been evaluated before on the same
+         * cell and the cache was not cleared since then, copy the stored
+         * outputs (including the requested additional outputs, which are
+         * replaced by copies of the stored ones) instead of evaluating the
+         * material model again. Otherwise, evaluate the material model and
+         * store the result if possible.
+         *
+         * This function can be called concurrently from several threads.
+         */
+        void evaluate (const Interface<dim> &material_model,
+                       const MaterialModelInputs<dim> &in,
+                       MaterialModelOutputs<dim> &out);
+
+        /**
+         * Return the approximate amount of memory (in bytes) used by the
+         * stored evaluations.
+         */
+        std::size_t memory_consumption () const;
+
+      private:
+        /**
+         * The inputs and outputs of one evaluation of the material model.
+         */
+        struct Entry
+        {
+          Entry (const MaterialModelInputs<dim> &in,
+                 const MaterialModelOutputs<dim> &out);
+
+          /**
+           * Return whether the stored inputs are the same as @p in, and
+           * the stored outputs contain everything that @p out requests.
+           */
+          bool matches (const MaterialModelInputs<dim> &in,
+                        const MaterialModelOutputs<dim> &out) const;
+
+          /**
+           * Copy the stored outputs into @p out.
+           */
+          void copy_to (MaterialModelOutputs<dim> &out) const;
+
+          /**
+           * Return the approximate amount of memory (in bytes) that an entry
+           * storing the given inputs and outputs uses.
+           */
+          static
+          std::size_t memory_consumption (const MaterialModelInputs<dim> &in,
+                                          const MaterialModelOutputs<dim> &out);
+
+          std::vector<Point<dim> > position;
+          std::vector<double> temperature;
+          std::vector<double> pressure;
+          std::vector<Tensor<1,dim> > pressure_gradient;
+          std::vector<Tensor<1,dim> > velocity;
+          std::vector<std::vector<double> > composition;
+          std::vector<SymmetricTensor<2,dim> > strain_rate;
+          MaterialProperties::Property requested_properties;
+
+          MaterialModelOutputs<dim> outputs;
+          std::vector<std::type_index> additional_output_types;
+        };
+
+        /**
+         * Return whether an evaluation with the given inputs can be stored
+         * in the cache. This does not check whether the additional outputs
+         * can be copied, which is only known once they are copied into an
+         * Entry.
+         */
+        bool can_be_cached (const MaterialModelInputs<dim> &in) const;
+
+        /**
+         * The maximal and the current amount of memory used by the cache.
+         */
+        std::size_t memory_limit;
+        std::size_t used_memory;
+
+        /**
+         * The stored evaluations, sorted by the active cell index of the
+         * cell they belong to.
+         */
+        std::unordered_map<unsigned int, std::vector<Entry> > entries;
+
+        /**
+         * A mutex that guards access to the stored evaluations.
+         */
+        mutable std::mutex mutex;
+    };
+  }
+}
+
+#endif
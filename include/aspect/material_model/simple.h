@@ -48,6 +48,13 @@ namespace aspect
         void evaluate(const MaterialModel::MaterialModelInputs<dim> &in,
                       MaterialModel::MaterialModelOutputs<dim> &out) const override;
 
+        /**
+         * Evaluate all points of all @p inputs in a single call to
+         * evaluate(), see MaterialModel::Interface::evaluate_batch().
+         */
+        void evaluate_batch (const std::vector<const MaterialModel::MaterialModelInputs<dim> *> &inputs,
+                             const std::vector<MaterialModel::MaterialModelOutputs<dim> *> &outputs) const override;
+
         /**
          * @name Qualitative properties one can ask a material model
          * @{
@@ -149,12 +149,14 @@ namespace aspect
                                   const Point<dim>             &position) const;
 
         void fill_mass_and_volume_fractions (const MaterialModel::MaterialModelInputs<dim> &in,
+                                             const std::vector<MaterialUtilities::Lookup::LookupValues> &lookup_values,
                                              std::vector<std::vector<double>> &mass_fractions,
                                              std::vector<std::vector<double>> &volume_fractions) const;
 
         void fill_seismic_velocities (const MaterialModel::MaterialModelInputs<dim> &in,
                                       const std::vector<double> &composite_densities,
                                       const std::vector<std::vector<double>> &volume_fractions,
+                                      const std::vector<MaterialUtilities::Lookup::LookupValues> &lookup_values,
                                       SeismicAdditionalOutputs<dim> *seismic_out) const;
 
         /**
@@ -162,7 +164,8 @@ namespace aspect
         * of the phase_volume_fractions_out output object with the volume
         * fractions of each of the unique phases at each of the evaluation points.
         * These volume fractions are obtained from the PerpleX-derived
-        * pressure-temperature lookup tables.
+        * pressure-temperature lookup tables, evaluated at all points in
+        * @p lookup_values.
         * The filled output_values object is a vector of vector<double>;
         * the outer vector is expected to have a size that equals the number
         * of unique phases, the inner vector is expected to have a size that
@@ -170,6 +173,7 @@ namespace aspect
         */
         void fill_phase_volume_fractions (const MaterialModel::MaterialModelInputs<dim> &in,
                                           const std::vector<std::vector<double>> &volume_fractions,
+                                          const std::vector<MaterialUtilities::Lookup::LookupValues> &lookup_values,
                                           NamedAdditionalMaterialOutputs<dim> *phase_volume_fractions_out) const;
 
         /**
@@ -45,6 +45,69 @@ namespace aspect
     {
       namespace Lookup
       {
+        /**
+         * A namespace for the properties that can be requested from
+         * MaterialLookup::evaluate().
+         */
+        namespace LookupProperties
+        {
+          /**
+           * An enum whose members identify the properties stored in a
+           * material lookup table. The values of the enum represent single
+           * bits in an integer, so that several properties can be combined
+           * with the operator |.
+           */
+          enum Property
+          {
+            none                   = 0,
+            density                = 1,
+            thermal_expansivity    = 2,
+            specific_heat          = 4,
+            seismic_Vp             = 8,
+            seismic_Vs             = 16,
+            enthalpy               = 32,
+            dRhodp                 = 64,
+            phase_volume_fractions = 128
+          };
+
+          /**
+           * Provide an operator that or's two Property variables. This allows to
+           * combine more than one property in a single variable.
+           */
+          inline Property operator | (const Property p1,
+                                      const Property p2)
+          {
+            return Property(static_cast<int>(p1) | static_cast<int>(p2));
+          }
+
+          inline Property &operator |= (Property &p1,
+                                        const Property p2)
+          {
+            p1 = p1 | p2;
+            return p1;
+          }
+        }
+
+        /**
+         * A structure that holds the values of several properties of a
+         * material lookup table at a number of temperature-pressure points,
+         * as filled by MaterialLookup::evaluate(). Each member vector has
+         * one entry per point, except for phase_volume_fractions, which has
+         * one vector per phase. Vectors of properties that were not requested
+         * are left empty.
+         */
+        struct LookupValues
+        {
+          std::vector<double> densities;
+          std::vector<double> thermal_expansivities;
+          std::vector<double> specific_heats;
+          std::vector<double> seismic_Vp;
+          std::vector<double> seismic_Vs;
+          std::vector<double> enthalpies;
+          std::vector<double> dRhodp;
+          std::vector<std::vector<double> > phase_volume_fractions;
+        };
+
         /**
          * A base class that can be used to look up material data from an external
          * data source (e.g. a table in a file). The class consists of data members
@@ -118,6 +181,21 @@ namespace aspect
             dRhodp (const double temperature,
                     const double pressure) const;
 
+            /**
+             * Look up all @p requested_properties at the points given by
+             * @p temperatures and @p pressures, and store them in @p values.
+             * This gives the same results as calling the functions for
+             * the individual properties above for every point, but finds the
+             * position of each point in the table only once, and evaluates
+             * each property for all points in one loop. This is considerably
+             * cheaper if several properties are needed at many points.
+             */
+            void
+            evaluate (const std::vector<double> &temperatures,
+                      const std::vector<double> &pressures,
+                      const LookupProperties::Property requested_properties,
+                      LookupValues &values) const;
+
             /**
              * Returns a vector of all the column names in the lookup file
              * that start with the character string vol_fraction_
@@ -54,6 +54,8 @@ namespace aspect
 
         std::vector<double> get_nth_output(const unsigned int idx) const override;
 
+        std::unique_ptr<AdditionalMaterialOutputs<dim> > clone () const override;
+
         /**
          * Cohesions at the evaluation points passed to
          * the instance of MaterialModel::Interface::evaluate() that fills
@@ -226,6 +228,16 @@ namespace aspect
         void evaluate(const MaterialModel::MaterialModelInputs<dim> &in,
                       MaterialModel::MaterialModelOutputs<dim> &out) const override;
 
+        /**
+         * Evaluate all points of all @p inputs in a single call to
+         * evaluate(), see MaterialModel::Interface::evaluate_batch().
+         * Reaction terms for elastic stresses and finite strain need the
+         * cell the points are located in, so inputs that request reaction
+         * terms are evaluated one at a time.
+         */
+        void evaluate_batch (const std::vector<const MaterialModel::MaterialModelInputs<dim> *> &inputs,
+                             const std::vector<MaterialModel::MaterialModelOutputs<dim> *> &outputs) const override;
+
         /**
          * Return whether the model is compressible or not.  Incompressibility
          * does not necessarily imply that the density is constant; rather, it
@@ -332,6 +344,22 @@ namespace aspect
                                           const YieldScheme &yield_type,
                                           const std::vector<double> &phase_function_values = std::vector<double>()) const;
 
+        /**
+         * Same as above, but use the given @p strain_rate and @p pressure
+         * instead of the values stored in @p in for the point with index
+         * @p i. This is used to compute the viscosity for perturbed inputs
+         * without copying the complete MaterialModelInputs object.
+         */
+        std::pair<std::vector<double>, std::vector<bool> >
+        calculate_isostrain_viscosities ( const MaterialModel::MaterialModelInputs<dim> &in,
+                                          const unsigned int i,
+                                          const SymmetricTensor<2,dim> &strain_rate,
+                                          const double pressure,
+                                          const std::vector<double> &volume_fractions,
+                                          const ViscosityScheme &viscous_type,
+                                          const YieldScheme &yield_type,
+                                          const std::vector<double> &phase_function_values) const;
+
 
         /**
          * A function that fills the plastic additional output in the
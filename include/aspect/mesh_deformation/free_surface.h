@@ -108,6 +108,13 @@ namespace aspect
          */
         void parse_parameters (ParameterHandler &prm) override;
 
+        /**
+         * Return the stabilization parameter for the free surface. This is
+         * used by solvers that do not go through the assembler of this
+         * plugin, such as the matrix-free Stokes solver.
+         */
+        double get_free_surface_theta () const;
+
       private:
         /**
          * Project the Stokes velocity solution onto the
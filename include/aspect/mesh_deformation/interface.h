@@ -28,7 +28,10 @@
 #include <aspect/global.h>
 
 #include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/mapping.h>
 #include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/multigrid/mg_level_object.h>
 
 #if DEAL_II_VERSION_GTE(9,1,0)
 #  include <deal.II/lac/affine_constraints.h>
@@ -44,6 +47,7 @@ namespace aspect
   using namespace dealii;
 
   template <int dim> class Simulator;
+  template <int dim, int degree> class AdvectionMatrixFreeHandlerImplementation;
 
   /**
    * A namespace that contains everything that is related to the deformation
@@ -185,6 +189,16 @@ namespace aspect
          */
         void setup_dofs();
 
+        /**
+         * Transfer the current mesh displacements to all levels of the
+         * multigrid hierarchy and recreate the mapping returned by
+         * get_level_mapping(). This function needs to be called whenever
+         * the mesh displacements have changed and the matrix-free GMG
+         * Stokes solver is used, since the level operators of that solver
+         * need to see the same deformed geometry as the active mesh.
+         */
+        void update_multilevel_deformation ();
+
         /**
          * Declare parameters for the mesh deformation handling.
          */
@@ -274,6 +288,15 @@ namespace aspect
         const LinearAlgebra::Vector &
         get_mesh_displacements () const;
 
+        /**
+         * Return the mapping that describes the deformed mesh on the levels
+         * of the multigrid hierarchy. This mapping is only available if the
+         * matrix-free GMG Stokes solver is used, and it is updated by
+         * update_multilevel_deformation().
+         */
+        const Mapping<dim> &
+        get_level_mapping () const;
+
         /**
          * Go through the list of all mesh deformation objects that have been selected
          * in the input file (and are consequently currently active) and return
@@ -411,6 +434,20 @@ namespace aspect
          */
         LinearAlgebra::Vector mesh_displacements;
 
+        /**
+         * The mesh displacements interpolated to each level of the
+         * multigrid hierarchy. These are only used by the matrix-free
+         * GMG Stokes solver, which requires a deal.II vector type for
+         * the multigrid transfer.
+         */
+        MGLevelObject<dealii::LinearAlgebra::distributed::Vector<double> > level_displacements;
+
+        /**
+         * The mapping that describes the deformed mesh on the multigrid
+         * levels, based on level_displacements.
+         */
+        std::unique_ptr<Mapping<dim> > level_mapping;
+
         /**
          * Vector for storing the positions of the mesh vertices at the initial timestep.
          * This must be redistributed upon mesh refinement.
@@ -497,6 +534,8 @@ namespace aspect
 
         friend class Simulator<dim>;
         friend class SimulatorAccess<dim>;
+        template <int dimension, int degree>
+        friend class aspect::AdvectionMatrixFreeHandlerImplementation;
     };
 
 
@@ -326,6 +326,70 @@ namespace aspect
       }
     };
 
+    /**
+     * This enum represents the different choices for the linear solver
+     * for the temperature and composition systems. See
+     * @p advection_solver_type.
+     */
+    struct AdvectionSolverType
+    {
+      enum Kind
+      {
+        matrix_based,
+        matrix_free
+      };
+
+      static const std::string pattern()
+      {
+        return "matrix-based|matrix-free";
+      }
+
+      static Kind
+      parse(const std::string &input)
+      {
+        if (input == "matrix-based")
+          return matrix_based;
+        else if (input == "matrix-free")
+          return matrix_free;
+        else
+          AssertThrow(false, ExcNotImplemented());
+
+        return Kind();
+      }
+    };
+
+    /**
+     * This enum represents the different choices for the time stepping
+     * scheme used to compute reactions in the operator splitting scheme.
+     * See @p reaction_solver_type.
+     */
+    struct ReactionSolverType
+    {
+      enum Kind
+      {
+        fixed_step,
+        adaptive
+      };
+
+      static const std::string pattern()
+      {
+        return "fixed step|adaptive";
+      }
+
+      static Kind
+      parse(const std::string &input)
+      {
+        if (input == "fixed step")
+          return fixed_step;
+        else if (input == "adaptive")
+          return adaptive;
+        else
+          AssertThrow(false, ExcNotImplemented());
+
+        return Kind();
+      }
+    };
+
     /**
      * This enum represents the different choices for the Krylov method
      * used in the cheap GMG Stokes solve.
@@ -458,6 +522,8 @@ namespace aspect
 
     // subsection: Advection solver parameters
     unsigned int                   advection_gmres_restart_length;
+    typename AdvectionSolverType::Kind advection_solver_type;
+    bool                           group_compatible_compositional_fields;
 
     // subsection: Stokes solver parameters
     bool                           use_direct_stokes_solver;
@@ -478,10 +544,15 @@ namespace aspect
     unsigned int                   AMG_smoother_sweeps;
     double                         AMG_aggregation_threshold;
     bool                           AMG_output_details;
+    bool                           AMG_use_unsmoothed_aggregation;
 
     // subsection: Operator splitting parameters
     double                         reaction_time_step;
     unsigned int                   reaction_steps_per_advection_step;
+    typename ReactionSolverType::Kind reaction_solver_type;
+    double                         reaction_solver_relative_tolerance;
+    double                         reaction_solver_absolute_tolerance;
+    unsigned int                   reaction_solver_cells_per_batch;
 
     // subsection: Diffusion solver parameters
     double                         diffusion_length_scale;
@@ -607,6 +678,7 @@ namespace aspect
      */
     int                            checkpoint_time_secs;
     int                            checkpoint_steps;
+    bool                           write_checkpoint_in_background_thread;
     /**
      * @}
      */
@@ -624,6 +696,7 @@ namespace aspect
     unsigned int                   composition_degree;
     std::string                    pressure_normalization;
     MaterialModel::MaterialAveraging::AveragingOperation material_averaging;
+    double                         material_model_output_cache_size;
 
     /**
      * @}
@@ -316,7 +316,8 @@ namespace aspect
           /**
            * Initialization function. This function is called once at the
            * creation of every particle for every property to initialize its
-           * value.
+           * value. Note that this function may be called concurrently from
+           * several threads for different particles.
            *
            * @param [in] position The current particle position.
            * @param [in,out] particle_properties The properties of the particle
@@ -528,6 +529,17 @@ namespace aspect
           void
           initialize_one_particle (typename ParticleHandler<dim>::particle_iterator &particle) const;
 
+          /**
+           * Compute the initial properties of a particle at @p position
+           * and store them in @p particle_properties, without storing them
+           * in the particle itself. This allows to compute the properties of
+           * many particles in parallel, because it does not touch the
+           * property pool of the particle handler.
+           */
+          void
+          initialize_one_particle (const Point<dim> &position,
+                                   std::vector<double> &particle_properties) const;
+
           /**
            * Initialization function for particle properties. This function is
            * called once for each of the particles of a particle
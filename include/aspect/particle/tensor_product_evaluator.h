@@ -0,0 +1,115 @@
+/*
+  Copyright (C) 2020 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _aspect_particle_tensor_product_evaluator_h
+#define _aspect_particle_tensor_product_evaluator_h
+
+#include <aspect/global.h>
+
+#include <deal.II/base/point.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/fe/fe.h>
+
+namespace aspect
+{
+  namespace Particle
+  {
+    using namespace dealii;
+
+    namespace internal
+    {
+      /**
+       * A class that evaluates finite element functions on one cell at
+       * many points in reference coordinates at once, for example at the
+       * locations of all particles in a cell. This is much cheaper than
+       * creating an FEValues object with a new quadrature formula for every
+       * cell, or calling FiniteElement::shape_value() for every shape
+       * function and point.
+       *
+       * The class only supports elements whose shape functions are tensor
+       * products of one-dimensional Lagrange polynomials, i.e., FE_Q and
+       * FE_DGQ. The one-dimensional polynomials are determined from the
+       * unit support points of the element. The evaluation uses sum
+       * factorization, and works on VectorizedArray::size() points at once.
+       */
+      template <int dim>
+      class TensorProductEvaluator
+      {
+        public:
+          /**
+           * Return whether the element @p fe is supported by this class.
+           */
+          static
+          bool
+          is_supported (const FiniteElement<dim> &fe);
+
+          /**
+           * Constructor. The element @p fe must be a scalar element for
+           * which is_supported() returns true.
+           */
+          TensorProductEvaluator (const FiniteElement<dim> &fe);
+
+          /**
+           * Evaluate @p n_components functions at the reference
+           * @p points. The coefficients of component $c$ are stored in
+           * @p dof_values at the positions
+           * $c \cdot n_{\text{dofs}} \ldots (c+1) \cdot n_{\text{dofs}}-1$,
+           * in the numbering of the element's shape functions.
+           *
+           * On output, @p values contains the value of component $c$ at point
+           * $p$ at position $p \cdot n_{\text{components}} + c$. If
+           * @p gradients is not a null pointer, it contains the gradients
+           * with respect to the reference coordinates in the same layout.
+           */
+          void
+          evaluate (const unsigned int n_components,
+                    const std::vector<double> &dof_values,
+                    const std::vector<Point<dim> > &points,
+                    std::vector<double> &values,
+                    std::vector<Tensor<1,dim> > *gradients = nullptr) const;
+
+          /**
+           * Return the number of degrees of freedom of the element.
+           */
+          unsigned int
+          n_dofs_per_cell () const;
+
+        private:
+          /**
+           * The one-dimensional support points.
+           */
+          std::vector<double> nodes;
+
+          /**
+           * The inverse of the denominator of each one-dimensional Lagrange
+           * polynomial, i.e., $1/\prod_{j\neq i} (x_i-x_j)$.
+           */
+          std::vector<double> weights;
+
+          /**
+           * The lexicographic index of each shape function of the element.
+           */
+          std::vector<unsigned int> lexicographic_index;
+      };
+    }
+  }
+}
+
+#endif
@@ -33,6 +33,7 @@
 #include <aspect/particle/integrator/interface.h>
 #include <aspect/particle/interpolator/interface.h>
 #include <aspect/particle/property/interface.h>
+#include <aspect/particle/tensor_product_evaluator.h>
 
 #include <aspect/simulator_access.h>
 #include <aspect/simulator_signals.h>
@@ -65,6 +66,63 @@ namespace aspect
       class Manager;
     }
 
+    namespace internal
+    {
+      /**
+       * Scratch object for the loops over all cells in World that are
+       * parallelized with the WorkStream interface.
+       */
+      template <int dim>
+      struct ParticleScratchData
+      {
+        std::vector<types::global_dof_index> cell_dof_indices;
+        std::vector<Point<dim> > reference_locations;
+        std::vector<double> dof_values;
+        std::vector<double> values;
+        std::vector<Tensor<1,dim> > gradients;
+      };
+
+      /**
+       * Copy object for the loops over all cells in World that are
+       * parallelized with the WorkStream interface. The workers compute
+       * the data for the particles in one cell (which is the expensive
+       * part of these loops), and the copier uses it to modify the
+       * particles. Since the copier is called for one cell after the
+       * other and in the order of the cells, the particles are modified
+       * in the same order as in a serial loop. This keeps the results
+       * deterministic, and plugins that modify particles do not need to
+       * be thread-safe. Only the members needed by the respective loop are
+       * filled.
+       */
+      template <int dim>
+      struct ParticleCopyData
+      {
+        /**
+         * The range of particles in the current cell. Empty if the cell
+         * contains no particles.
+         */
+        typename ParticleHandler<dim>::particle_iterator begin_particle;
+        typename ParticleHandler<dim>::particle_iterator end_particle;
+
+        /**
+         * The initial properties of each particle.
+         */
+        std::vector<std::vector<double> > properties;
+
+        /**
+         * The solution values and gradients at each particle location.
+         */
+        std::vector<Vector<double> > values;
+        std::vector<std::vector<Tensor<1,dim> > > gradients;
+
+        /**
+         * The current and old velocity at each particle location.
+         */
+        std::vector<Tensor<1,dim> > velocities;
+        std::vector<Tensor<1,dim> > old_velocities;
+      };
+    }
+
     /**
      * This class manages the storage and handling of particles. It provides
      * interfaces to generate and store particles, functions to initialize,
@@ -272,6 +330,15 @@ namespace aspect
          */
         std::unique_ptr<Property::Manager<dim> > property_manager;
 
+        /**
+         * Objects that evaluate the solution at all particle locations in
+         * a cell at once, one for each base element of the finite element.
+         * An entry is a null pointer if the base element is not supported by
+         * internal::TensorProductEvaluator, in which case the slower generic
+         * evaluation is used. Set up by setup_solution_evaluators().
+         */
+        std::vector<std::unique_ptr<internal::TensorProductEvaluator<dim> > > solution_evaluators;
+
         /**
          * Particle handler object that is responsible for storing and
          * managing the internal particle structures.
@@ -363,32 +430,59 @@ namespace aspect
         void advect_particles();
 
         /**
-         * Initialize the particle properties of one cell.
+         * Run @p worker on all locally owned cells in parallel using the
+         * WorkStream interface, and pass the result for each cell to
+         * @p copier. The copier is called sequentially in the order of the
+         * cells.
+         */
+        template <typename Worker, typename Copier>
+        void
+        run_cell_loop(const Worker &worker,
+                      const Copier &copier) const;
+
+        /**
+         * Create the objects in @p solution_evaluators, unless this has
+         * already been done.
+         */
+        void
+        setup_solution_evaluators();
+
+        /**
+         * Compute the initial particle properties of one cell and store them
+         * in @p data. The properties are stored in the particles by
+         * initialize_particles() afterwards. This function can be called
+         * concurrently for different cells.
          */
         void
         local_initialize_particles(const typename ParticleHandler<dim>::particle_iterator &begin_particle,
-                                   const typename ParticleHandler<dim>::particle_iterator &end_particle);
+                                   const typename ParticleHandler<dim>::particle_iterator &end_particle,
+                                   internal::ParticleCopyData<dim> &data) const;
 
         /**
-         * Update the particle properties of one cell.
+         * Evaluate the solution values and gradients needed to update the
+         * particle properties of one cell and store them in @p data. The
+         * properties are updated by update_particles() afterwards. This
+         * function can be called concurrently for different cells.
          */
         void
         local_update_particles(const typename DoFHandler<dim>::active_cell_iterator &cell,
                                const typename ParticleHandler<dim>::particle_iterator &begin_particle,
-                               const typename ParticleHandler<dim>::particle_iterator &end_particle);
+                               const typename ParticleHandler<dim>::particle_iterator &end_particle,
+                               internal::ParticleScratchData<dim> &scratch,
+                               internal::ParticleCopyData<dim> &data) const;
 
         /**
-         * Advect the particles of one cell. Performs only one step for
-         * multi-step integrators. Needs to be called until integrator->continue()
-         * evaluates to false. Particles that moved out of their old cell
-         * during this advection step are removed from the local multimap and
-         * stored in @p particles_out_of_cell for further treatment (sorting
-         * them into the new cell).
+         * Compute the current and old velocity at the locations of the
+         * particles of one cell and store them in @p data. The particles are
+         * moved by the integrator in advect_particles() afterwards. This
+         * function can be called concurrently for different cells.
          */
         void
         local_advect_particles(const typename DoFHandler<dim>::active_cell_iterator &cell,
                                const typename ParticleHandler<dim>::particle_iterator &begin_particle,
-                               const typename ParticleHandler<dim>::particle_iterator &end_particle);
+                               const typename ParticleHandler<dim>::particle_iterator &end_particle,
+                               internal::ParticleScratchData<dim> &scratch,
+                               internal::ParticleCopyData<dim> &data) const;
 
         /**
          * This function registers the necessary functions to the
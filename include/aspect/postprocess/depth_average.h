@@ -27,6 +27,10 @@
 
 #include <deal.II/base/data_out_base.h>
 
+#include <boost/serialization/version.hpp>
+
+#include <cstdint>
+
 
 namespace aspect
 {
@@ -127,10 +131,44 @@ namespace aspect
         };
 
         /**
-         * An array of all the past values
+         * An array of all the past values. If append_output is set, this
+         * array only contains the most recent value.
          */
         std::vector<DataPoint> entries;
 
+        /**
+         * Whether to append each new data point to the output file instead
+         * of rewriting the whole history every time. This is only supported
+         * for the 'txt' output format.
+         */
+        bool append_output;
+
+        /**
+         * If append_output is set: the number of bytes written to the
+         * 'txt' output file so far. This is stored in checkpoints, so that
+         * anything written to the file after the checkpoint was created can
+         * be discarded after resuming the computation.
+         */
+        std::uint64_t txt_output_size;
+
+        /**
+         * Whether we have already written to the 'txt' output file since
+         * the start of the program, in which case we can simply append to it.
+         */
+        bool txt_output_file_initialized;
+
+        /**
+         * Write the header of the 'txt' output format to @p out.
+         */
+        void write_txt_header (std::ostream &out) const;
+
+        /**
+         * Write the values of @p data_point in the 'txt' output format to
+         * @p out.
+         */
+        void write_txt_data_point (std::ostream &out,
+                                   const DataPoint &data_point) const;
+
         /**
          * Set the time output was supposed to be written. In the simplest
          * case, this is the previous last output time plus the interval, but
@@ -145,4 +183,25 @@ namespace aspect
 }
 
 
+namespace boost
+{
+  namespace serialization
+  {
+    /**
+     * The version of the serialized state of the DepthAverage class.
+     * Version 1 added the size of the 'txt' output file. Checkpoints
+     * with version 0 can still be loaded. This is what the
+     * BOOST_CLASS_VERSION macro does for classes that are not templates.
+     */
+    template <int dim>
+    struct version<aspect::Postprocess::DepthAverage<dim> >
+    {
+      typedef mpl::int_<1> type;
+      typedef mpl::integral_c_tag tag;
+      BOOST_STATIC_CONSTANT(int, value = version::type::value);
+    };
+  }
+}
+
+
 #endif
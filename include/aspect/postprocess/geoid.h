@@ -127,6 +127,7 @@ namespace aspect
          * The input spherical_function is a vector of vectors.
          * The inner vector stores theta, phi, spherical infinitesimal, and function value on a spherical surface.
          * The outer vector stores the inner vector associated with each quadrature point on a spherical surface.
+         * The returned coefficients only contain the contributions of the points of the current process.
          */
         std::pair<std::vector<double>,std::vector<double> >
         to_spherical_harmonic_coefficients(const std::vector<std::vector<double> > &spherical_function) const;
@@ -135,6 +136,7 @@ namespace aspect
          * Function to compute the density contribution in spherical harmonic expansion throughout the mantle
          * The input outer radius is needed to evaluate the density integral contribution of whole model domain at the surface
          * This function returns a pair containing real spherical harmonics of density integral (cos and sin part) from min degree to max degree.
+         * The returned coefficients only contain the contributions of the locally owned cells.
          */
         std::pair<std::vector<double>,std::vector<double> >
         density_contribution (const double &outer_radius) const;
@@ -145,6 +147,7 @@ namespace aspect
          * associated with each quadrature point on surface and bottom respectively.
          * This function returns a pair containing surface and CMB dynamic topography's real spherical harmonic coefficients (cos and sin part)
          * from min degree to max degree. The surface and CMB average density are also included as the first single element of each subpair respectively.
+         * The returned coefficients only contain the contributions of the locally owned cells.
          */
         std::pair<std::pair<double, std::pair<std::vector<double>,std::vector<double> > >, std::pair<double, std::pair<std::vector<double>,std::vector<double> > > >
         dynamic_topography_contribution(const double &outer_radius,
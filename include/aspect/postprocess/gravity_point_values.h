@@ -245,6 +245,25 @@ namespace aspect
           list_of_points
         } sampling_scheme;
 
+        /**
+         * Specify how gravity is computed from the quadrature points: either
+         * by summing over all of them, or by approximating groups of far
+         * away quadrature points with a tree.
+         */
+        enum EvaluationMethod
+        {
+          direct,
+          tree
+        } evaluation_method;
+
+        /**
+         * Parameter for the tree evaluation method: A group of quadrature
+         * points is approximated by its multipole expansion if its radius is
+         * smaller than the opening angle times its distance to the
+         * satellite.
+         */
+        double tree_opening_angle;
+
         /**
          * Parameter for the list of points sampling scheme:
          * List of radius coordinates for the list of points sampling scheme.
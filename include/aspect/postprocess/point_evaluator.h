@@ -0,0 +1,146 @@
+/*
+  Copyright (C) 2020 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _aspect_postprocess_point_evaluator_h
+#define _aspect_postprocess_point_evaluator_h
+
+#include <aspect/global.h>
+
+#include <deal.II/base/point.h>
+#include <deal.II/base/table.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/mapping.h>
+#include <deal.II/lac/vector.h>
+
+namespace aspect
+{
+  namespace Postprocess
+  {
+    using namespace dealii;
+
+    /**
+     * A class that evaluates a finite element function at a fixed set of
+     * points in a parallel computation. In contrast to calling
+     * VectorTools::point_value() for every point on every process, this
+     * class searches for the cells that contain the points only once after
+     * every change of the mesh, using the bounding box of the locally owned
+     * cells and a GridTools::Cache to find the cells quickly. Every point is
+     * assigned to exactly one process that owns a cell around it. At the
+     * same time, the values of the shape functions at the points are
+     * computed and stored, so that evaluating the function only requires a
+     * loop over the stored values on the owning process, followed by a
+     * single reduction over all processes.
+     *
+     * The user of this class needs to call clear() whenever the mesh
+     * changes, or the location of the points relative to the cells changes,
+     * for example because the mesh is deformed.
+     *
+     * The class requires the finite element of the DoFHandler to be
+     * primitive, which is the case for all elements used in ASPECT.
+     */
+    template <int dim>
+    class PointEvaluator
+    {
+      public:
+        /**
+         * Constructor.
+         */
+        PointEvaluator ();
+
+        /**
+         * Set the points at which the finite element function is evaluated.
+         * This also invalidates the information about the location of the
+         * points.
+         */
+        void set_points (const std::vector<Point<dim> > &points);
+
+        /**
+         * Return the points at which the finite element function is
+         * evaluated.
+         */
+        const std::vector<Point<dim> > &get_points () const;
+
+        /**
+         * Forget the cells the points are located in, and the values of the
+         * shape functions at the points. This function needs to be called
+         * whenever the mesh changes.
+         */
+        void clear ();
+
+        /**
+         * Evaluate all components of the finite element function described
+         * by @p dof_handler and @p solution at all points. If the points have
+         * not been located since the last call of clear(), first locate
+         * them. On return, @p values contains the values at all points on
+         * every process.
+         *
+         * This function needs to be called on all processes of
+         * @p mpi_communicator at the same time.
+         */
+        void evaluate (const Mapping<dim> &mapping,
+                       const DoFHandler<dim> &dof_handler,
+                       const LinearAlgebra::BlockVector &solution,
+                       const MPI_Comm &mpi_communicator,
+                       std::vector<Vector<double> > &values);
+
+      private:
+        /**
+         * Find the cells around all points, decide which process evaluates
+         * each point, and compute the values of the shape functions at the
+         * points this process evaluates.
+         */
+        void locate_points (const Mapping<dim> &mapping,
+                            const DoFHandler<dim> &dof_handler,
+                            const MPI_Comm &mpi_communicator);
+
+        /**
+         * The points at which the function is evaluated.
+         */
+        std::vector<Point<dim> > points;
+
+        /**
+         * Whether the points have been located since the last call to
+         * clear().
+         */
+        bool points_located;
+
+        /**
+         * A locally owned cell that contains some of the points, together
+         * with the indices of these points and the values of the shape
+         * functions at these points. The entry (q,i) of shape_values is the
+         * value of the only nonzero component of shape function i at the
+         * point point_indices[q].
+         */
+        struct LocatedCell
+        {
+          typename DoFHandler<dim>::active_cell_iterator cell;
+          std::vector<unsigned int> point_indices;
+          Table<2,double> shape_values;
+        };
+
+        /**
+         * The locally owned cells around the points this process evaluates.
+         */
+        std::vector<LocatedCell> located_cells;
+    };
+  }
+}
+
+#endif
@@ -23,6 +23,7 @@
 #define _aspect_postprocess_point_values_h
 
 #include <aspect/postprocess/interface.h>
+#include <aspect/postprocess/point_evaluator.h>
 #include <aspect/simulator_access.h>
 
 #include <deal.II/base/data_out_base.h>
@@ -48,6 +49,14 @@ namespace aspect
          */
         PointValues ();
 
+        /**
+         * Connect to the signals of the triangulation, so that the cells
+         * around the evaluation points are located again after the mesh
+         * changed.
+         */
+        void
+        initialize () override;
+
         /**
          * Evaluate the solution and determine the values at the
          * selected points.
@@ -120,6 +129,11 @@ namespace aspect
          * as natural coordinates or not.
          */
         bool use_natural_coordinates;
+
+        /**
+         * The object that evaluates the solution at the evaluation points.
+         */
+        PointEvaluator<dim> point_evaluator;
     };
   }
 }
@@ -468,6 +468,20 @@ namespace aspect
          */
         unsigned int group_files;
 
+        /**
+         * If true, grouped VTU files are not written with MPI I/O. Instead,
+         * the data of each group of processes is collected on one
+         * aggregator process, which writes the file using the same code
+         * path as for ungrouped output (including background writing and
+         * temporary output locations).
+         */
+        bool aggregate_grouped_files;
+
+        /**
+         * The zlib compression level used for VTU output.
+         */
+        DataOutBase::VtkFlags::ZlibCompressionLevel vtu_compression_level;
+
         /**
          * On large clusters it can be advantageous to first write the
          * output to a temporary file on a local file system and later
@@ -526,6 +540,27 @@ namespace aspect
          */
         bool output_mesh_velocity;
 
+        /**
+         * The number of significant bits of the mantissa that are kept
+         * in the output data. Values smaller than 23 (the number of bits of
+         * a single precision floating point number) reduce the precision of
+         * the data, which is then compressed much better.
+         */
+        unsigned int output_precision_bits;
+
+        /**
+         * Whether to only write the cells that intersect the box spanned by
+         * output_region_min and output_region_max.
+         */
+        bool restrict_output_region;
+
+        /**
+         * The corners of the box the output is restricted to, if
+         * restrict_output_region is true.
+         */
+        Point<dim> output_region_min;
+        Point<dim> output_region_max;
+
         /**
          * File operations can potentially take a long time, blocking the
          * progress of the rest of the model run. Setting this variable to
@@ -47,6 +47,7 @@ DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 #include <aspect/lateral_averaging.h>
 #include <aspect/simulator_signals.h>
 #include <aspect/material_model/interface.h>
+#include <aspect/material_model/output_cache.h>
 #include <aspect/heating_model/interface.h>
 #include <aspect/geometry_model/initial_topography_model/interface.h>
 #include <aspect/geometry_model/interface.h>
@@ -86,6 +87,12 @@ namespace aspect
   template <int dim, int velocity_degree>
   class StokesMatrixFreeHandlerImplementation;
 
+  template <int dim>
+  class AdvectionMatrixFreeHandler;
+
+  template <int dim, int degree>
+  class AdvectionMatrixFreeHandlerImplementation;
+
   namespace MeshDeformation
   {
     template <int dim>
@@ -782,6 +789,20 @@ namespace aspect
        */
       void assemble_advection_system (const AdvectionField &advection_field);
 
+      /**
+       * Same as above, but use the given artificial viscosity on each cell
+       * instead of computing it. If @p assemble_matrix is false, only the
+       * right hand side is assembled and the matrix block of the given field
+       * is left untouched. This is used for compositional fields that share
+       * the matrix of another field, see assemble_and_solve_composition().
+       *
+       * This function is implemented in
+       * <code>source/simulator/assembly.cc</code>.
+       */
+      void assemble_advection_system (const AdvectionField &advection_field,
+                                      const Vector<double> &viscosity_per_cell,
+                                      const bool assemble_matrix);
+
       /**
        * Solve one block of the temperature/composition linear system.
        * Return the initial nonlinear residual, i.e., if the linear system to
@@ -794,6 +815,21 @@ namespace aspect
        */
       double solve_advection (const AdvectionField &advection_field);
 
+      /**
+       * Same as above, but solve with the matrix block that belongs to
+       * @p matrix_field instead of the one of @p advection_field. If
+       * @p preconditioner is empty, a preconditioner is built for this
+       * matrix and stored in it, otherwise the given one is reused. This
+       * allows to solve several compositional fields that share the same
+       * matrix with a single matrix and preconditioner.
+       *
+       * This function is implemented in
+       * <code>source/simulator/solver.cc</code>.
+       */
+      double solve_advection (const AdvectionField &advection_field,
+                              const AdvectionField &matrix_field,
+                              std::unique_ptr<LinearAlgebra::PreconditionILU> &preconditioner);
+
       /**
        * Interpolate a particular particle property to the solution field.
        */
@@ -1828,6 +1864,14 @@ namespace aspect
        * or if we want to terminate altogether.
        */
       Threads::Thread<>                   output_statistics_thread;
+
+      /**
+       * In create_snapshot(), the general simulator state may be written
+       * to disk and moved into place on a separate thread. This variable is
+       * the handle for this thread so that we can wait for it to finish
+       * before we write the next snapshot, or before we terminate.
+       */
+      Threads::Thread<>                   checkpoint_thread;
       /**
        * @}
        */
@@ -1840,6 +1884,14 @@ namespace aspect
       const std::unique_ptr<GeometryModel::Interface<dim> >                   geometry_model;
       const IntermediaryConstructorAction                                     post_geometry_model_creation_action;
       const std::unique_ptr<MaterialModel::Interface<dim> >                   material_model;
+
+      /**
+       * A cache for the outputs of the material model that postprocessors
+       * and mesh refinement criteria share, see
+       * SimulatorAccess::evaluate_material_model(). It is cleared whenever
+       * the solution or the mesh changes.
+       */
+      mutable MaterialModel::MaterialModelOutputCache<dim>                    material_model_output_cache;
       const std::unique_ptr<GravityModel::Interface<dim> >                    gravity_model;
       BoundaryTemperature::Manager<dim>                                       boundary_temperature_manager;
       BoundaryComposition::Manager<dim>                                       boundary_composition_manager;
@@ -2032,6 +2084,11 @@ namespace aspect
        */
       std::unique_ptr<StokesMatrixFreeHandler<dim> > stokes_matrix_free;
 
+      /**
+       * Unique pointer for the matrix-free advection solver
+       */
+      std::unique_ptr<AdvectionMatrixFreeHandler<dim> > advection_matrix_free;
+
       friend class boost::serialization::access;
       friend class SimulatorAccess<dim>;
       friend class MeshDeformation::MeshDeformationHandler<dim>;   // MeshDeformationHandler needs access to the internals of the Simulator
@@ -2039,6 +2096,8 @@ namespace aspect
       friend class StokesMatrixFreeHandler<dim>;
       template <int dimension, int velocity_degree>
       friend class StokesMatrixFreeHandlerImplementation;
+      template <int dimension, int degree>
+      friend class AdvectionMatrixFreeHandlerImplementation;
       friend struct Parameters<dim>;
   };
 }
@@ -319,6 +319,22 @@ namespace aspect
            * current cell to stabilize the solution of the advection system.
            */
           double artificial_viscosity;
+
+          /**
+           * Whether the system matrix is assembled, or only the right-hand
+           * side. The latter is the case if the matrix is shared with another
+           * compositional field that has already been assembled.
+           */
+          bool assemble_matrix;
+
+          /**
+           * Whether assemblers need to compute the local matrix on the
+           * current cell. This is true if @p assemble_matrix is true, and
+           * otherwise only if one of the degrees of freedom of the current
+           * cell is inhomogeneously constrained, because then the local
+           * matrix is needed to compute the right-hand side.
+           */
+          bool assemble_local_matrix;
         };
       }
 
@@ -530,6 +530,20 @@ namespace aspect
       const MaterialModel::Interface<dim> &
       get_material_model () const;
 
+      /**
+       * Evaluate the material model for the inputs @p in, like
+       * get_material_model().evaluate(in, out) does. If the material
+       * model output cache is enabled through the parameter 'Material
+       * model/Material model output cache size', the outputs of previous
+       * evaluations with identical inputs on the same cell and for the
+       * current solution are reused instead. Postprocessors and mesh
+       * refinement criteria that evaluate the material model for the current
+       * solution should use this function.
+       */
+      void
+      evaluate_material_model (const MaterialModel::MaterialModelInputs<dim> &in,
+                               MaterialModel::MaterialModelOutputs<dim> &out) const;
+
       /**
        * This function simply calls Simulator<dim>::compute_material_model_input_values()
        * with the given arguments.
@@ -84,6 +84,17 @@ namespace aspect
                              const double pressure_scaling,
                              const bool is_compressible);
 
+        /**
+         * Enable the free surface stabilization term of Kaus et al. (2010) on the
+         * boundaries given by @p boundary_indicators. The table @p stabilization_table
+         * stores the vector density * time step * theta * gravity for every boundary
+         * face batch (counted from the first boundary face batch of the MatrixFree
+         * object) and every face quadrature point. The underlying MatrixFree object
+         * must have been set up with data on boundary faces.
+         */
+        void set_free_surface_stabilization (const Table<2, Tensor<1, dim, VectorizedArray<number>>> &stabilization_table,
+                                             const std::set<types::boundary_id> &boundary_indicators);
+
         /**
          * Computes the diagonal of the matrix. Since matrix-free operators have not access
          * to matrix elements, we must apply the matrix-free operator to the unit vectors to
@@ -108,11 +119,40 @@ namespace aspect
                           const dealii::LinearAlgebra::distributed::BlockVector<number> &src,
                           const std::pair<unsigned int, unsigned int> &cell_range) const;
 
+        /**
+         * Defines the application of the matrix on interior faces. This does nothing,
+         * but is required by MatrixFree::loop().
+         */
+        void local_apply_face (const dealii::MatrixFree<dim, number> &data,
+                               dealii::LinearAlgebra::distributed::BlockVector<number> &dst,
+                               const dealii::LinearAlgebra::distributed::BlockVector<number> &src,
+                               const std::pair<unsigned int, unsigned int> &face_range) const;
+
+        /**
+         * Defines the application of the free surface stabilization term on
+         * boundary faces.
+         */
+        void local_apply_boundary_face (const dealii::MatrixFree<dim, number> &data,
+                                        dealii::LinearAlgebra::distributed::BlockVector<number> &dst,
+                                        const dealii::LinearAlgebra::distributed::BlockVector<number> &src,
+                                        const std::pair<unsigned int, unsigned int> &face_range) const;
+
         /**
          * Table which stores viscosity values for each cell.
          */
         const Table<2, VectorizedArray<number>> *viscosity;
 
+        /**
+         * Table which stores the free surface stabilization term for each
+         * boundary face batch, or nullptr if no free surface is present.
+         */
+        const Table<2, Tensor<1, dim, VectorizedArray<number>>> *free_surface_stabilization;
+
+        /**
+         * Boundary indicators of the free surface boundaries.
+         */
+        std::set<types::boundary_id> free_surface_boundary_indicators;
+
         /**
          * Pressure scaling constant.
          */
@@ -301,6 +341,14 @@ namespace aspect
        */
       virtual void setup_dofs()=0;
 
+      /**
+       * Sets up the matrix-free operators on the active mesh and on all
+       * multigrid levels. This is called by setup_dofs(), and again
+       * whenever the geometry of the mesh has changed due to mesh
+       * deformation, since the operators store the mapping information.
+       */
+      virtual void setup_operators()=0;
+
       /**
        * Evaluate the MaterialModel to query for the viscosity on the active cells,
        * project this viscosity to the multigrid hierarchy, and cache the information
@@ -432,6 +480,12 @@ namespace aspect
        */
       void setup_dofs() override;
 
+      /**
+       * Sets up the matrix-free operators on the active mesh and on all
+       * multigrid levels. See StokesMatrixFreeHandler::setup_operators().
+       */
+      void setup_operators() override;
+
       /**
        * Evaluate the MaterialModel to query for the viscosity on the active cells,
        * project this viscosity to the multigrid hierarchy, and cache the information
@@ -527,6 +581,26 @@ namespace aspect
        */
       void parse_parameters (ParameterHandler &prm);
 
+      /**
+       * Return the mapping to be used on the multigrid levels. This is the
+       * mapping of the Simulator, unless the mesh is deformed, in which case
+       * a mapping that describes the deformation on each level is used.
+       */
+      const Mapping<dim> &get_level_mapping () const;
+
+      /**
+       * Compute the free surface stabilization term on all boundary faces
+       * of the active mesh and hand it to the Stokes operator.
+       *
+       * The term is only added to the active level Stokes operator, not to
+       * the A block operators on the multigrid levels. The GMG preconditioner
+       * is therefore built from an operator without the stabilization term,
+       * which is a small boundary contribution for typical time step sizes,
+       * but may increase the number of GMRES iterations for large time steps
+       * or large values of the stabilization parameter theta.
+       */
+      void compute_free_surface_stabilization ();
+
 
       Simulator<dim> &sim;
 
@@ -541,6 +615,8 @@ namespace aspect
       Table<2, VectorizedArray<double>> active_viscosity_table;
       MGLevelObject<Table<2, VectorizedArray<GMGNumberType>>> level_viscosity_tables;
 
+      Table<2, Tensor<1, dim, VectorizedArray<double>>> free_surface_stabilization_table;
+
       // This variable is needed only in the setup in both evaluate_material_model()
       // and build_preconditioner(). It will be deleted after the last use.
       MGLevelObject<dealii::LinearAlgebra::distributed::Vector<GMGNumberType> > level_viscosity_vector;
@@ -568,6 +644,29 @@ namespace aspect
 
       MGTransferMatrixFree<dim,GMGNumberType> mg_transfer_A_block;
       MGTransferMatrixFree<dim,GMGNumberType> mg_transfer_Schur_complement;
+
+      /**
+       * The transfer object used to interpolate the active level viscosity
+       * to the multigrid levels. It only depends on the mesh, so it is built
+       * in setup_dofs() instead of in every call to evaluate_material_model().
+       */
+      MGTransferMatrixFree<dim,GMGNumberType> mg_transfer_projection;
+
+      /**
+       * The active level viscosity vector, the limits of the evaluated
+       * viscosities, and the pressure scaling used in the last update of the
+       * multigrid level matrices. evaluate_material_model() skips the update
+       * of the levels if none of them changed.
+       */
+      dealii::LinearAlgebra::distributed::Vector<double> previous_active_viscosity_vector;
+      std::pair<double,double> previous_viscosity_limits;
+      double previous_pressure_scaling;
+
+      /**
+       * Whether the level viscosities changed since the diagonals of the
+       * level matrices were last computed in build_preconditioner().
+       */
+      bool level_viscosity_changed;
   };
 }
 
@@ -25,6 +25,7 @@
 #include <aspect/global.h>
 
 #include <array>
+#include <functional>
 #include <deal.II/base/point.h>
 #include <deal.II/base/conditional_ostream.h>
 #include <deal.II/base/table_indices.h>
@@ -369,6 +370,28 @@ namespace aspect
                                                       double theta,   // colatitude (radians)
                                                       double phi );   // longitude (radians)
 
+    /**
+     * Compute the real spherical harmonics of all degrees
+     * $0 \le l \le$ @p max_degree and all orders $0 \le m \le l$ at the point
+     * with colatitude @p theta and longitude @p phi (both in radians).
+     * On return, <code>cosine_components[l][m]</code> and
+     * <code>sine_components[l][m]</code> contain the first and the second
+     * entry of the pair that real_spherical_harmonic() returns for the same
+     * degree, order and point.
+     *
+     * Instead of evaluating every spherical harmonic separately, this
+     * function computes the normalized associated Legendre functions with
+     * the standard stable three-term recurrence in the degree. The cost
+     * of computing all $(L+1)(L+2)/2$ values is therefore of the same order
+     * as evaluating only a few of them with real_spherical_harmonic(), and
+     * the recurrence remains accurate for degrees well beyond 100.
+     */
+    void real_spherical_harmonics (const unsigned int max_degree,
+                                   const double theta,
+                                   const double phi,
+                                   std::vector<std::vector<double> > &cosine_components,
+                                   std::vector<std::vector<double> > &sine_components);
+
     /**
      * A struct to enable numerical output with a comma as thousands separator
      */
@@ -604,6 +627,29 @@ namespace aspect
          */
         explicit AsciiDataLookup(const double scale_factor);
 
+        /**
+         * Destructor. If the data is stored in shared memory, this function
+         * frees the shared memory. This is a collective operation of all
+         * processes on the same node, so the object needs to be destroyed on
+         * all processes of the communicator that was used to load the data
+         * at the same time; otherwise the program will deadlock. Errors in
+         * freeing the shared memory are only reported, not thrown.
+         */
+        ~AsciiDataLookup();
+
+        /**
+         * Copy constructor. Copying this object is prohibited, because
+         * the copy would share the shared memory window of the data (if any)
+         * and free it a second time in its destructor.
+         */
+        AsciiDataLookup (const AsciiDataLookup &) = delete;
+
+        /**
+         * Copy operator. Copying this object is prohibited for the same
+         * reason as the copy constructor.
+         */
+        AsciiDataLookup &operator= (const AsciiDataLookup &) = delete;
+
         /**
          * Replace the data stored in this class by the data given to this function.
          *
@@ -624,10 +670,18 @@ namespace aspect
          * Loads a data text file. Throws an exception if the file does not
          * exist, if the data file format is incorrect or if the file grid
          * changes over model runtime.
+         *
+         * If @p store_in_shared_memory is true, the file is only read by one
+         * process per node, and the data is stored in a shared memory window
+         * that all processes on this node access, instead of every process
+         * storing its own copy. This reduces the memory requirements for large
+         * data files considerably, but requires an MPI library that supports
+         * the MPI 3.0 standard.
          */
         void
         load_file(const std::string &filename,
-                  const MPI_Comm &communicator);
+                  const MPI_Comm &communicator,
+                  const bool store_in_shared_memory = false);
 
         /**
          * Returns the computed data (velocity, temperature, etc. - according
@@ -746,6 +800,21 @@ namespace aspect
          */
         bool coordinate_values_are_equidistant;
 
+        /**
+         * If the data was loaded into shared memory, a pointer to the data
+         * of all components, otherwise a null pointer. Component $c$ of the
+         * data point with index $i$, in the order of the data file, is
+         * stored at position $c \cdot n_{\text{points}} + i$.
+         */
+        const double *shared_data;
+
+        /**
+         * The MPI window that owns the shared memory, and the communicator
+         * of all processes on the same node that share it.
+         */
+        MPI_Win shared_data_window;
+        MPI_Comm shared_data_communicator;
+
         /**
          * Computes the table indices given the size @p sizes of the
          * i-th entry.
@@ -753,6 +822,63 @@ namespace aspect
         TableIndices<dim>
         compute_table_indices(const TableIndices<dim> &sizes, const unsigned int i) const;
 
+        /**
+         * Store the coordinate values, compute the grid extent and
+         * determine whether the coordinates are equidistant.
+         */
+        void
+        setup_coordinates(const std::vector<std::vector<double>> &coordinate_values);
+
+        /**
+         * Read the header lines and the column names of a data file from
+         * @p in, and check them against the data that is already stored
+         * in this class. Returns the first data value of the file.
+         */
+        double
+        read_file_header(std::istream &in,
+                         const std::string &filename,
+                         TableIndices<dim> &new_table_points,
+                         std::vector<std::string> &column_names);
+
+        /**
+         * Read the data lines of a data file from @p in, whose first value
+         * @p first_value was already read by read_file_header(). The
+         * coordinates are stored in @p coordinate_values, and every scaled
+         * data value is handed to @p store_data_value together with its
+         * component and the index of its data point.
+         */
+        void
+        read_file_data(std::istream &in,
+                       const std::string &filename,
+                       const double first_value,
+                       const TableIndices<dim> &new_table_points,
+                       std::vector<std::vector<double>> &coordinate_values,
+                       const std::function<void (const unsigned int, const std::size_t, const double)> &store_data_value) const;
+
+        /**
+         * The implementation of load_file() for data stored in shared memory.
+         */
+        void
+        load_file_into_shared_memory(const std::string &filename,
+                                     const MPI_Comm &communicator);
+
+        /**
+         * Free the shared memory, if the data is stored there.
+         */
+        void
+        free_shared_data();
+
+        /**
+         * Interpolate component @p component of the data stored in shared
+         * memory multilinearly at @p position, in the same way as
+         * InterpolatedUniformGridData and InterpolatedTensorProductGridData
+         * do it. If @p gradient is not a null pointer, it is set to the
+         * gradient of the interpolant.
+         */
+        double
+        interpolate_shared_data(const Point<dim> &position,
+                                const unsigned int component,
+                                Tensor<1,dim> *gradient) const;
     };
 
     /**
@@ -804,6 +930,12 @@ namespace aspect
          * parameter).
          */
         double scale_factor;
+
+        /**
+         * Whether the data should be stored only once per node in shared
+         * memory. See AsciiDataLookup::load_file().
+         */
+        bool store_data_in_shared_memory;
     };
 
     /**
@@ -235,18 +235,10 @@ namespace aspect
 
       // Evaluate the spherical harmonics at this position. Since they are the
       // same for all depth splines, do it once to avoid multiple evaluations.
-      std::vector<std::vector<double> > cosine_components(max_degree+1, std::vector<double>(max_degree+1, 0.0));
-      std::vector<std::vector<double> > sine_components(max_degree+1, std::vector<double>(max_degree+1, 0.0));
-
-      for (unsigned int degree_l = 0; degree_l < max_degree+1; ++degree_l)
-        {
-          for (unsigned int order_m = 0; order_m < degree_l+1; ++order_m)
-            {
-              const std::pair<double,double> sph_harm_vals = Utilities::real_spherical_harmonic( degree_l, order_m, scoord[2], scoord[1] );
-              cosine_components[degree_l][order_m] = sph_harm_vals.first;
-              sine_components[degree_l][order_m] = sph_harm_vals.second;
-            }
-        }
+      std::vector<std::vector<double> > cosine_components;
+      std::vector<std::vector<double> > sine_components;
+      Utilities::real_spherical_harmonics(max_degree, scoord[2], scoord[1],
+                                          cosine_components, sine_components);
 
       // iterate over all degrees and orders at each depth and sum them all up.
       std::vector<double> spline_values(num_spline_knots, 0.);
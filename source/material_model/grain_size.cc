@@ -81,6 +81,15 @@ namespace aspect
 
 
 
+    template <int dim>
+    std::unique_ptr<AdditionalMaterialOutputs<dim> >
+    DislocationViscosityOutputs<dim>::clone () const
+    {
+      return std_cxx14::make_unique<DislocationViscosityOutputs<dim>> (*this);
+    }
+
+
+
     template <int dim>
     void
     GrainSize<dim>::initialize()
@@ -210,97 +219,126 @@ namespace aspect
           || original_grain_size < std::numeric_limits<double>::min())
         return 0.0;
 
-      // set up the parameters for the sub-timestepping of grain size evolution
-      std::vector<double> current_composition = compositional_fields;
+      // All quantities that do not depend on the grain size stay the same during the
+      // sub-timestepping, so we compute them only once
+      const GrainSizeEvolutionCoefficients coefficients
+        = compute_grain_size_evolution_coefficients(temperature, pressure, compositional_fields,
+                                                    strain_rate, position);
+
       double grain_size = original_grain_size;
-      double grain_size_change = 0.0;
       const double timestep = this->get_timestep();
 
-      // use a sub timestep of 500 yrs, currently fixed timestep
-      double grain_growth_timestep = 500 * 3600 * 24 * 365.25;
-      double time = 0;
-
-      // find out in which phase we are
-      const unsigned int phase_index = get_phase_index(position, temperature, pressure);
-
       // we keep the dislocation viscosity of the last iteration as guess
       // for the next one
       double current_dislocation_viscosity = 0.0;
 
-      do
+      if (use_adaptive_grain_size_evolution)
         {
-          time += grain_growth_timestep;
+          // Integrate the grain size evolution with Heun's method, and use the
+          // difference to the forward Euler step to control the size of the
+          // sub-timesteps.
+          const auto grain_size_change_rate = [&](const double current_grain_size)
+          {
+            const std::pair<double,double> rates
+              = grain_size_growth_and_reduction_rates(coefficients, current_grain_size,
+                                                      current_dislocation_viscosity);
+            return rates.first - rates.second;
+          };
 
-          if (timestep - time < 0)
-            {
-              grain_growth_timestep = timestep - (time - grain_growth_timestep);
-              time = timestep;
-            }
+          double time = 0;
+          double rate = grain_size_change_rate(grain_size);
 
-          // grain size growth due to Ostwald ripening
-          const double m = grain_growth_exponent[phase_index];
-          const double grain_size_growth_rate = grain_growth_rate_constant[phase_index] / (m * pow(grain_size,m-1))
-                                                * exp(- (grain_growth_activation_energy[phase_index] + pressure * grain_growth_activation_volume[phase_index])
-                                                      / (constants::gas_constant * temperature));
-          const double grain_size_growth = grain_size_growth_rate * grain_growth_timestep;
+          // start with a sub-timestep that changes the grain size by at most 10 percent
+          double grain_growth_timestep = (rate != 0.0
+                                          ?
+                                          std::min(timestep, 0.1 * grain_size / std::abs(rate))
+                                          :
+                                          timestep);
 
-          // grain size reduction in dislocation creep regime
-          const SymmetricTensor<2,dim> shear_strain_rate = strain_rate - 1./dim * trace(strain_rate) * unit_symmetric_tensor<dim>();
-          const double second_strain_rate_invariant = std::sqrt(std::abs(second_invariant(shear_strain_rate)));
+          while (time < timestep * (1. - 1e-12))
+            {
+              const double euler_grain_size = grain_size + grain_growth_timestep * rate;
 
-          const double current_diffusion_viscosity   = diffusion_viscosity(temperature, pressure, current_composition, strain_rate, position);
-          current_dislocation_viscosity              = dislocation_viscosity(temperature, pressure, current_composition, strain_rate, position, current_dislocation_viscosity);
+              double error = std::numeric_limits<double>::infinity();
+              double new_grain_size = 0.0;
+              if (euler_grain_size > 0.0)
+                {
+                  new_grain_size = grain_size + 0.5 * grain_growth_timestep
+                                   * (rate + grain_size_change_rate(euler_grain_size));
 
-          double current_viscosity;
-          if (std::abs(second_strain_rate_invariant) > 1e-30)
-            current_viscosity = current_dislocation_viscosity * current_diffusion_viscosity / (current_dislocation_viscosity + current_diffusion_viscosity);
-          else
-            current_viscosity = current_diffusion_viscosity;
+                  if (new_grain_size > 0.0)
+                    error = std::abs(new_grain_size - euler_grain_size)
+                            / (grain_size_evolution_relative_tolerance * std::max(grain_size, new_grain_size));
+                }
 
-          const double dislocation_strain_rate = second_strain_rate_invariant
-                                                 * current_viscosity / current_dislocation_viscosity;
+              if (error <= 1.0)
+                {
+                  time += grain_growth_timestep;
+                  grain_size = new_grain_size;
+                  rate = grain_size_change_rate(grain_size);
+                }
 
-          double grain_size_reduction = 0.0;
+              // The error estimate is of first order, so the optimal step size
+              // scales with the inverse square root of the error.
+              const double factor = std::min(5.0, std::max(0.2, 0.9 / std::sqrt(std::max(error, 1e-300))));
+              grain_growth_timestep = std::min(factor * grain_growth_timestep, timestep - time);
 
-          if (use_paleowattmeter)
-            {
-              // paleowattmeter: Austin and Evans (2007): Paleowattmeters: A scaling relation for dynamically recrystallized grain size. Geology 35, 343-346
-              const double stress = 2.0 * second_strain_rate_invariant * current_viscosity;
-              const double grain_size_reduction_rate = 2.0 * stress * boundary_area_change_work_fraction[phase_index] * dislocation_strain_rate * pow(grain_size,2)
-                                                       / (geometric_constant[phase_index] * grain_boundary_energy[phase_index]);
-              grain_size_reduction = grain_size_reduction_rate * grain_growth_timestep;
-            }
-          else
-            {
-              // paleopiezometer: Hall and Parmentier (2003): Influence of grain size evolution on convective instability. Geochem. Geophys. Geosyst., 4(3).
-              grain_size_reduction = reciprocal_required_strain[phase_index] * dislocation_strain_rate * grain_size * grain_growth_timestep;
+              AssertThrow(time >= timestep * (1. - 1e-12) || grain_growth_timestep > 1e-12 * timestep,
+                          ExcMessage("The grain size evolution could not be integrated with the "
+                                     "prescribed tolerance. Consider increasing the grain size "
+                                     "evolution relative tolerance."));
             }
+        }
+      else
+        {
+          double grain_size_change = 0.0;
 
-          grain_size_change = grain_size_growth - grain_size_reduction;
+          // use a sub timestep of 500 yrs, currently fixed timestep
+          double grain_growth_timestep = 500 * 3600 * 24 * 365.25;
+          double time = 0;
 
-          // If the change in grain size is very large or small decrease timestep and try
-          // again, or increase timestep and move on.
-          if ((grain_size_change / grain_size < 0.001 && grain_size_growth / grain_size < 0.1
-               && grain_size_reduction / grain_size < 0.1) || grain_size == 0.0)
-            grain_growth_timestep *= 2;
-          else if (grain_size_change / grain_size > 0.1 || grain_size_growth / grain_size > 0.5
-                   || grain_size_reduction / grain_size > 0.5)
+          do
             {
-              grain_size_change = 0.0;
-              time -= grain_growth_timestep;
+              time += grain_growth_timestep;
 
-              grain_growth_timestep /= 2.0;
-            }
+              if (timestep - time < 0)
+                {
+                  grain_growth_timestep = timestep - (time - grain_growth_timestep);
+                  time = timestep;
+                }
+
+              const std::pair<double,double> rates
+                = grain_size_growth_and_reduction_rates(coefficients, grain_size,
+                                                        current_dislocation_viscosity);
+
+              const double grain_size_growth = rates.first * grain_growth_timestep;
+              const double grain_size_reduction = rates.second * grain_growth_timestep;
 
-          grain_size += grain_size_change;
-          current_composition[field_index] = grain_size;
+              grain_size_change = grain_size_growth - grain_size_reduction;
 
-          Assert(grain_size > 0,
-                 ExcMessage("The grain size became smaller than zero. This is not valid, "
-                            "and likely an effect of a too large sub-timestep, or unrealistic "
-                            "input parameters."));
+              // If the change in grain size is very large or small decrease timestep and try
+              // again, or increase timestep and move on.
+              if ((grain_size_change / grain_size < 0.001 && grain_size_growth / grain_size < 0.1
+                   && grain_size_reduction / grain_size < 0.1) || grain_size == 0.0)
+                grain_growth_timestep *= 2;
+              else if (grain_size_change / grain_size > 0.1 || grain_size_growth / grain_size > 0.5
+                       || grain_size_reduction / grain_size > 0.5)
+                {
+                  grain_size_change = 0.0;
+                  time -= grain_growth_timestep;
+
+                  grain_growth_timestep /= 2.0;
+                }
+
+              grain_size += grain_size_change;
+
+              Assert(grain_size > 0,
+                     ExcMessage("The grain size became smaller than zero. This is not valid, "
+                                "and likely an effect of a too large sub-timestep, or unrealistic "
+                                "input parameters."));
+            }
+          while (time < timestep);
         }
-      while (time < timestep);
 
       // reduce grain size to recrystallized_grain_size when crossing phase transitions
       // if the distance in radial direction a grain moved compared to the last time step
@@ -326,6 +364,125 @@ namespace aspect
 
 
 
+    template <int dim>
+    typename GrainSize<dim>::GrainSizeEvolutionCoefficients
+    GrainSize<dim>::
+    compute_grain_size_evolution_coefficients (const double                  temperature,
+                                               const double                  pressure,
+                                               const std::vector<double>    &compositional_fields,
+                                               const SymmetricTensor<2,dim> &strain_rate,
+                                               const Point<dim>             &position) const
+    {
+      GrainSizeEvolutionCoefficients coefficients;
+
+      // grain size growth and reduction use the phase at the actual pressure
+      coefficients.phase_index = get_phase_index(position, temperature, pressure);
+      const unsigned int phase_index = coefficients.phase_index;
+
+      coefficients.grain_growth_prefactor = grain_growth_rate_constant[phase_index] / grain_growth_exponent[phase_index]
+                                            * exp(- (grain_growth_activation_energy[phase_index] + pressure * grain_growth_activation_volume[phase_index])
+                                                  / (constants::gas_constant * temperature));
+
+      const SymmetricTensor<2,dim> shear_strain_rate = strain_rate - 1./dim * trace(strain_rate) * unit_symmetric_tensor<dim>();
+      coefficients.second_strain_rate_invariant = std::sqrt(std::abs(second_invariant(shear_strain_rate)));
+
+      // The viscosities use the phase at the adiabatic pressure. The diffusion
+      // viscosity is proportional to a power of the grain size, and the dislocation
+      // viscosity for a fraction r of the strain rate is r^((1-n)/n) times the
+      // dislocation viscosity for the full strain rate.
+      const double adiabatic_pressure = this->get_adiabatic_conditions().is_initialized()
+                                        ?
+                                        this->get_adiabatic_conditions().pressure(position)
+                                        :
+                                        pressure;
+      const unsigned int viscosity_phase_index = get_phase_index(position, temperature, adiabatic_pressure);
+
+      const double grain_size = compositional_fields[this->introspection().compositional_index_for_name("grain_size")];
+      coefficients.diffusion_viscosity_grain_size_exponent = diffusion_creep_grain_size_exponent[viscosity_phase_index]
+                                                             / diffusion_creep_exponent[viscosity_phase_index];
+      coefficients.diffusion_viscosity_prefactor = diffusion_viscosity(temperature, pressure, compositional_fields, strain_rate, position)
+                                                   / pow(grain_size, coefficients.diffusion_viscosity_grain_size_exponent);
+
+      coefficients.dislocation_viscosity_full_strain_rate = dislocation_viscosity_fixed_strain_rate(temperature,
+                                                            pressure,
+                                                            std::vector<double>(),
+                                                            strain_rate,
+                                                            position);
+      coefficients.dislocation_viscosity_strain_rate_exponent = (1.0 - dislocation_creep_exponent[viscosity_phase_index])
+                                                                / dislocation_creep_exponent[viscosity_phase_index];
+
+      return coefficients;
+    }
+
+
+
+    template <int dim>
+    std::pair<double,double>
+    GrainSize<dim>::
+    grain_size_growth_and_reduction_rates (const GrainSizeEvolutionCoefficients &coefficients,
+                                           const double                          grain_size,
+                                           double                               &dislocation_viscosity) const
+    {
+      const unsigned int phase_index = coefficients.phase_index;
+
+      // grain size growth due to Ostwald ripening
+      const double m = grain_growth_exponent[phase_index];
+      const double grain_size_growth_rate = coefficients.grain_growth_prefactor / pow(grain_size,m-1);
+
+      // grain size reduction in dislocation creep regime
+      const double second_strain_rate_invariant = coefficients.second_strain_rate_invariant;
+
+      const double current_diffusion_viscosity = coefficients.diffusion_viscosity_prefactor
+                                                 * pow(grain_size, coefficients.diffusion_viscosity_grain_size_exponent);
+
+      // Iterate for the dislocation viscosity in the same way as dislocation_viscosity()
+      // does, starting from the given guess if there is one
+      if (dislocation_viscosity == 0)
+        dislocation_viscosity = coefficients.dislocation_viscosity_full_strain_rate;
+
+      double dislocation_viscosity_old = 0;
+      unsigned int i = 0;
+      while ((std::abs((dislocation_viscosity-dislocation_viscosity_old) / dislocation_viscosity) > dislocation_viscosity_iteration_threshold)
+             && (i < dislocation_viscosity_iteration_number))
+        {
+          dislocation_viscosity_old = dislocation_viscosity;
+          dislocation_viscosity = coefficients.dislocation_viscosity_full_strain_rate
+                                  * std::pow(current_diffusion_viscosity / (current_diffusion_viscosity + dislocation_viscosity),
+                                             coefficients.dislocation_viscosity_strain_rate_exponent);
+          ++i;
+        }
+
+      Assert(i<dislocation_viscosity_iteration_number,ExcInternalError());
+
+      double current_viscosity;
+      if (std::abs(second_strain_rate_invariant) > 1e-30)
+        current_viscosity = dislocation_viscosity * current_diffusion_viscosity / (dislocation_viscosity + current_diffusion_viscosity);
+      else
+        current_viscosity = current_diffusion_viscosity;
+
+      const double dislocation_strain_rate = second_strain_rate_invariant
+                                             * current_viscosity / dislocation_viscosity;
+
+      double grain_size_reduction_rate = 0.0;
+
+      if (use_paleowattmeter)
+        {
+          // paleowattmeter: Austin and Evans (2007): Paleowattmeters: A scaling relation for dynamically recrystallized grain size. Geology 35, 343-346
+          const double stress = 2.0 * second_strain_rate_invariant * current_viscosity;
+          grain_size_reduction_rate = 2.0 * stress * boundary_area_change_work_fraction[phase_index] * dislocation_strain_rate * pow(grain_size,2)
+                                      / (geometric_constant[phase_index] * grain_boundary_energy[phase_index]);
+        }
+      else
+        {
+          // paleopiezometer: Hall and Parmentier (2003): Influence of grain size evolution on convective instability. Geochem. Geophys. Geosyst., 4(3).
+          grain_size_reduction_rate = reciprocal_required_strain[phase_index] * dislocation_strain_rate * grain_size;
+        }
+
+      return std::make_pair(grain_size_growth_rate, grain_size_reduction_rate);
+    }
+
+
+
     template <int dim>
     double
     GrainSize<dim>::
@@ -1046,6 +1203,20 @@ namespace aspect
                              "paleowattmeter approach of Austin and Evans (2007) for grain size reduction "
                              "in the dislocation creep regime (if true) or the paleopiezometer approach "
                              "from Hall and Parmetier (2003) (if false).");
+          prm.declare_entry ("Grain size evolution time stepping", "step doubling",
+                             Patterns::Selection ("step doubling|adaptive"),
+                             "The scheme used to integrate the grain size evolution over one "
+                             "time step. ``step doubling'' starts with a sub-timestep of 500 years "
+                             "and doubles or halves it depending on the relative change of grain size "
+                             "in each sub-timestep. ``adaptive'' uses Heun's method and chooses the "
+                             "sub-timestep so that the estimated error of each sub-timestep stays below "
+                             "the ``Grain size evolution relative tolerance''.");
+          prm.declare_entry ("Grain size evolution relative tolerance", "1e-3",
+                             Patterns::Double (0.),
+                             "The relative tolerance for the error of one sub-timestep of the grain "
+                             "size evolution if the ``adaptive'' grain size evolution time stepping "
+                             "is used. "
+                             "Units: none.");
           prm.declare_entry ("Average specific grain boundary energy", "1.0",
                              Patterns::List (Patterns::Double (0.)),
                              "The average specific grain boundary energy $\\gamma$. "
@@ -1275,6 +1446,10 @@ namespace aspect
                                                   (Utilities::split_string_list(prm.get ("Reciprocal required strain")));
 
           use_paleowattmeter                    = prm.get_bool ("Use paleowattmeter");
+          use_adaptive_grain_size_evolution     = (prm.get ("Grain size evolution time stepping") == "adaptive");
+          grain_size_evolution_relative_tolerance = prm.get_double ("Grain size evolution relative tolerance");
+          AssertThrow (!use_adaptive_grain_size_evolution || grain_size_evolution_relative_tolerance > 0,
+                       ExcMessage("The grain size evolution relative tolerance must be greater than zero."));
           grain_boundary_energy                 = Utilities::string_to_double
                                                   (Utilities::split_string_list(prm.get ("Average specific grain boundary energy")));
           boundary_area_change_work_fraction    = Utilities::string_to_double
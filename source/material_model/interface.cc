@@ -30,6 +30,7 @@
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/fe/fe_q.h>
 
+#include <algorithm>
 #include <list>
 
 #ifdef DEBUG
@@ -92,6 +93,69 @@ namespace aspect
 
 
 
+    template <int dim>
+    void
+    Interface<dim>::evaluate_batch (const std::vector<const MaterialModel::MaterialModelInputs<dim> *> &inputs,
+                                    const std::vector<MaterialModel::MaterialModelOutputs<dim> *> &outputs) const
+    {
+      Assert (inputs.size() == outputs.size(),
+              ExcDimensionMismatch (inputs.size(), outputs.size()));
+
+      for (unsigned int i=0; i<inputs.size(); ++i)
+        evaluate (*inputs[i], *outputs[i]);
+    }
+
+
+
+    template <int dim>
+    void
+    Interface<dim>::evaluate_pointwise_batch (const std::vector<const MaterialModel::MaterialModelInputs<dim> *> &inputs,
+                                              const std::vector<MaterialModel::MaterialModelOutputs<dim> *> &outputs) const
+    {
+      Assert (inputs.size() == outputs.size(),
+              ExcDimensionMismatch (inputs.size(), outputs.size()));
+
+      if (inputs.size() == 0)
+        return;
+
+      // Additional inputs and outputs are attached to individual objects
+      // and can not be concatenated, so evaluate those one at a time.
+      bool can_concatenate = true;
+      unsigned int n_points = 0;
+      for (unsigned int i=0; i<inputs.size(); ++i)
+        {
+          if (inputs[i]->additional_inputs.size() != 0
+              || outputs[i]->additional_outputs.size() != 0
+              || (inputs[i]->strain_rate.size() == 0) != (inputs[0]->strain_rate.size() == 0))
+            can_concatenate = false;
+
+          n_points += inputs[i]->n_evaluation_points();
+        }
+
+      if (can_concatenate == false || inputs.size() == 1)
+        {
+          Interface<dim>::evaluate_batch (inputs, outputs);
+          return;
+        }
+
+      const MaterialModelInputs<dim> batch_in (inputs);
+      MaterialModelOutputs<dim> batch_out (n_points, outputs[0]->reaction_terms.size() > 0
+                                           ?
+                                           outputs[0]->reaction_terms[0].size()
+                                           :
+                                           0);
+      evaluate (batch_in, batch_out);
+
+      unsigned int first_point = 0;
+      for (unsigned int i=0; i<inputs.size(); ++i)
+        {
+          outputs[i]->copy_points_from (batch_out, first_point);
+          first_point += inputs[i]->n_evaluation_points();
+        }
+    }
+
+
+
     template <int dim>
     void
     Interface<dim>::
@@ -352,6 +416,47 @@ namespace aspect
 
 
 
+    template <int dim>
+    MaterialModelInputs<dim>::MaterialModelInputs(const std::vector<const MaterialModelInputs<dim> *> &inputs)
+      :
+      current_cell(),
+      requested_properties(MaterialProperties::uninitialized)
+    {
+      unsigned int n_points = 0;
+      for (const auto input : inputs)
+        {
+          Assert (input->additional_inputs.size() == 0,
+                  ExcMessage ("You can not concatenate MaterialModelInputs objects that have "
+                              "additional input objects attached"));
+          Assert ((input->strain_rate.size() == 0) == (inputs[0]->strain_rate.size() == 0),
+                  ExcMessage ("You can only concatenate MaterialModelInputs objects that "
+                              "either all or none provide strain rates."));
+          n_points += input->n_evaluation_points();
+        }
+
+      position.reserve(n_points);
+      temperature.reserve(n_points);
+      pressure.reserve(n_points);
+      pressure_gradient.reserve(n_points);
+      velocity.reserve(n_points);
+      composition.reserve(n_points);
+      strain_rate.reserve(n_points);
+
+      for (const auto input : inputs)
+        {
+          position.insert(position.end(), input->position.begin(), input->position.end());
+          temperature.insert(temperature.end(), input->temperature.begin(), input->temperature.end());
+          pressure.insert(pressure.end(), input->pressure.begin(), input->pressure.end());
+          pressure_gradient.insert(pressure_gradient.end(), input->pressure_gradient.begin(), input->pressure_gradient.end());
+          velocity.insert(velocity.end(), input->velocity.begin(), input->velocity.end());
+          composition.insert(composition.end(), input->composition.begin(), input->composition.end());
+          strain_rate.insert(strain_rate.end(), input->strain_rate.begin(), input->strain_rate.end());
+          requested_properties = requested_properties | input->requested_properties;
+        }
+    }
+
+
+
     template <int dim>
     void
     MaterialModelInputs<dim>::reinit(const FEValuesBase<dim,dim> &fe_values,
@@ -463,6 +568,38 @@ namespace aspect
 
 
 
+    template <int dim>
+    void
+    MaterialModelOutputs<dim>::copy_points_from (const MaterialModelOutputs<dim> &source,
+                                                 const unsigned int first_point)
+    {
+      const unsigned int n_points = n_evaluation_points();
+      Assert (first_point + n_points <= source.n_evaluation_points(),
+              ExcIndexRange (first_point + n_points, 0, source.n_evaluation_points()+1));
+
+      const unsigned int last_point = first_point + n_points;
+      std::copy (source.viscosities.begin() + first_point, source.viscosities.begin() + last_point,
+                 viscosities.begin());
+      std::copy (source.densities.begin() + first_point, source.densities.begin() + last_point,
+                 densities.begin());
+      std::copy (source.thermal_expansion_coefficients.begin() + first_point, source.thermal_expansion_coefficients.begin() + last_point,
+                 thermal_expansion_coefficients.begin());
+      std::copy (source.specific_heat.begin() + first_point, source.specific_heat.begin() + last_point,
+                 specific_heat.begin());
+      std::copy (source.thermal_conductivities.begin() + first_point, source.thermal_conductivities.begin() + last_point,
+                 thermal_conductivities.begin());
+      std::copy (source.compressibilities.begin() + first_point, source.compressibilities.begin() + last_point,
+                 compressibilities.begin());
+      std::copy (source.entropy_derivative_pressure.begin() + first_point, source.entropy_derivative_pressure.begin() + last_point,
+                 entropy_derivative_pressure.begin());
+      std::copy (source.entropy_derivative_temperature.begin() + first_point, source.entropy_derivative_temperature.begin() + last_point,
+                 entropy_derivative_temperature.begin());
+      std::copy (source.reaction_terms.begin() + first_point, source.reaction_terms.begin() + last_point,
+                 reaction_terms.begin());
+    }
+
+
+
     namespace MaterialAveraging
     {
       std::string get_averaging_operation_names ()
@@ -896,6 +1033,15 @@ namespace aspect
 
 
 
+    template <int dim>
+    std::unique_ptr<AdditionalMaterialOutputs<dim> >
+    PrescribedPlasticDilation<dim>::clone () const
+    {
+      return std_cxx14::make_unique<PrescribedPlasticDilation<dim>> (*this);
+    }
+
+
+
     namespace
     {
       std::vector<std::string> make_seismic_additional_outputs_names()
@@ -941,6 +1087,15 @@ namespace aspect
 
 
 
+    template <int dim>
+    std::unique_ptr<AdditionalMaterialOutputs<dim> >
+    SeismicAdditionalOutputs<dim>::clone () const
+    {
+      return std_cxx14::make_unique<SeismicAdditionalOutputs<dim>> (*this);
+    }
+
+
+
     namespace
     {
       std::vector<std::string> make_reaction_rate_outputs_names(const unsigned int n_comp)
@@ -992,6 +1147,15 @@ namespace aspect
 
 
 
+    template <int dim>
+    std::unique_ptr<AdditionalMaterialOutputs<dim> >
+    ReactionRateOutputs<dim>::clone () const
+    {
+      return std_cxx14::make_unique<ReactionRateOutputs<dim>> (*this);
+    }
+
+
+
     template<int dim>
     PrescribedFieldOutputs<dim>::PrescribedFieldOutputs (const unsigned int n_points,
                                                          const unsigned int n_comp)
@@ -1018,6 +1182,15 @@ namespace aspect
 
 
 
+    template <int dim>
+    std::unique_ptr<AdditionalMaterialOutputs<dim> >
+    PrescribedFieldOutputs<dim>::clone () const
+    {
+      return std_cxx14::make_unique<PrescribedFieldOutputs<dim>> (*this);
+    }
+
+
+
     template<int dim>
     PrescribedTemperatureOutputs<dim>::PrescribedTemperatureOutputs (const unsigned int n_points)
       :
@@ -1035,6 +1208,15 @@ namespace aspect
       AssertIndexRange (idx, 1);
       return prescribed_temperature_outputs;
     }
+
+
+
+    template <int dim>
+    std::unique_ptr<AdditionalMaterialOutputs<dim> >
+    PrescribedTemperatureOutputs<dim>::clone () const
+    {
+      return std_cxx14::make_unique<PrescribedTemperatureOutputs<dim>> (*this);
+    }
   }
 }
 
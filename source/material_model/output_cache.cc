@@ -0,0 +1,276 @@
+/*
+  Copyright (C) 2020 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <aspect/material_model/output_cache.h>
+
+namespace aspect
+{
+  namespace MaterialModel
+  {
+    namespace
+    {
+      /**
+       * Copy the values of all material properties from @p source to
+       * @p destination. Both objects need to have the same size.
+       */
+      template <int dim>
+      void
+      copy_material_properties (const MaterialModelOutputs<dim> &source,
+                                MaterialModelOutputs<dim> &destination)
+      {
+        destination.viscosities = source.viscosities;
+        destination.densities = source.densities;
+        destination.thermal_expansion_coefficients = source.thermal_expansion_coefficients;
+        destination.specific_heat = source.specific_heat;
+        destination.thermal_conductivities = source.thermal_conductivities;
+        destination.compressibilities = source.compressibilities;
+        destination.entropy_derivative_pressure = source.entropy_derivative_pressure;
+        destination.entropy_derivative_temperature = source.entropy_derivative_temperature;
+        destination.reaction_terms = source.reaction_terms;
+      }
+    }
+
+
+
+    template <int dim>
+    MaterialModelOutputCache<dim>::Entry::Entry (const MaterialModelInputs<dim> &in,
+                                                 const MaterialModelOutputs<dim> &out)
+      :
+      position (in.position),
+      temperature (in.temperature),
+      pressure (in.pressure),
+      pressure_gradient (in.pressure_gradient),
+      velocity (in.velocity),
+      composition (in.composition),
+      strain_rate (in.strain_rate),
+      requested_properties (in.requested_properties),
+      outputs (out.n_evaluation_points(),
+               (out.reaction_terms.size() > 0 ? out.reaction_terms[0].size() : 0))
+    {
+      copy_material_properties (out, outputs);
+
+      for (const auto &additional_output : out.additional_outputs)
+        {
+          outputs.additional_outputs.push_back (additional_output->clone());
+          additional_output_types.emplace_back (typeid(*additional_output));
+        }
+    }
+
+
+
+    template <int dim>
+    bool
+    MaterialModelOutputCache<dim>::Entry::matches (const MaterialModelInputs<dim> &in,
+                                                   const MaterialModelOutputs<dim> &out) const
+    {
+      // The stored outputs need to contain at least the requested properties
+      if ((static_cast<int>(requested_properties) & static_cast<int>(in.requested_properties))
+          != static_cast<int>(in.requested_properties))
+        return false;
+
+      if (out.additional_outputs.size() != additional_output_types.size())
+        return false;
+
+      for (unsigned int i=0; i<additional_output_types.size(); ++i)
+        if (std::type_index(typeid(*out.additional_outputs[i])) != additional_output_types[i])
+          return false;
+
+      // Compare the cheap inputs first
+      return (position == in.position
+              && temperature == in.temperature
+              && pressure == in.pressure
+              && composition == in.composition
+              && pressure_gradient == in.pressure_gradient
+              && velocity == in.velocity
+              && strain_rate == in.strain_rate);
+    }
+
+
+
+    template <int dim>
+    void
+    MaterialModelOutputCache<dim>::Entry::copy_to (MaterialModelOutputs<dim> &out) const
+    {
+      copy_material_properties (outputs, out);
+
+      for (unsigned int i=0; i<outputs.additional_outputs.size(); ++i)
+        out.additional_outputs[i] = outputs.additional_outputs[i]->clone();
+    }
+
+
+
+    template <int dim>
+    std::size_t
+    MaterialModelOutputCache<dim>::Entry::memory_consumption (const MaterialModelInputs<dim> &in,
+                                                              const MaterialModelOutputs<dim> &out)
+    {
+      const std::size_t n_points = in.n_evaluation_points();
+      const std::size_t n_compositional_fields = (in.composition.size() > 0 ? in.composition[0].size() : 0);
+
+      // Estimate the size of the inputs, of the eight scalar outputs, of
+      // the reaction terms and of the additional outputs. We do not know
+      // the size of additional outputs in general, so assume that each
+      // named output stores one value per point.
+      std::size_t n_additional_output_values = 0;
+      for (const auto &additional_output : out.additional_outputs)
+        if (const NamedAdditionalMaterialOutputs<dim> *named_output
+            = dynamic_cast<const NamedAdditionalMaterialOutputs<dim> *>(additional_output.get()))
+          n_additional_output_values += named_output->get_names().size() * n_points;
+
+      return sizeof(Entry)
+             + n_points * (sizeof(Point<dim>)
+                           + 2 * sizeof(double)
+                           + 2 * sizeof(Tensor<1,dim>)
+                           + (in.strain_rate.size() > 0 ? sizeof(SymmetricTensor<2,dim>) : 0)
+                           + 2 * n_compositional_fields * sizeof(double)
+                           + 8 * sizeof(double))
+             + n_additional_output_values * sizeof(double);
+    }
+
+
+
+    template <int dim>
+    MaterialModelOutputCache<dim>::MaterialModelOutputCache ()
+      :
+      memory_limit (0),
+      used_memory (0)
+    {}
+
+
+
+    template <int dim>
+    void
+    MaterialModelOutputCache<dim>::set_memory_limit (const std::size_t new_memory_limit)
+    {
+      clear();
+
+      std::lock_guard<std::mutex> lock(mutex);
+      memory_limit = new_memory_limit;
+    }
+
+
+
+    template <int dim>
+    void
+    MaterialModelOutputCache<dim>::clear ()
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      entries.clear();
+      used_memory = 0;
+    }
+
+
+
+    template <int dim>
+    std::size_t
+    MaterialModelOutputCache<dim>::memory_consumption () const
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      return used_memory;
+    }
+
+
+
+    template <int dim>
+    bool
+    MaterialModelOutputCache<dim>::can_be_cached (const MaterialModelInputs<dim> &in) const
+    {
+      if (memory_limit == 0
+          || in.current_cell.state() != IteratorState::valid
+          || in.additional_inputs.size() > 0)
+        return false;
+
+      return true;
+    }
+
+
+
+    template <int dim>
+    void
+    MaterialModelOutputCache<dim>::evaluate (const Interface<dim> &material_model,
+                                             const MaterialModelInputs<dim> &in,
+                                             MaterialModelOutputs<dim> &out)
+    {
+      if (!can_be_cached(in))
+        {
+          material_model.evaluate(in, out);
+          return;
+        }
+
+      const unsigned int cell_index = in.current_cell->active_cell_index();
+
+      // First see if we have evaluated the same inputs before
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto cell_entries = entries.find(cell_index);
+        if (cell_entries != entries.end())
+          for (const Entry &entry : cell_entries->second)
+            if (entry.matches(in, out))
+              {
+                entry.copy_to(out);
+                return;
+              }
+      }
+
+      // If not, evaluate the material model without holding the lock, and
+      // store the result if there is enough space left. Check this before
+      // copying the inputs and outputs into a new entry.
+      material_model.evaluate(in, out);
+
+      const std::size_t entry_memory = Entry::memory_consumption(in, out);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (used_memory + entry_memory > memory_limit)
+          return;
+      }
+
+      // Additional outputs that do not support being copied can not be
+      // stored. We only find out about this when we try to copy them, so
+      // use the copies made for the entry rather than cloning twice.
+      Entry entry (in, out);
+      for (const auto &additional_output : entry.outputs.additional_outputs)
+        if (additional_output == nullptr)
+          return;
+
+      // Another thread may have used up the remaining space in the meantime
+      std::lock_guard<std::mutex> lock(mutex);
+      if (used_memory + entry_memory <= memory_limit)
+        {
+          entries[cell_index].emplace_back(std::move(entry));
+          used_memory += entry_memory;
+        }
+    }
+  }
+}
+
+
+// explicit instantiations
+namespace aspect
+{
+  namespace MaterialModel
+  {
+#define INSTANTIATE(dim) \
+  template class MaterialModelOutputCache<dim>;
+
+    ASPECT_INSTANTIATE(INSTANTIATE)
+
+#undef INSTANTIATE
+  }
+}
@@ -63,6 +63,15 @@ namespace aspect
 
 
 
+    template <int dim>
+    std::unique_ptr<AdditionalMaterialOutputs<dim> >
+    ElasticAdditionalOutputs<dim>::clone () const
+    {
+      return std_cxx14::make_unique<ElasticAdditionalOutputs<dim>> (*this);
+    }
+
+
+
     namespace Rheology
     {
       template <int dim>
@@ -37,6 +37,7 @@ namespace aspect
       // that can influence the density
       const unsigned int n_compositions_for_eos = std::min(this->n_compositional_fields()+1, 2u);
       EquationOfStateOutputs<dim> eos_outputs (n_compositions_for_eos);
+      std::vector<double> volume_fractions (n_compositions_for_eos, 1.0);
 
       for (unsigned int i=0; i < in.n_evaluation_points(); ++i)
         {
@@ -78,18 +79,32 @@ namespace aspect
           for (unsigned int c=0; c<in.composition[i].size(); ++c)
             out.reaction_terms[i][c] = 0.0;
 
-          std::vector<double> volume_fractions (n_compositions_for_eos, 1.0);
           if (in.composition[i].size()>0)
             {
               volume_fractions[1] = std::max(0.0, in.composition[i][0]);
               volume_fractions[0] = 1.0 - volume_fractions[1];
             }
+          else
+            std::fill (volume_fractions.begin(), volume_fractions.end(), 1.0);
 
           out.densities[i] = MaterialUtilities::average_value(volume_fractions, eos_outputs.densities, MaterialUtilities::arithmetic);
         }
     }
 
 
+    template <int dim>
+    void
+    Simple<dim>::
+    evaluate_batch (const std::vector<const MaterialModel::MaterialModelInputs<dim> *> &inputs,
+                    const std::vector<MaterialModel::MaterialModelOutputs<dim> *> &outputs) const
+    {
+      // All properties of this model only depend on the inputs at the
+      // same point, so all points can be evaluated at once.
+      this->evaluate_pointwise_batch (inputs, outputs);
+    }
+
+
+
     template <int dim>
     double
     Simple<dim>::
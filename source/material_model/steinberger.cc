@@ -255,6 +255,7 @@ namespace aspect
     void
     Steinberger<dim>::
     fill_mass_and_volume_fractions (const MaterialModel::MaterialModelInputs<dim> &in,
+                                    const std::vector<MaterialUtilities::Lookup::LookupValues> &lookup_values,
                                     std::vector<std::vector<double>> &mass_fractions,
                                     std::vector<std::vector<double>> &volume_fractions) const
     {
@@ -276,10 +277,10 @@ namespace aspect
                       const double mass_fraction = in.composition[i][first_composition_index+j-1];
                       mass_fractions[i][j] = mass_fraction;
                       mass_fractions[i][0] -= mass_fraction;
-                      volume_fractions[i][j] = mass_fraction/material_lookup[j]->density(in.temperature[i],in.pressure[i]);
+                      volume_fractions[i][j] = mass_fraction/lookup_values[j].densities[i];
                       summed_volumes += volume_fractions[i][j];
                     }
-                  volume_fractions[i][0] = mass_fractions[i][0]/material_lookup[0]->density(in.temperature[i],in.pressure[i]);
+                  volume_fractions[i][0] = mass_fractions[i][0]/lookup_values[0].densities[i];
                   summed_volumes += volume_fractions[i][0];
 
                 }
@@ -289,7 +290,7 @@ namespace aspect
                     {
                       const double mass_fraction = in.composition[i][first_composition_index+j];
                       mass_fractions[i][j] = mass_fraction;
-                      volume_fractions[i][j] = mass_fraction/material_lookup[j]->density(in.temperature[i],in.pressure[i]);
+                      volume_fractions[i][j] = mass_fraction/lookup_values[j].densities[i];
                       summed_volumes += volume_fractions[i][j];
                     }
                 }
@@ -309,6 +310,7 @@ namespace aspect
     fill_seismic_velocities (const MaterialModel::MaterialModelInputs<dim> &in,
                              const std::vector<double> &composite_densities,
                              const std::vector<std::vector<double>> &volume_fractions,
+                             const std::vector<MaterialUtilities::Lookup::LookupValues> &lookup_values,
                              SeismicAdditionalOutputs<dim> *seismic_out) const
     {
       // This function returns the Voigt-Reuss-Hill averages of the
@@ -323,8 +325,8 @@ namespace aspect
         {
           if (material_lookup.size() == 1)
             {
-              seismic_out->vs[i] = material_lookup[0]->seismic_Vs(in.temperature[i],in.pressure[i]);
-              seismic_out->vp[i] = material_lookup[0]->seismic_Vp(in.temperature[i],in.pressure[i]);
+              seismic_out->vs[i] = lookup_values[0].seismic_Vs[i];
+              seismic_out->vp[i] = lookup_values[0].seismic_Vp[i];
             }
           else
             {
@@ -335,8 +337,8 @@ namespace aspect
 
               for (unsigned int j = 0; j < material_lookup.size(); ++j)
                 {
-                  const double mu = material_lookup[j]->density(in.temperature[i],in.pressure[i])*std::pow(material_lookup[j]->seismic_Vs(in.temperature[i],in.pressure[i]), 2.);
-                  const double k =  material_lookup[j]->density(in.temperature[i],in.pressure[i])*std::pow(material_lookup[j]->seismic_Vp(in.temperature[i],in.pressure[i]), 2.) - 4./3.*mu;
+                  const double mu = lookup_values[j].densities[i]*std::pow(lookup_values[j].seismic_Vs[i], 2.);
+                  const double k =  lookup_values[j].densities[i]*std::pow(lookup_values[j].seismic_Vp[i], 2.) - 4./3.*mu;
 
                   k_voigt += volume_fractions[i][j] * k;
                   mu_voigt += volume_fractions[i][j] * mu;
@@ -359,10 +361,11 @@ namespace aspect
     Steinberger<dim>::
     fill_phase_volume_fractions (const MaterialModel::MaterialModelInputs<dim> &in,
                                  const std::vector<std::vector<double>> &volume_fractions,
+                                 const std::vector<MaterialUtilities::Lookup::LookupValues> &lookup_values,
                                  NamedAdditionalMaterialOutputs<dim> *phase_volume_fractions_out) const
     {
-      // Each call to material_lookup[j]->phase_volume_fraction(k,temperature,pressure)
-      // returns the volume fraction of the kth phase which is present in that material lookup
+      // The entry lookup_values[j].phase_volume_fractions[k][i]
+      // contains the volume fraction of the kth phase which is present in that material lookup
       // at the requested temperature and pressure.
       // The total volume fraction of each phase at each evaluation point is equal to
       // sum_j (volume_fraction_of_material_j * phase_volume_fraction_in_material_j).
@@ -375,7 +378,7 @@ namespace aspect
       for (unsigned int i = 0; i < in.n_evaluation_points(); ++i)
         for (unsigned j = 0; j < material_lookup.size(); ++j)
           for (unsigned int k = 0; k < unique_phase_indices[j].size(); ++k)
-            phase_volume_fractions[unique_phase_indices[j][k]][i] += volume_fractions[i][j] * material_lookup[j]->phase_volume_fraction(k,in.temperature[i],in.pressure[i]);
+            phase_volume_fractions[unique_phase_indices[j][k]][i] += volume_fractions[i][j] * lookup_values[j].phase_volume_fractions[k][i];
 
       phase_volume_fractions_out->output_values = phase_volume_fractions;
     }
@@ -437,9 +440,28 @@ namespace aspect
     Steinberger<dim>::evaluate(const MaterialModel::MaterialModelInputs<dim> &in,
                                MaterialModel::MaterialModelOutputs<dim> &out) const
     {
+      SeismicAdditionalOutputs<dim> *seismic_out = out.template get_additional_output<SeismicAdditionalOutputs<dim> >();
+      NamedAdditionalMaterialOutputs<dim> *phase_volume_fractions_out = out.template get_additional_output<NamedAdditionalMaterialOutputs<dim> >();
+
+      // Look up all properties we need from each of the tables at once,
+      // rather than finding the position of every point in the tables
+      // again for every property
+      namespace LookupProperties = MaterialUtilities::Lookup::LookupProperties;
+      LookupProperties::Property requested_lookup_properties = LookupProperties::density | LookupProperties::dRhodp;
+      if (!latent_heat)
+        requested_lookup_properties |= LookupProperties::thermal_expansivity | LookupProperties::specific_heat;
+      if (seismic_out != nullptr)
+        requested_lookup_properties |= LookupProperties::seismic_Vp | LookupProperties::seismic_Vs;
+      if (phase_volume_fractions_out != nullptr)
+        requested_lookup_properties |= LookupProperties::phase_volume_fractions;
+
+      std::vector<MaterialUtilities::Lookup::LookupValues> lookup_values(material_lookup.size());
+      for (unsigned int j=0; j<material_lookup.size(); ++j)
+        material_lookup[j]->evaluate(in.temperature, in.pressure, requested_lookup_properties, lookup_values[j]);
+
       std::vector<std::vector<double>> mass_fractions;
       std::vector<std::vector<double>> volume_fractions;
-      fill_mass_and_volume_fractions (in, mass_fractions, volume_fractions);
+      fill_mass_and_volume_fractions (in, lookup_values, mass_fractions, volume_fractions);
 
       for (unsigned int i=0; i < in.n_evaluation_points(); ++i)
         {
@@ -461,13 +483,13 @@ namespace aspect
 
           for (unsigned int j=0; j<material_lookup.size(); ++j)
             {
-              densities[j] = material_lookup[j]->density(in.temperature[i],in.pressure[i]);
-              compressibilities[j] = material_lookup[j]->dRhodp(in.temperature[i],in.pressure[i])/densities[j];
+              densities[j] = lookup_values[j].densities[i];
+              compressibilities[j] = lookup_values[j].dRhodp[i]/densities[j];
 
               if (!latent_heat)
                 {
-                  thermal_expansivities[j] = material_lookup[j]->thermal_expansivity(in.temperature[i],in.pressure[i]);
-                  specific_heats[j] = material_lookup[j]->specific_heat(in.temperature[i],in.pressure[i]);
+                  thermal_expansivities[j] = lookup_values[j].thermal_expansivities[i];
+                  specific_heats[j] = lookup_values[j].specific_heats[i];
                 }
             }
 
@@ -541,12 +563,12 @@ namespace aspect
         }
 
       // fill seismic velocity outputs if they exist
-      if (SeismicAdditionalOutputs<dim> *seismic_out = out.template get_additional_output<SeismicAdditionalOutputs<dim> >())
-        fill_seismic_velocities(in, out.densities, volume_fractions, seismic_out);
+      if (seismic_out != nullptr)
+        fill_seismic_velocities(in, out.densities, volume_fractions, lookup_values, seismic_out);
 
       // fill phase volume outputs if they exist
-      if (NamedAdditionalMaterialOutputs<dim> *phase_volume_fractions_out = out.template get_additional_output<NamedAdditionalMaterialOutputs<dim> >())
-        fill_phase_volume_fractions(in, volume_fractions, phase_volume_fractions_out);
+      if (phase_volume_fractions_out != nullptr)
+        fill_phase_volume_fractions(in, volume_fractions, lookup_values, phase_volume_fractions_out);
     }
 
 
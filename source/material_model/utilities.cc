@@ -233,6 +233,141 @@ namespace aspect
             }
         }
 
+        namespace
+        {
+          /**
+           * The positions of a number of temperature-pressure points in a
+           * lookup table: the indices of the table cells that contain them,
+           * and the coordinates of the points within these cells.
+           */
+          struct TableCells
+          {
+            std::vector<unsigned int> temperature_index;
+            std::vector<unsigned int> pressure_index;
+            std::vector<double> xi;
+            std::vector<double> eta;
+          };
+
+
+
+          /**
+           * Evaluate the data in @p table at the points described by @p cells,
+           * using bilinear interpolation if @p interpol is true, and the value
+           * at the closest smaller data point otherwise.
+           */
+          void
+          interpolate_table (const Table<2,double> &table,
+                             const TableCells &cells,
+                             const bool interpol,
+                             std::vector<double> &values)
+          {
+            const unsigned int n_points = cells.xi.size();
+            values.resize(n_points);
+
+            // Access the table storage directly, it is stored row by row
+            const double *data = &table[0][0];
+            const std::size_t n_cols = table.n_cols();
+
+            if (!interpol)
+              for (unsigned int i=0; i<n_points; ++i)
+                values[i] = data[cells.temperature_index[i]*n_cols + cells.pressure_index[i]];
+            else
+              for (unsigned int i=0; i<n_points; ++i)
+                {
+                  const double *cell = data + cells.temperature_index[i]*n_cols + cells.pressure_index[i];
+                  const double xi = cells.xi[i];
+                  const double eta = cells.eta[i];
+
+                  values[i] = ((1-xi)*(1-eta)*cell[0] +
+                               xi    *(1-eta)*cell[n_cols] +
+                               (1-xi)*eta    *cell[1] +
+                               xi    *eta    *cell[n_cols+1]);
+                }
+          }
+        }
+
+
+
+        void
+        MaterialLookup::evaluate (const std::vector<double> &temperatures,
+                                  const std::vector<double> &pressures,
+                                  const LookupProperties::Property requested_properties,
+                                  LookupValues &values) const
+        {
+          Assert(temperatures.size() == pressures.size(),
+                 ExcDimensionMismatch(temperatures.size(), pressures.size()));
+
+          const unsigned int n_points = temperatures.size();
+
+          // Find the table cells of all points once, in the same way as value()
+          // does for a single point
+          const auto find_cells = [&](const double pressure_offset,
+                                      TableCells &cells)
+          {
+            cells.temperature_index.resize(n_points);
+            cells.pressure_index.resize(n_points);
+            cells.xi.resize(n_points);
+            cells.eta.resize(n_points);
+
+            for (unsigned int i=0; i<n_points; ++i)
+              {
+                const double nT = get_nT(temperatures[i]);
+                const double np = get_np(pressures[i] + pressure_offset);
+                cells.temperature_index[i] = static_cast<unsigned int>(nT);
+                cells.pressure_index[i] = static_cast<unsigned int>(np);
+                cells.xi[i] = nT - cells.temperature_index[i];
+                cells.eta[i] = np - cells.pressure_index[i];
+
+                Assert(cells.temperature_index[i]<density_values.n_rows(),
+                       ExcMessage("Attempting to look up a temperature value with index greater than the number of rows."));
+                Assert(cells.pressure_index[i]<density_values.n_cols(),
+                       ExcMessage("Attempting to look up a pressure value with index greater than the number of columns."));
+              }
+          };
+
+          TableCells cells;
+          find_cells(0., cells);
+
+          const auto requested = [&](const LookupProperties::Property property)
+          {
+            return (static_cast<int>(requested_properties) & static_cast<int>(property)) != 0;
+          };
+
+          if (requested(LookupProperties::density) || requested(LookupProperties::dRhodp))
+            interpolate_table(density_values, cells, interpolation, values.densities);
+          if (requested(LookupProperties::thermal_expansivity))
+            interpolate_table(thermal_expansivity_values, cells, interpolation, values.thermal_expansivities);
+          if (requested(LookupProperties::specific_heat))
+            interpolate_table(specific_heat_values, cells, interpolation, values.specific_heats);
+          if (requested(LookupProperties::seismic_Vp))
+            interpolate_table(vp_values, cells, false, values.seismic_Vp);
+          if (requested(LookupProperties::seismic_Vs))
+            interpolate_table(vs_values, cells, false, values.seismic_Vs);
+          if (requested(LookupProperties::enthalpy))
+            interpolate_table(enthalpy_values, cells, true, values.enthalpies);
+
+          if (requested(LookupProperties::phase_volume_fractions))
+            {
+              values.phase_volume_fractions.resize(phase_volume_fractions.size());
+              for (unsigned int k=0; k<phase_volume_fractions.size(); ++k)
+                interpolate_table(phase_volume_fractions[k], cells, interpolation, values.phase_volume_fractions[k]);
+            }
+
+          // The pressure derivative of the density is computed with the same
+          // finite difference as in dRhodp(), which needs the density at a
+          // second set of points
+          if (requested(LookupProperties::dRhodp))
+            {
+              find_cells(delta_press, cells);
+              interpolate_table(density_values, cells, interpolation, values.dRhodp);
+
+              for (unsigned int i=0; i<n_points; ++i)
+                values.dRhodp[i] = (values.dRhodp[i] - values.densities[i]) / delta_press;
+            }
+        }
+
+
+
         std::array<double,2>
         MaterialLookup::get_pT_steps() const
         {
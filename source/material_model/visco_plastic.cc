@@ -171,11 +171,39 @@ namespace aspect
 
 
 
+    template <int dim>
+    std::unique_ptr<AdditionalMaterialOutputs<dim> >
+    PlasticAdditionalOutputs<dim>::clone () const
+    {
+      return std_cxx14::make_unique<PlasticAdditionalOutputs<dim>> (*this);
+    }
+
+
+
+    template <int dim>
+    std::pair<std::vector<double>, std::vector<bool> >
+    ViscoPlastic<dim>::
+    calculate_isostrain_viscosities (const MaterialModel::MaterialModelInputs<dim> &in,
+                                     const unsigned int i,
+                                     const std::vector<double> &volume_fractions,
+                                     const ViscosityScheme &viscous_type,
+                                     const YieldScheme &yield_type,
+                                     const std::vector<double> &phase_function_values) const
+    {
+      return calculate_isostrain_viscosities(in, i, in.strain_rate[i], in.pressure[i],
+                                             volume_fractions, viscous_type, yield_type,
+                                             phase_function_values);
+    }
+
+
+
     template <int dim>
     std::pair<std::vector<double>, std::vector<bool> >
     ViscoPlastic<dim>::
     calculate_isostrain_viscosities (const MaterialModel::MaterialModelInputs<dim> &in,
                                      const unsigned int i,
+                                     const SymmetricTensor<2,dim> &strain_rate,
+                                     const double pressure,
                                      const std::vector<double> &volume_fractions,
                                      const ViscosityScheme &viscous_type,
                                      const YieldScheme &yield_type,
@@ -197,14 +225,14 @@ namespace aspect
       // a specified "reference" strain rate is used as the returned value would
       // otherwise be zero.
       const bool use_reference_strainrate = (this->get_timestep_number() == 0) &&
-                                            (in.strain_rate[i].norm() <= std::numeric_limits<double>::min());
+                                            (strain_rate.norm() <= std::numeric_limits<double>::min());
 
       double edot_ii;
       if (use_reference_strainrate)
         edot_ii = ref_strain_rate;
       else
         // Calculate the square root of the second moment invariant for the deviatoric strain rate tensor.
-        edot_ii = std::max(std::sqrt(std::fabs(second_invariant(deviator(in.strain_rate[i])))),
+        edot_ii = std::max(std::sqrt(std::fabs(second_invariant(deviator(strain_rate)))),
                            min_strain_rate);
 
       // Calculate viscosities for each of the individual compositional phases
@@ -215,7 +243,7 @@ namespace aspect
           // Choice of activation volume depends on whether there is an adiabatic temperature
           // gradient used when calculating the viscosity. This allows the same activation volume
           // to be used in incompressible and compressible models.
-          const double temperature_for_viscosity = in.temperature[i] + adiabatic_temperature_gradient_for_viscosity*in.pressure[i];
+          const double temperature_for_viscosity = in.temperature[i] + adiabatic_temperature_gradient_for_viscosity*pressure;
           AssertThrow(temperature_for_viscosity != 0, ExcMessage(
                         "The temperature used in the calculation of the visco-plastic rheology is zero. "
                         "This is not allowed, because this value is used to divide through. It is probably "
@@ -223,15 +251,15 @@ namespace aspect
                         "values for debugging are: temperature (" + Utilities::to_string(in.temperature[i]) +
                         "), adiabatic_temperature_gradient_for_viscosity ("
                         + Utilities::to_string(adiabatic_temperature_gradient_for_viscosity) + ") and pressure ("
-                        + Utilities::to_string(in.pressure[i]) + ")."));
+                        + Utilities::to_string(pressure) + ")."));
 
           // Step 1a: compute viscosity from diffusion creep law
-          const double viscosity_diffusion = diffusion_creep.compute_viscosity(in.pressure[i], temperature_for_viscosity, j,
+          const double viscosity_diffusion = diffusion_creep.compute_viscosity(pressure, temperature_for_viscosity, j,
                                                                                phase_function_values,
                                                                                phase_function.n_phase_transitions_for_each_composition());
 
           // Step 1b: compute viscosity from dislocation creep law
-          const double viscosity_dislocation = dislocation_creep.compute_viscosity(edot_ii, in.pressure[i], temperature_for_viscosity, j,
+          const double viscosity_dislocation = dislocation_creep.compute_viscosity(edot_ii, pressure, temperature_for_viscosity, j,
                                                                                    phase_function_values,
                                                                                    phase_function.n_phase_transitions_for_each_composition());
 
@@ -270,7 +298,7 @@ namespace aspect
           // Step 1d: compute viscosity from Peierls creep law and harmonically average with current viscosities
           if (use_peierls_creep)
             {
-              const double viscosity_peierls = peierls_creep->compute_viscosity(edot_ii, in.pressure[i], temperature_for_viscosity, j);
+              const double viscosity_peierls = peierls_creep->compute_viscosity(edot_ii, pressure, temperature_for_viscosity, j);
               viscosity_pre_yield = (viscosity_pre_yield * viscosity_peierls) / (viscosity_pre_yield + viscosity_peierls);
             }
 
@@ -295,7 +323,7 @@ namespace aspect
                 current_edot_ii = ref_strain_rate;
               else
                 {
-                  const double viscoelastic_strain_rate_invariant = elastic_rheology.calculate_viscoelastic_strain_rate(in.strain_rate[i],
+                  const double viscoelastic_strain_rate_invariant = elastic_rheology.calculate_viscoelastic_strain_rate(strain_rate,
                                                                     stress_old,
                                                                     elastic_shear_moduli[j]);
 
@@ -333,7 +361,7 @@ namespace aspect
           // Step 4a: calculate Drucker-Prager yield stress
           const double yield_stress = drucker_prager_plasticity.compute_yield_stress(current_cohesion,
                                                                                      current_friction,
-                                                                                     std::max(in.pressure[i], 0.0),
+                                                                                     std::max(pressure, 0.0),
                                                                                      drucker_prager_parameters.max_yield_stress);
 
           // Step 4b: select if yield viscosity is based on Drucker Prager or stress limiter rheology
@@ -357,7 +385,7 @@ namespace aspect
                   {
                     viscosity_yield = drucker_prager_plasticity.compute_viscosity(current_cohesion,
                                                                                   current_friction,
-                                                                                  std::max(in.pressure[i], 0.0),
+                                                                                  std::max(pressure, 0.0),
                                                                                   current_edot_ii,
                                                                                   drucker_prager_parameters.max_yield_stress);
                     composition_yielding[j] = true;
@@ -430,9 +458,6 @@ namespace aspect
 
           const double finite_difference_accuracy = 1e-7;
 
-          // A new material model inputs variable that uses the strain rate and pressure difference.
-          MaterialModel::MaterialModelInputs<dim> in_derivatives = in;
-
           // For each independent component, compute the derivative.
           for (unsigned int component = 0; component < SymmetricTensor<2,dim>::n_independent_components; ++component)
             {
@@ -447,10 +472,9 @@ namespace aspect
                                                                     * finite_difference_accuracy
                                                                     * Utilities::nth_basis_for_symmetric_tensors<dim>(component);
 
-              in_derivatives.strain_rate[i] = strain_rate_difference;
-
-              std::vector<double> eta_component =
-                calculate_isostrain_viscosities(in_derivatives, i, volume_fractions,
+              const std::vector<double> eta_component =
+                calculate_isostrain_viscosities(in, i, strain_rate_difference, in.pressure[i],
+                                                volume_fractions,
                                                 viscous_flow_law, yield_mechanism,
                                                 phase_function_values).first;
 
@@ -474,13 +498,13 @@ namespace aspect
            */
           const double pressure_difference = in.pressure[i] + (std::fabs(in.pressure[i]) * finite_difference_accuracy);
 
-          in_derivatives.pressure[i] = pressure_difference;
-
-          // Modify the in_derivatives object again to take the original strain rate.
-          in_derivatives.strain_rate[i] = in.strain_rate[i];
-
+          // Evaluate the viscosity with the perturbed pressure. Note that we pass the
+          // perturbed values directly instead of modifying a copy of the
+          // complete material model inputs, whose size is proportional to
+          // the number of evaluation points.
           const std::vector<double> viscosity_difference =
-            calculate_isostrain_viscosities(in_derivatives, i, volume_fractions,
+            calculate_isostrain_viscosities(in, i, in.strain_rate[i], pressure_difference,
+                                            volume_fractions,
                                             viscous_flow_law, yield_mechanism,
                                             phase_function_values).first;
 
@@ -701,6 +725,27 @@ namespace aspect
         }
     }
 
+    template <int dim>
+    void
+    ViscoPlastic<dim>::
+    evaluate_batch (const std::vector<const MaterialModel::MaterialModelInputs<dim> *> &inputs,
+                    const std::vector<MaterialModel::MaterialModelOutputs<dim> *> &outputs) const
+    {
+      // The reaction terms of the elastic and finite strain rheologies are
+      // computed from the old solution on the current cell, which is not
+      // available once the inputs are concatenated.
+      // Test the requested properties directly: requests_property() reports
+      // reaction terms as requested whenever strain rates are provided.
+      for (const auto input : inputs)
+        if ((input->requested_properties & MaterialProperties::reaction_terms) != 0)
+          {
+            MaterialModel::Interface<dim>::evaluate_batch (inputs, outputs);
+            return;
+          }
+
+      this->evaluate_pointwise_batch (inputs, outputs);
+    }
+
     template <int dim>
     double
     ViscoPlastic<dim>::
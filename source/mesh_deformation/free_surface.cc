@@ -208,6 +208,14 @@ namespace aspect
 
 
 
+    template <int dim>
+    double FreeSurface<dim>::get_free_surface_theta () const
+    {
+      return free_surface_theta;
+    }
+
+
+
     template <int dim>
     void FreeSurface<dim>::project_velocity_onto_boundary(const DoFHandler<dim> &mesh_deformation_dof_handler,
                                                           const IndexSet &mesh_locally_owned,
@@ -23,6 +23,7 @@
 #include <aspect/geometry_model/initial_topography_model/zero_topography.h>
 #include <aspect/geometry_model/box.h>
 #include <aspect/simulator.h>
+#include <aspect/stokes_matrix_free.h>
 #include <aspect/global.h>
 
 #include <deal.II/dofs/dof_renumbering.h>
@@ -32,9 +33,12 @@
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/fe/fe_q.h>
 #include <deal.II/fe/mapping_q1_eulerian.h>
+#include <deal.II/fe/mapping_q_eulerian.h>
 
 #include <deal.II/lac/sparsity_tools.h>
 
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+
 #include <deal.II/numerics/vector_tools.h>
 
 
@@ -361,6 +365,14 @@ namespace aspect
       // the mesh displacements in the interior of the domain
       compute_mesh_displacements();
 
+      // The matrix-free Stokes solver stores the geometry of the active
+      // and the multigrid level meshes, which are now out of date.
+      if (sim.stokes_matrix_free)
+        {
+          update_multilevel_deformation();
+          sim.stokes_matrix_free->setup_operators();
+        }
+
       // Interpolate the mesh velocity into the same
       // finite element space as used in the Stokes solve, which
       // is needed for the ALE corrections.
@@ -924,6 +936,11 @@ namespace aspect
 
       mesh_deformation_dof_handler.distribute_dofs(mesh_deformation_fe);
 
+      // The matrix-free GMG Stokes solver needs the mesh displacements
+      // on all multigrid levels.
+      if (sim.parameters.stokes_solver_type == Parameters<dim>::StokesSolverType::block_gmg)
+        mesh_deformation_dof_handler.distribute_mg_dofs();
+
       this->get_pcout() << "Number of mesh deformation degrees of freedom: "
                         << mesh_deformation_dof_handler.n_dofs()
                         << std::endl;
@@ -969,6 +986,67 @@ namespace aspect
       if (this->simulator_is_past_initialization() == false ||
           this->get_timestep_number() == 0)
         deform_initial_mesh();
+
+      if (sim.parameters.stokes_solver_type == Parameters<dim>::StokesSolverType::block_gmg)
+        update_multilevel_deformation();
+    }
+
+
+
+    template <int dim>
+    void MeshDeformationHandler<dim>::update_multilevel_deformation()
+    {
+      AssertThrow(sim.parameters.stokes_solver_type == Parameters<dim>::StokesSolverType::block_gmg,
+                  ExcInternalError());
+
+#if DEAL_II_VERSION_GTE(9,3,0)
+      const unsigned int n_levels = sim.triangulation.n_global_levels();
+      level_displacements.resize(0, n_levels-1);
+
+      // MGTransferMatrixFree only works with deal.II vectors, so copy
+      // the locally owned part of the displacements first.
+      dealii::LinearAlgebra::distributed::Vector<double> displacements(mesh_locally_owned,
+                                                                       mesh_locally_relevant,
+                                                                       sim.mpi_communicator);
+      for (const auto index : mesh_locally_owned)
+        displacements(index) = mesh_displacements(index);
+      displacements.update_ghost_values();
+
+      MGTransferMatrixFree<dim,double> transfer;
+      transfer.build(mesh_deformation_dof_handler);
+      transfer.interpolate_to_mg(mesh_deformation_dof_handler,
+                                 level_displacements,
+                                 displacements);
+
+      // The mapping needs to access the displacements of all vertices of
+      // the locally owned and ghost level cells, so make sure the level
+      // vectors store all locally relevant level DoFs.
+      for (unsigned int level=0; level<n_levels; ++level)
+        {
+          IndexSet relevant_level_dofs;
+          DoFTools::extract_locally_relevant_level_dofs(mesh_deformation_dof_handler,
+                                                        level,
+                                                        relevant_level_dofs);
+          dealii::LinearAlgebra::distributed::Vector<double>
+          ghosted_level_displacements(mesh_deformation_dof_handler.locally_owned_mg_dofs(level),
+                                      relevant_level_dofs,
+                                      sim.mpi_communicator);
+          ghosted_level_displacements.copy_locally_owned_data_from(level_displacements[level]);
+          ghosted_level_displacements.update_ghost_values();
+          level_displacements[level].swap(ghosted_level_displacements);
+        }
+
+      // The mapping stores pointers to the individual level vectors,
+      // so it has to be recreated whenever the hierarchy changes.
+      level_mapping.reset (new MappingQEulerian<dim, dealii::LinearAlgebra::distributed::Vector<double> >
+                           (1, mesh_deformation_dof_handler, level_displacements));
+#else
+      // MappingQEulerian can only describe the deformed multigrid levels
+      // starting with deal.II 9.3.
+      AssertThrow(false,
+                  ExcMessage("Mesh deformation with the matrix-free GMG Stokes solver "
+                             "requires deal.II 9.3 or newer."));
+#endif
     }
 
 
@@ -1016,6 +1094,17 @@ namespace aspect
     }
 
 
+    template <int dim>
+    const Mapping<dim> &
+    MeshDeformationHandler<dim>::get_level_mapping () const
+    {
+      Assert (level_mapping.get() != nullptr,
+              ExcMessage ("The multigrid level mapping is only available if "
+                          "the matrix-free GMG Stokes solver is used."));
+      return *level_mapping;
+    }
+
+
     template <int dim>
     const LinearAlgebra::Vector &
     MeshDeformationHandler<dim>::get_initial_topography () const
@@ -58,7 +58,7 @@ namespace aspect
 
             fe_values.reinit(cell);
             in.reinit(fe_values, cell, this->introspection(), this->get_solution(), true);
-            this->get_material_model().evaluate(in, out);
+            this->evaluate_material_model(in, out);
 
             MaterialModel::MeltOutputs<dim> *melt_out = out.template get_additional_output<MaterialModel::MeltOutputs<dim> >();
             AssertThrow(melt_out != nullptr,
@@ -69,7 +69,7 @@ namespace aspect
             fe_values.reinit(cell);
             // Set use_strain_rates to false since we don't need viscosity
             in.reinit(fe_values, cell, this->introspection(), this->get_solution(), false);
-            this->get_material_model().evaluate(in, out);
+            this->evaluate_material_model(in, out);
 
             cell->get_dof_indices (local_dof_indices);
 
@@ -74,7 +74,7 @@ namespace aspect
           {
             fe_values.reinit(cell);
             in.reinit(fe_values, cell, this->introspection(), this->get_solution());
-            this->get_material_model().evaluate(in, out);
+            this->evaluate_material_model(in, out);
 
             cell->get_dof_indices (local_dof_indices);
 
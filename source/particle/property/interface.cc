@@ -329,11 +329,25 @@ namespace aspect
           return;
 
         std::vector<double> particle_properties;
+        initialize_one_particle(particle->get_location(),
+                                particle_properties);
+
+        particle->set_properties(particle_properties);
+      }
+
+
+
+      template <int dim>
+      void
+      Manager<dim>::initialize_one_particle (const Point<dim> &position,
+                                             std::vector<double> &particle_properties) const
+      {
+        particle_properties.clear();
         particle_properties.reserve(property_information.n_components());
 
         for (const auto &p : property_list)
           {
-            p->initialize_one_particle_property(particle->get_location(),
+            p->initialize_one_particle_property(position,
                                                 particle_properties);
           }
 
@@ -342,8 +356,6 @@ namespace aspect
                           "to the number of particle properties that were initialized by "
                           "the property plugins. Check the selected property plugins for "
                           "consistency between reported size and actually set properties."));
-
-        particle->set_properties(particle_properties);
       }
 
 
@@ -0,0 +1,290 @@
+/*
+  Copyright (C) 2020 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <aspect/particle/tensor_product_evaluator.h>
+
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_dgq.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace aspect
+{
+  namespace Particle
+  {
+    namespace internal
+    {
+      namespace
+      {
+        /**
+         * Return the index of @p x in @p nodes, or numbers::invalid_unsigned_int
+         * if it is not one of the nodes.
+         */
+        unsigned int
+        find_node (const std::vector<double> &nodes,
+                   const double x)
+        {
+          for (unsigned int i=0; i<nodes.size(); ++i)
+            if (std::abs(nodes[i] - x) < 1e-10)
+              return i;
+          return numbers::invalid_unsigned_int;
+        }
+
+
+
+        /**
+         * Return the sorted one-dimensional support points of an element
+         * with tensor product structure, i.e., the distinct values of the
+         * first coordinate of all unit support points.
+         */
+        template <int dim>
+        std::vector<double>
+        get_nodes (const FiniteElement<dim> &fe)
+        {
+          std::vector<double> nodes;
+          for (const Point<dim> &p : fe.get_unit_support_points())
+            if (find_node(nodes, p[0]) == numbers::invalid_unsigned_int)
+              nodes.push_back(p[0]);
+
+          std::sort(nodes.begin(), nodes.end());
+          return nodes;
+        }
+      }
+
+
+
+      template <int dim>
+      bool
+      TensorProductEvaluator<dim>::is_supported (const FiniteElement<dim> &fe)
+      {
+        if (dynamic_cast<const FE_Q<dim>*>(&fe) == nullptr
+            &&
+            dynamic_cast<const FE_DGQ<dim>*>(&fe) == nullptr)
+          return false;
+
+        if (fe.n_components() != 1 || !fe.has_support_points())
+          return false;
+
+        // check that the support points form a tensor product grid
+        const std::vector<double> nodes = get_nodes(fe);
+        if (Utilities::fixed_power<dim>(nodes.size()) != fe.dofs_per_cell)
+          return false;
+
+        for (const Point<dim> &p : fe.get_unit_support_points())
+          for (unsigned int d=0; d<dim; ++d)
+            if (find_node(nodes, p[d]) == numbers::invalid_unsigned_int)
+              return false;
+
+        return true;
+      }
+
+
+
+      template <int dim>
+      TensorProductEvaluator<dim>::TensorProductEvaluator (const FiniteElement<dim> &fe)
+        :
+        nodes (get_nodes(fe)),
+        weights (nodes.size(), 1.0),
+        lexicographic_index (fe.dofs_per_cell)
+      {
+        Assert (is_supported(fe),
+                ExcMessage("The TensorProductEvaluator class does not support the element "
+                           + fe.get_name() + "."));
+
+        for (unsigned int i=0; i<nodes.size(); ++i)
+          {
+            for (unsigned int j=0; j<nodes.size(); ++j)
+              if (j != i)
+                weights[i] *= nodes[i] - nodes[j];
+            weights[i] = 1.0 / weights[i];
+          }
+
+        const std::vector<Point<dim> > &support_points = fe.get_unit_support_points();
+        for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+          {
+            unsigned int index = 0;
+            for (int d=dim-1; d>=0; --d)
+              index = index * nodes.size() + find_node(nodes, support_points[i][d]);
+            lexicographic_index[i] = index;
+          }
+      }
+
+
+
+      template <int dim>
+      unsigned int
+      TensorProductEvaluator<dim>::n_dofs_per_cell () const
+      {
+        return lexicographic_index.size();
+      }
+
+
+
+      template <int dim>
+      void
+      TensorProductEvaluator<dim>::evaluate (const unsigned int n_components,
+                                             const std::vector<double> &dof_values,
+                                             const std::vector<Point<dim> > &points,
+                                             std::vector<double> &values,
+                                             std::vector<Tensor<1,dim> > *gradients) const
+      {
+        const unsigned int n_nodes = nodes.size();
+        const unsigned int n_dofs = lexicographic_index.size();
+        const unsigned int n_lanes = VectorizedArray<double>::size();
+        const unsigned int n_points = points.size();
+
+        Assert (dof_values.size() == n_components * n_dofs,
+                ExcDimensionMismatch(dof_values.size(), n_components * n_dofs));
+
+        values.resize(n_points * n_components);
+        if (gradients != nullptr)
+          gradients->resize(n_points * n_components);
+
+        // bring the coefficients into lexicographic order, so that the
+        // first coordinate runs fastest
+        std::vector<double> coefficients (n_components * n_dofs);
+        for (unsigned int c=0; c<n_components; ++c)
+          for (unsigned int i=0; i<n_dofs; ++i)
+            coefficients[c * n_dofs + lexicographic_index[i]] = dof_values[c * n_dofs + i];
+
+        // values and derivatives of the one-dimensional polynomials in
+        // each coordinate direction
+        std::vector<VectorizedArray<double> > shape (dim * n_nodes);
+        std::vector<VectorizedArray<double> > shape_derivative (dim * n_nodes);
+
+        for (unsigned int first_point=0; first_point<n_points; first_point+=n_lanes)
+          {
+            const unsigned int n_filled_lanes = std::min(n_lanes, n_points - first_point);
+
+            // Gather the coordinates of the points of this batch. Unused
+            // lanes repeat the last point, their results are discarded.
+            for (unsigned int d=0; d<dim; ++d)
+              {
+                VectorizedArray<double> x;
+                for (unsigned int v=0; v<n_lanes; ++v)
+                  x[v] = points[first_point + std::min(v, n_filled_lanes-1)][d];
+
+                // Evaluate the Lagrange polynomials
+                //   l_i(x) = w_i prod_{j!=i} (x-x_j)
+                // and their derivatives with the product rule.
+                for (unsigned int i=0; i<n_nodes; ++i)
+                  {
+                    VectorizedArray<double> value = make_vectorized_array(weights[i]);
+                    VectorizedArray<double> derivative = make_vectorized_array(0.);
+                    for (unsigned int j=0; j<n_nodes; ++j)
+                      if (j != i)
+                        {
+                          derivative = derivative * (x - nodes[j]) + value;
+                          value = value * (x - nodes[j]);
+                        }
+                    shape[d * n_nodes + i] = value;
+                    shape_derivative[d * n_nodes + i] = derivative;
+                  }
+              }
+
+            const VectorizedArray<double> *shape_x = &shape[0];
+            const VectorizedArray<double> *shape_y = &shape[n_nodes];
+            const VectorizedArray<double> *derivative_x = &shape_derivative[0];
+            const VectorizedArray<double> *derivative_y = &shape_derivative[n_nodes];
+
+            for (unsigned int c=0; c<n_components; ++c)
+              {
+                const double *component_coefficients = &coefficients[c * n_dofs];
+
+                // Sum factorization: first contract the coefficients in x
+                // direction, then in y direction, and in 3d in z direction.
+                VectorizedArray<double> value = make_vectorized_array(0.);
+                Tensor<1,dim,VectorizedArray<double> > gradient;
+
+                const unsigned int n_z = (dim == 3 ? n_nodes : 1);
+                for (unsigned int iz=0; iz<n_z; ++iz)
+                  {
+                    VectorizedArray<double> value_xy = make_vectorized_array(0.);
+                    VectorizedArray<double> gradient_x_xy = make_vectorized_array(0.);
+                    VectorizedArray<double> gradient_y_xy = make_vectorized_array(0.);
+
+                    for (unsigned int iy=0; iy<n_nodes; ++iy)
+                      {
+                        const double *line = component_coefficients + (iz * n_nodes + iy) * n_nodes;
+
+                        VectorizedArray<double> value_x = make_vectorized_array(0.);
+                        VectorizedArray<double> gradient_x = make_vectorized_array(0.);
+                        for (unsigned int ix=0; ix<n_nodes; ++ix)
+                          {
+                            value_x += line[ix] * shape_x[ix];
+                            gradient_x += line[ix] * derivative_x[ix];
+                          }
+
+                        value_xy += value_x * shape_y[iy];
+                        gradient_x_xy += gradient_x * shape_y[iy];
+                        gradient_y_xy += value_x * derivative_y[iy];
+                      }
+
+                    if (dim == 3)
+                      {
+                        const VectorizedArray<double> shape_z = shape[2 * n_nodes + iz];
+                        value += value_xy * shape_z;
+                        gradient[0] += gradient_x_xy * shape_z;
+                        gradient[1] += gradient_y_xy * shape_z;
+                        gradient[dim-1] += value_xy * shape_derivative[2 * n_nodes + iz];
+                      }
+                    else
+                      {
+                        value = value_xy;
+                        gradient[0] = gradient_x_xy;
+                        gradient[1] = gradient_y_xy;
+                      }
+                  }
+
+                for (unsigned int v=0; v<n_filled_lanes; ++v)
+                  {
+                    values[(first_point + v) * n_components + c] = value[v];
+
+                    if (gradients != nullptr)
+                      for (unsigned int d=0; d<dim; ++d)
+                        (*gradients)[(first_point + v) * n_components + c][d] = gradient[d][v];
+                  }
+              }
+          }
+      }
+    }
+  }
+}
+
+
+// explicit instantiations
+namespace aspect
+{
+  namespace Particle
+  {
+    namespace internal
+    {
+#define INSTANTIATE(dim) \
+  template class TensorProductEvaluator<dim>;
+
+      ASPECT_INSTANTIATE(INSTANTIATE)
+
+#undef INSTANTIATE
+    }
+  }
+}
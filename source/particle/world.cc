@@ -27,6 +27,8 @@
 #include <aspect/citation_info.h>
 
 #include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/work_stream.h>
+#include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/grid/grid_tools.h>
 #include <boost/serialization/map.hpp>
@@ -517,17 +519,24 @@ namespace aspect
     template <int dim>
     void
     World<dim>::local_initialize_particles(const typename ParticleHandler<dim>::particle_iterator &begin_particle,
-                                           const typename ParticleHandler<dim>::particle_iterator &end_particle)
+                                           const typename ParticleHandler<dim>::particle_iterator &end_particle,
+                                           internal::ParticleCopyData<dim> &data) const
     {
-      for (typename ParticleHandler<dim>::particle_iterator it = begin_particle; it!=end_particle; ++it)
-        property_manager->initialize_one_particle(it);
+      data.properties.resize(std::distance(begin_particle,end_particle));
+
+      typename ParticleHandler<dim>::particle_iterator it = begin_particle;
+      for (unsigned int i = 0; it!=end_particle; ++it,++i)
+        property_manager->initialize_one_particle(it->get_location(),
+                                                  data.properties[i]);
     }
 
     template <int dim>
     void
     World<dim>::local_update_particles(const typename DoFHandler<dim>::active_cell_iterator &cell,
                                        const typename ParticleHandler<dim>::particle_iterator &begin_particle,
-                                       const typename ParticleHandler<dim>::particle_iterator &end_particle)
+                                       const typename ParticleHandler<dim>::particle_iterator &end_particle,
+                                       internal::ParticleScratchData<dim> &scratch,
+                                       internal::ParticleCopyData<dim> &data) const
     {
       const unsigned int particles_in_cell = std::distance(begin_particle,end_particle);
       const unsigned int solution_components = this->introspection().n_components;
@@ -535,9 +544,13 @@ namespace aspect
       Vector<double>              value (solution_components);
       std::vector<Tensor<1,dim> > gradient (solution_components,Tensor<1,dim>());
 
-      std::vector<Vector<double> >              values(particles_in_cell,value);
-      std::vector<std::vector<Tensor<1,dim> > > gradients(particles_in_cell,gradient);
-      std::vector<Point<dim> >                  positions(particles_in_cell);
+      std::vector<Vector<double> >              &values = data.values;
+      std::vector<std::vector<Tensor<1,dim> > > &gradients = data.gradients;
+      std::vector<Point<dim> >                  &positions = scratch.reference_locations;
+
+      values.assign(particles_in_cell,value);
+      gradients.assign(particles_in_cell,gradient);
+      positions.resize(particles_in_cell);
 
       typename ParticleHandler<dim>::particle_iterator it = begin_particle;
       for (unsigned int i = 0; it!=end_particle; ++it,++i)
@@ -547,6 +560,73 @@ namespace aspect
 
       const Quadrature<dim> quadrature_formula(positions);
       const UpdateFlags update_flags = property_manager->get_needed_update_flags();
+
+      // If all base elements have a tensor product structure, evaluate the
+      // solution with the (much cheaper) TensorProductEvaluator objects. We
+      // still need an FEValues object for the inverse Jacobians of the
+      // mapping to compute gradients, but it does not need to compute
+      // any shape functions.
+      if (std::find(solution_evaluators.begin(), solution_evaluators.end(), nullptr) == solution_evaluators.end())
+        {
+          const FiniteElement<dim> &fe = this->get_fe();
+
+          std::vector<types::global_dof_index> &cell_dof_indices = scratch.cell_dof_indices;
+          cell_dof_indices.resize (fe.dofs_per_cell);
+          cell->get_dof_indices (cell_dof_indices);
+
+          const bool compute_gradients = (update_flags & update_gradients);
+
+          for (unsigned int c=0; c<solution_components; ++c)
+            {
+              const internal::TensorProductEvaluator<dim> &evaluator
+                = *solution_evaluators[fe.component_to_base_index(c).first.first];
+
+              scratch.dof_values.resize(evaluator.n_dofs_per_cell());
+              for (unsigned int j=0; j<evaluator.n_dofs_per_cell(); ++j)
+                scratch.dof_values[j] = this->get_solution()[cell_dof_indices[fe.component_to_system_index(c,j)]];
+
+              evaluator.evaluate(1,
+                                 scratch.dof_values,
+                                 positions,
+                                 scratch.values,
+                                 compute_gradients ? &scratch.gradients : nullptr);
+
+              for (unsigned int i=0; i<particles_in_cell; ++i)
+                values[i][c] = scratch.values[i];
+
+              if (compute_gradients)
+                for (unsigned int i=0; i<particles_in_cell; ++i)
+                  gradients[i][c] = scratch.gradients[i];
+            }
+
+          if (compute_gradients)
+            {
+              FEValues<dim> fe_value (this->get_mapping(),
+                                      fe,
+                                      quadrature_formula,
+                                      update_inverse_jacobians);
+              fe_value.reinit (cell);
+
+              // transform the gradients from reference to real coordinates
+              for (unsigned int i=0; i<particles_in_cell; ++i)
+                {
+                  const DerivativeForm<1,dim,dim> inverse_jacobian = fe_value.inverse_jacobian(i);
+                  for (unsigned int c=0; c<solution_components; ++c)
+                    {
+                      const Tensor<1,dim> reference_gradient = gradients[i][c];
+                      for (unsigned int d=0; d<dim; ++d)
+                        {
+                          gradients[i][c][d] = 0;
+                          for (unsigned int e=0; e<dim; ++e)
+                            gradients[i][c][d] += reference_gradient[e] * inverse_jacobian[e][d];
+                        }
+                    }
+                }
+            }
+
+          return;
+        }
+
       FEValues<dim> fe_value (this->get_mapping(),
                               this->get_fe(),
                               quadrature_formula,
@@ -559,26 +639,23 @@ namespace aspect
       if (update_flags & update_gradients)
         fe_value.get_function_gradients (this->get_solution(),
                                          gradients);
-
-      it = begin_particle;
-      for (unsigned int i = 0; it!=end_particle; ++it,++i)
-        {
-          property_manager->update_one_particle(it,
-                                                values[i],
-                                                gradients[i]);
-        }
     }
 
     template <int dim>
     void
     World<dim>::local_advect_particles(const typename DoFHandler<dim>::active_cell_iterator &cell,
                                        const typename ParticleHandler<dim>::particle_iterator &begin_particle,
-                                       const typename ParticleHandler<dim>::particle_iterator &end_particle)
+                                       const typename ParticleHandler<dim>::particle_iterator &end_particle,
+                                       internal::ParticleScratchData<dim> &scratch,
+                                       internal::ParticleCopyData<dim> &data) const
     {
       const unsigned int particles_in_cell = std::distance(begin_particle,end_particle);
 
-      std::vector<Tensor<1,dim> >  velocity(particles_in_cell);
-      std::vector<Tensor<1,dim> >  old_velocity(particles_in_cell);
+      std::vector<Tensor<1,dim> >  &velocity = data.velocities;
+      std::vector<Tensor<1,dim> >  &old_velocity = data.old_velocities;
+
+      velocity.assign(particles_in_cell, Tensor<1,dim>());
+      old_velocity.assign(particles_in_cell, Tensor<1,dim>());
 
       // Below we manually evaluate the solution at all support points of the
       // current cell, and then use the shape functions to interpolate the
@@ -588,7 +665,8 @@ namespace aspect
       // for other cells, it is much faster to do the work manually. Also this
       // function is quite performance critical.
 
-      std::vector<types::global_dof_index> cell_dof_indices (this->get_fe().dofs_per_cell);
+      std::vector<types::global_dof_index> &cell_dof_indices = scratch.cell_dof_indices;
+      cell_dof_indices.resize (this->get_fe().dofs_per_cell);
       cell->get_dof_indices (cell_dof_indices);
 
       const FiniteElement<dim> &velocity_fe = this->get_fe().base_element(this->introspection()
@@ -602,6 +680,57 @@ namespace aspect
                                                   :
                                                   numbers::invalid_unsigned_int);
 
+      // If possible, evaluate the current and old velocity at all particles
+      // at once with sum factorization. If melt transport is used, all
+      // particles move with the fluid velocity (the melt FE uses the same
+      // base element as the solid velocity).
+      const internal::TensorProductEvaluator<dim> *velocity_evaluator
+        = solution_evaluators[this->introspection().base_elements.velocities].get();
+
+      if (velocity_evaluator != nullptr)
+        {
+          const unsigned int n_velocity_dofs = velocity_fe.dofs_per_cell;
+
+          scratch.reference_locations.resize(particles_in_cell);
+          typename ParticleHandler<dim>::particle_iterator it = begin_particle;
+          for (unsigned int particle_index = 0; it!=end_particle; ++it,++particle_index)
+            scratch.reference_locations[particle_index] = it->get_reference_location();
+
+          // the first dim components are the current, the next dim
+          // components the old velocity
+          scratch.dof_values.resize(2 * dim * n_velocity_dofs);
+          for (unsigned int dir=0; dir<dim; ++dir)
+            {
+              const unsigned int component = (compute_fluid_velocity ?
+                                              fluid_component_index + dir
+                                              :
+                                              this->introspection().component_indices.velocities[dir]);
+
+              for (unsigned int j=0; j<n_velocity_dofs; ++j)
+                {
+                  const types::global_dof_index dof_index
+                    = cell_dof_indices[this->get_fe().component_to_system_index(component,j)];
+
+                  scratch.dof_values[dir * n_velocity_dofs + j] = this->get_solution()[dof_index];
+                  scratch.dof_values[(dim + dir) * n_velocity_dofs + j] = this->get_old_solution()[dof_index];
+                }
+            }
+
+          velocity_evaluator->evaluate(2 * dim,
+                                       scratch.dof_values,
+                                       scratch.reference_locations,
+                                       scratch.values);
+
+          for (unsigned int particle_index = 0; particle_index<particles_in_cell; ++particle_index)
+            for (unsigned int dir=0; dir<dim; ++dir)
+              {
+                velocity[particle_index][dir] = scratch.values[particle_index * 2 * dim + dir];
+                old_velocity[particle_index][dir] = scratch.values[particle_index * 2 * dim + dim + dir];
+              }
+
+          return;
+        }
+
       // In regions without melt, the fluid velocity equals the solid velocity, so we can use it for all particles.
       std::vector<bool> use_fluid_velocity((compute_fluid_velocity ?
                                             particles_in_cell
@@ -654,12 +783,39 @@ namespace aspect
                 }
             }
         }
+    }
 
-      integrator->local_integrate_step(begin_particle,
-                                       end_particle,
-                                       old_velocity,
-                                       velocity,
-                                       this->get_timestep());
+    template <int dim>
+    void
+    World<dim>::setup_solution_evaluators()
+    {
+      if (!solution_evaluators.empty())
+        return;
+
+      const FiniteElement<dim> &fe = this->get_fe();
+      solution_evaluators.resize(fe.n_base_elements());
+      for (unsigned int b=0; b<fe.n_base_elements(); ++b)
+        if (internal::TensorProductEvaluator<dim>::is_supported(fe.base_element(b)))
+          solution_evaluators[b] = std_cxx14::make_unique<internal::TensorProductEvaluator<dim> >(fe.base_element(b));
+    }
+
+    template <int dim>
+    template <typename Worker, typename Copier>
+    void
+    World<dim>::run_cell_loop(const Worker &worker,
+                              const Copier &copier) const
+    {
+      using CellFilter = FilteredIterator<typename DoFHandler<dim>::active_cell_iterator>;
+
+      WorkStream::
+      run (CellFilter (IteratorFilters::LocallyOwnedCell(),
+                       this->get_dof_handler().begin_active()),
+           CellFilter (IteratorFilters::LocallyOwnedCell(),
+                       this->get_dof_handler().end()),
+           worker,
+           copier,
+           internal::ParticleScratchData<dim>(),
+           internal::ParticleCopyData<dim>());
     }
 
     template <int dim>
@@ -706,25 +862,40 @@ namespace aspect
         particle->set_property_pool(particle_handler->get_property_pool());
 
 
-      // TODO: Change this loop over all cells to use the WorkStream interface
       if (property_manager->get_n_property_components() > 0)
         {
           TimerOutput::Scope timer_section(this->get_computing_timer(), "Particles: Initialize properties");
 
           particle_handler->get_property_pool().reserve(2 * particle_handler->n_locally_owned_particles());
 
-          // Loop over all cells and initialize the particles cell-wise
-          for (const auto &cell : this->get_dof_handler().active_cell_iterators())
-            if (cell->is_locally_owned())
-              {
-                typename ParticleHandler<dim>::particle_iterator_range
-                particles_in_cell = particle_handler->particles_in_cell(cell);
+          // Loop over all cells and compute the initial properties cell-wise
+          // in parallel, then store them in the particles one cell after the
+          // other, because this accesses the property pool.
+          auto worker = [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                            internal::ParticleScratchData<dim> &,
+                            internal::ParticleCopyData<dim> &data)
+          {
+            const typename ParticleHandler<dim>::particle_iterator_range
+            particles_in_cell = particle_handler->particles_in_cell(cell);
 
-                // Only initialize particles, if there are any in this cell
-                if (particles_in_cell.begin() != particles_in_cell.end())
-                  local_initialize_particles(particles_in_cell.begin(),
-                                             particles_in_cell.end());
-              }
+            data.begin_particle = particles_in_cell.begin();
+            data.end_particle = particles_in_cell.end();
+
+            // Only initialize particles, if there are any in this cell
+            if (data.begin_particle != data.end_particle)
+              local_initialize_particles(data.begin_particle,
+                                         data.end_particle,
+                                         data);
+          };
+
+          auto copier = [&](const internal::ParticleCopyData<dim> &data)
+          {
+            typename ParticleHandler<dim>::particle_iterator it = data.begin_particle;
+            for (unsigned int i = 0; it!=data.end_particle; ++it,++i)
+              it->set_properties(data.properties[i]);
+          };
+
+          run_cell_loop(worker, copier);
           if (update_ghost_particles &&
               dealii::Utilities::MPI::n_mpi_processes(this->get_mpi_communicator()) > 1)
             {
@@ -738,25 +909,44 @@ namespace aspect
     void
     World<dim>::update_particles()
     {
-      // TODO: Change this loop over all cells to use the WorkStream interface
-
       if (property_manager->get_n_property_components() > 0)
         {
           TimerOutput::Scope timer_section(this->get_computing_timer(), "Particles: Update properties");
 
-          // Loop over all cells and update the particles cell-wise
-          for (const auto &cell : this->get_dof_handler().active_cell_iterators())
-            if (cell->is_locally_owned())
-              {
-                typename ParticleHandler<dim>::particle_iterator_range
-                particles_in_cell = particle_handler->particles_in_cell(cell);
-
-                // Only update particles, if there are any in this cell
-                if (particles_in_cell.begin() != particles_in_cell.end())
-                  local_update_particles(cell,
-                                         particles_in_cell.begin(),
-                                         particles_in_cell.end());
-              }
+          setup_solution_evaluators();
+
+          // Loop over all cells and evaluate the solution at the particle
+          // locations cell-wise in parallel, then let the property plugins
+          // update the particles one cell after the other.
+          auto worker = [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                            internal::ParticleScratchData<dim> &scratch,
+                            internal::ParticleCopyData<dim> &data)
+          {
+            const typename ParticleHandler<dim>::particle_iterator_range
+            particles_in_cell = particle_handler->particles_in_cell(cell);
+
+            data.begin_particle = particles_in_cell.begin();
+            data.end_particle = particles_in_cell.end();
+
+            // Only update particles, if there are any in this cell
+            if (data.begin_particle != data.end_particle)
+              local_update_particles(cell,
+                                     data.begin_particle,
+                                     data.end_particle,
+                                     scratch,
+                                     data);
+          };
+
+          auto copier = [&](const internal::ParticleCopyData<dim> &data)
+          {
+            typename ParticleHandler<dim>::particle_iterator it = data.begin_particle;
+            for (unsigned int i = 0; it!=data.end_particle; ++it,++i)
+              property_manager->update_one_particle(it,
+                                                    data.values[i],
+                                                    data.gradients[i]);
+          };
+
+          run_cell_loop(worker, copier);
         }
     }
 
@@ -765,22 +955,44 @@ namespace aspect
     World<dim>::advect_particles()
     {
       {
-        // TODO: Change this loop over all cells to use the WorkStream interface
         TimerOutput::Scope timer_section(this->get_computing_timer(), "Particles: Advect");
 
-        // Loop over all cells and advect the particles cell-wise
-        for (const auto &cell : this->get_dof_handler().active_cell_iterators())
-          if (cell->is_locally_owned())
-            {
-              const typename ParticleHandler<dim>::particle_iterator_range
-              particles_in_cell = particle_handler->particles_in_cell(cell);
-
-              // Only advect particles, if there are any in this cell
-              if (particles_in_cell.begin() != particles_in_cell.end())
-                local_advect_particles(cell,
-                                       particles_in_cell.begin(),
-                                       particles_in_cell.end());
-            }
+        setup_solution_evaluators();
+
+        // Loop over all cells and compute the velocities at the particle
+        // locations cell-wise in parallel, then advect the particles one cell
+        // after the other. The integrators store data for every particle
+        // and are not thread-safe.
+        auto worker = [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+                          internal::ParticleScratchData<dim> &scratch,
+                          internal::ParticleCopyData<dim> &data)
+        {
+          const typename ParticleHandler<dim>::particle_iterator_range
+          particles_in_cell = particle_handler->particles_in_cell(cell);
+
+          data.begin_particle = particles_in_cell.begin();
+          data.end_particle = particles_in_cell.end();
+
+          // Only advect particles, if there are any in this cell
+          if (data.begin_particle != data.end_particle)
+            local_advect_particles(cell,
+                                   data.begin_particle,
+                                   data.end_particle,
+                                   scratch,
+                                   data);
+        };
+
+        auto copier = [&](const internal::ParticleCopyData<dim> &data)
+        {
+          if (data.begin_particle != data.end_particle)
+            integrator->local_integrate_step(data.begin_particle,
+                                             data.end_particle,
+                                             data.old_velocities,
+                                             data.velocities,
+                                             this->get_timestep());
+        };
+
+        run_cell_loop(worker, copier);
 
         // If particles fell out of the mesh, put them back in if they have crossed
         // a periodic boundary. If they have left the mesh otherwise, they will be
@@ -70,7 +70,7 @@ namespace aspect
           for (unsigned int c = 0; c < this->n_compositional_fields(); ++c)
             in.composition[0][c] = 0.0;
 
-          this->get_material_model().evaluate(in, out);
+          this->evaluate_material_model(in, out);
 
           const double thermal_diffusivity = ( (this->get_parameters().formulation_temperature_equation ==
                                                 Parameters<dim>::Formulation::TemperatureEquation::reference_density_profile)
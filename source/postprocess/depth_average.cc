@@ -33,7 +33,9 @@
 #include <deal.II/numerics/data_out_stack.h>
 
 
+#include <fstream>
 #include <math.h>
+#include <sstream>
 
 namespace aspect
 {
@@ -78,7 +80,10 @@ namespace aspect
       // initialize this to a nonsensical value; set it to the actual time
       // the first time around we get to check it
       last_output_time (std::numeric_limits<double>::quiet_NaN()),
-      n_depth_zones (numbers::invalid_unsigned_int)
+      n_depth_zones (numbers::invalid_unsigned_int),
+      append_output (false),
+      txt_output_size (0),
+      txt_output_file_initialized (false)
     {}
 
 
@@ -221,32 +226,66 @@ namespace aspect
                                              "> did not succeed in the `point values' "
                                              "postprocessor."));
                 }
+              else if (append_output)
+                {
+                  const std::string filename (this->get_output_directory() + "depth_average.txt");
+
+                  // Write the new data point into a string first, so that we know how
+                  // much we have written to the file.
+                  std::ostringstream new_output;
+                  std::ofstream f;
+                  if (txt_output_file_initialized == false)
+                    {
+                      // This is the first time we write to the file in this run. If we
+                      // have resumed from a checkpoint, keep what was written to the file
+                      // up to the checkpoint, but discard anything that was written later.
+                      // Otherwise, start a new file.
+                      std::string previous_output (txt_output_size, '\0');
+                      if (txt_output_size > 0)
+                        {
+                          std::ifstream in (filename.c_str(), std::ios::binary);
+                          in.read (&previous_output[0], previous_output.size());
+                          AssertThrow (in, ExcMessage("Could not read the first " + Utilities::to_string(txt_output_size) +
+                                                      " bytes of <" + filename + ">, which is necessary to append "
+                                                      "to this file after resuming from a checkpoint."));
+                        }
+                      else
+                        write_txt_header (new_output);
+
+                      f.open (filename.c_str(), std::ios::out | std::ios::binary);
+                      f << previous_output;
+                      txt_output_file_initialized = true;
+                    }
+                  else
+                    f.open (filename.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+
+                  // If we start a new file, write all entries we have. This is
+                  // more than the most recent one only if we resumed from a
+                  // checkpoint that was created without 'Append output'.
+                  if (txt_output_size == 0)
+                    for (const auto &point : entries)
+                      write_txt_data_point (new_output, point);
+                  else
+                    write_txt_data_point (new_output, entries.back());
+
+                  const std::string new_output_string = new_output.str();
+                  f << new_output_string;
+                  txt_output_size += new_output_string.size();
+
+                  AssertThrow (f, ExcMessage("Writing data to <" + filename +
+                                             "> did not succeed in the `depth average' "
+                                             "postprocessor."));
+                }
               else
                 {
                   const std::string filename (this->get_output_directory() + "depth_average.txt");
                   std::ofstream f(filename.c_str(), std::ofstream::out);
 
-                  // Write the header
-                  f << "#       time" << "        depth";
-                  for ( unsigned int i = 0; i < variables.size(); ++i)
-                    f << " " << variables[i];
-                  f << std::endl;
+                  write_txt_header (f);
 
                   // Output each data point in the entries object
                   for (const auto &point : entries)
-                    {
-                      double depth = max_depth/static_cast<double>(point.values[0].size())/2.0;
-                      for (unsigned int d = 0; d < point.values[0].size(); ++d)
-                        {
-                          f << std::setw(12)
-                            << (this->convert_output_to_years() ? point.time/year_in_seconds : point.time)
-                            << ' ' << std::setw(12) << depth;
-                          for ( unsigned int i = 0; i < variables.size(); ++i )
-                            f << ' ' << std::setw(12) << point.values[i][d];
-                          f << std::endl;
-                          depth+= max_depth/static_cast<double>(point.values[0].size() );
-                        }
-                    }
+                    write_txt_data_point (f, point);
 
                   AssertThrow (f, ExcMessage("Writing data to <" + filename +
                                              "> did not succeed in the `point values' "
@@ -255,6 +294,10 @@ namespace aspect
             }
         }
 
+      // If we append to the output file, we only need to keep the most recent entry
+      if (append_output)
+        entries.erase (entries.begin(), entries.end()-1);
+
       set_last_output_time (this->get_time());
 
       // return what should be printed to the screen. note that we had
@@ -264,6 +307,39 @@ namespace aspect
     }
 
 
+    template <int dim>
+    void
+    DepthAverage<dim>::write_txt_header (std::ostream &out) const
+    {
+      out << "#       time" << "        depth";
+      for (unsigned int i = 0; i < variables.size(); ++i)
+        out << " " << variables[i];
+      out << std::endl;
+    }
+
+
+
+    template <int dim>
+    void
+    DepthAverage<dim>::write_txt_data_point (std::ostream &out,
+                                             const DataPoint &data_point) const
+    {
+      const double max_depth = this->get_geometry_model().maximal_depth();
+
+      double depth = max_depth/static_cast<double>(data_point.values[0].size())/2.0;
+      for (unsigned int d = 0; d < data_point.values[0].size(); ++d)
+        {
+          out << std::setw(12)
+              << (this->convert_output_to_years() ? data_point.time/year_in_seconds : data_point.time)
+              << ' ' << std::setw(12) << depth;
+          for (unsigned int i = 0; i < variables.size(); ++i)
+            out << ' ' << std::setw(12) << data_point.values[i][d];
+          out << std::endl;
+          depth+= max_depth/static_cast<double>(data_point.values[0].size());
+        }
+    }
+
+
     template <int dim>
     void
     DepthAverage<dim>::declare_parameters (ParameterHandler &prm)
@@ -301,6 +377,17 @@ namespace aspect
                              "the current parameter is described. By default the output "
                              "is written as gnuplot file (for plotting), and as a simple "
                              "text file.");
+          prm.declare_entry ("Append output", "false",
+                             Patterns::Bool(),
+                             "Whether to append the depth averages of each output time to the "
+                             "output file, rather than rewriting the averages of all previous "
+                             "output times every time output is generated. If this is set, only "
+                             "the most recent averages are kept in memory and stored in checkpoints, "
+                             "so that the cost of writing output and checkpoints does not grow over "
+                             "the course of a long model run. After resuming from a checkpoint, "
+                             "anything that was written to the file after the checkpoint was "
+                             "created is discarded. Appending is only supported for the "
+                             "'txt' output format.");
           const std::string variables =
             "all|temperature|composition|"
             "adiabatic temperature|adiabatic pressure|adiabatic density|adiabatic density derivative|"
@@ -425,6 +512,15 @@ namespace aspect
           }
 
           output_formats = Utilities::split_string_list(prm.get("Output format"));
+
+          append_output = prm.get_bool("Append output");
+          if (append_output)
+            for (const auto &output_format : output_formats)
+              AssertThrow (output_format == "txt",
+                           ExcMessage("The 'Depth average' postprocessor can only append to "
+                                      "output files in the 'txt' output format, but you also "
+                                      "requested the format <" + output_format + ">. Please set "
+                                      "'Output format' to 'txt', or disable 'Append output'."));
         }
         prm.leave_subsection();
       }
@@ -434,10 +530,17 @@ namespace aspect
 
     template <int dim>
     template <class Archive>
-    void DepthAverage<dim>::serialize (Archive &ar, const unsigned int)
+    void DepthAverage<dim>::serialize (Archive &ar, const unsigned int version)
     {
       ar &last_output_time
       & entries;
+
+      // Checkpoints created before the 'Append output' parameter existed
+      // (class version 0) do not contain the size of the output file.
+      if (version > 0)
+        ar &txt_output_size;
+      else
+        txt_output_size = 0;
     }
 
 
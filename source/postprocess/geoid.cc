@@ -36,45 +36,65 @@ namespace aspect
 {
   namespace Postprocess
   {
+    namespace
+    {
+      /**
+       * Sum the given spherical harmonic coefficients over all processes
+       * in a single reduction.
+       */
+      void
+      sum_spherical_harmonic_coefficients (const std::vector<std::vector<double> *> &coefficients,
+                                           const MPI_Comm &mpi_communicator)
+      {
+        std::vector<double> all_coefficients;
+        for (const std::vector<double> *c : coefficients)
+          all_coefficients.insert (all_coefficients.end(), c->begin(), c->end());
+
+        dealii::Utilities::MPI::sum (all_coefficients, mpi_communicator, all_coefficients);
+
+        std::vector<double>::const_iterator next = all_coefficients.begin();
+        for (std::vector<double> *c : coefficients)
+          {
+            std::copy (next, next + c->size(), c->begin());
+            next += c->size();
+          }
+      }
+    }
+
+
+
     template <int dim>
     std::pair<std::vector<double>,std::vector<double> >
     Geoid<dim>::to_spherical_harmonic_coefficients(const std::vector<std::vector<double> > &spherical_function) const
     {
-      std::vector<double> cosi(spherical_function.size(),0);
-      std::vector<double> sini(spherical_function.size(),0);
-      std::vector<double> coecos;
-      std::vector<double> coesin;
-
-      for (unsigned int ideg =  min_degree; ideg < max_degree+1; ideg++)
+      const unsigned int n_coefficients = (max_degree+1)*(max_degree+2)/2 - min_degree*(min_degree+1)/2;
+      std::vector<double> coecos(n_coefficients, 0.);
+      std::vector<double> coesin(n_coefficients, 0.);
+
+      // do the spherical harmonic expansion: compute all spherical harmonics
+      // at each spherical infinitesimal at once, and integrate its
+      // contribution to all coefficients
+      std::vector<std::vector<double> > cosine_components;
+      std::vector<std::vector<double> > sine_components;
+      for (unsigned int ds_num = 0; ds_num < spherical_function.size(); ds_num++)
         {
-          for (unsigned int iord = 0; iord < ideg+1; iord++)
-            {
-              // do the spherical harmonic expansion
-              for (unsigned int ds_num = 0; ds_num < spherical_function.size(); ds_num++)
-                {
-                  // normalization after Dahlen and Tromp, 1986, Appendix B.6
-                  const std::pair<double,double> sph_harm_vals = aspect::Utilities::real_spherical_harmonic(ideg,iord,spherical_function.at(ds_num).at(0),spherical_function.at(ds_num).at(1));
-                  const double cos_component = sph_harm_vals.first; // real / cos part
-                  const double sin_component = sph_harm_vals.second; // imaginary / sine part
-
-                  cosi.at(ds_num) = (spherical_function.at(ds_num).at(3) * cos_component);
-                  sini.at(ds_num) = (spherical_function.at(ds_num).at(3) * sin_component);
-                }
-              // integrate the contribution of each spherical infinitesimal
-              double cosii = 0;
-              double sinii = 0;
-              for (unsigned int ds_num = 0; ds_num < spherical_function.size(); ds_num++)
-                {
-                  cosii += cosi.at(ds_num) * spherical_function.at(ds_num).at(2);
-                  sinii += sini.at(ds_num) * spherical_function.at(ds_num).at(2);
-                }
-              coecos.push_back(cosii);
-              coesin.push_back(sinii);
-            }
+          // normalization after Dahlen and Tromp, 1986, Appendix B.6
+          aspect::Utilities::real_spherical_harmonics(max_degree,
+                                                      spherical_function[ds_num][0],
+                                                      spherical_function[ds_num][1],
+                                                      cosine_components,
+                                                      sine_components);
+
+          const double function_value = spherical_function[ds_num][3];
+          const double area = spherical_function[ds_num][2];
+          unsigned int ind = 0;
+          for (unsigned int ideg =  min_degree; ideg < max_degree+1; ideg++)
+            for (unsigned int iord = 0; iord < ideg+1; iord++, ++ind)
+              {
+                coecos[ind] += function_value * cosine_components[ideg][iord] * area;
+                coesin[ind] += function_value * sine_components[ideg][iord] * area;
+              }
         }
-      // sum over each processor
-      dealii::Utilities::MPI::sum (coecos,this->get_mpi_communicator(),coecos);
-      dealii::Utilities::MPI::sum (coesin,this->get_mpi_communicator(),coesin);
 
       return std::make_pair(coecos,coesin);
     }
@@ -110,53 +130,59 @@ namespace aspect
       std::vector<std::vector<double> > composition_values (this->n_compositional_fields(),std::vector<double> (quadrature_formula.size()));
 
       // Directly do the global 3D integral over each quadrature point of every cell (different from traditional way to do layer integral).
-      // This work around ASPECT's adaptive mesh refinement feature.
-      std::vector<double> SH_density_coecos;
-      std::vector<double> SH_density_coesin;
-      for (unsigned int ideg =  min_degree; ideg < max_degree+1; ideg++)
-        {
-          for (unsigned int iord = 0; iord < ideg+1; iord++)
-            {
-              // initialization of the density contribution integral per degree, order.
-              double integrated_density_cos_component = 0;
-              double integrated_density_sin_component = 0;
+      // This work around ASPECT's adaptive mesh refinement feature. All coefficients are
+      // integrated in a single pass over the cells, so that the material model only needs
+      // to be evaluated once per cell.
+      const unsigned int n_coefficients = (max_degree+1)*(max_degree+2)/2 - min_degree*(min_degree+1)/2;
+      std::vector<double> SH_density_coecos(n_coefficients, 0.);
+      std::vector<double> SH_density_coesin(n_coefficients, 0.);
 
-              // loop over all of the cells
-              for (const auto &cell : this->get_dof_handler().active_cell_iterators())
-                if (cell->is_locally_owned())
-                  {
-                    fe_values.reinit (cell);
-                    // Set use_strain_rates to false since we don't need viscosity
-                    in.reinit(fe_values, cell, this->introspection(), this->get_solution(), false);
+      std::vector<std::vector<double> > cosine_components;
+      std::vector<std::vector<double> > sine_components;
 
-                    this->get_material_model().evaluate(in, out);
+      // loop over all of the cells
+      for (const auto &cell : this->get_dof_handler().active_cell_iterators())
+        if (cell->is_locally_owned())
+          {
+            fe_values.reinit (cell);
+            // Set use_strain_rates to false since we don't need viscosity
+            in.reinit(fe_values, cell, this->introspection(), this->get_solution(), false);
 
-                    // Compute the integral of the density function
-                    // over the cell, by looping over all quadrature points
-                    for (unsigned int q=0; q<quadrature_formula.size(); ++q)
-                      {
-                        // convert coordinates from [x,y,z] to [r, phi, theta]
-                        const std::array<double,3> scoord = aspect::Utilities::Coordinates::cartesian_to_spherical_coordinates(in.position[q]);
+            this->get_material_model().evaluate(in, out);
+
+            // Compute the integral of the density function
+            // over the cell, by looping over all quadrature points
+            for (unsigned int q=0; q<quadrature_formula.size(); ++q)
+              {
+                // convert coordinates from [x,y,z] to [r, phi, theta]
+                const std::array<double,3> scoord = aspect::Utilities::Coordinates::cartesian_to_spherical_coordinates(in.position[q]);
 
-                        // normalization after Dahlen and Tromp, 1986, Appendix B.6
-                        const std::pair<double,double> sph_harm_vals = aspect::Utilities::real_spherical_harmonic(ideg,iord,scoord[2],scoord[1]);
-                        const double cos_component = sph_harm_vals.first; // real / cos part
-                        const double sin_component = sph_harm_vals.second; // imaginary / sine part
+                // normalization after Dahlen and Tromp, 1986, Appendix B.6
+                aspect::Utilities::real_spherical_harmonics(max_degree, scoord[2], scoord[1],
+                                                            cosine_components, sine_components);
 
-                        const double density = out.densities[q];
-                        const double r_q = in.position[q].norm();
+                const double density = out.densities[q];
+                const double r_q = in.position[q].norm();
+                const double density_JxW = density * (1./r_q) * fe_values.JxW(q);
 
-                        integrated_density_cos_component += density * (1./r_q) * std::pow(r_q/outer_radius,ideg+1) * cos_component * fe_values.JxW(q);
-                        integrated_density_sin_component += density * (1./r_q) * std::pow(r_q/outer_radius,ideg+1) * sin_component * fe_values.JxW(q);
+                // the radial factor (r_q/outer_radius)^(ideg+1) is updated from one
+                // degree to the next
+                const double radius_ratio = r_q/outer_radius;
+                double radial_factor = std::pow(radius_ratio, min_degree+1);
+
+                unsigned int ind = 0;
+                for (unsigned int ideg =  min_degree; ideg < max_degree+1; ideg++)
+                  {
+                    const double weight = density_JxW * radial_factor;
+                    for (unsigned int iord = 0; iord < ideg+1; iord++, ++ind)
+                      {
+                        SH_density_coecos[ind] += weight * cosine_components[ideg][iord];
+                        SH_density_coesin[ind] += weight * sine_components[ideg][iord];
                       }
+                    radial_factor *= radius_ratio;
                   }
-              SH_density_coecos.push_back(integrated_density_cos_component);
-              SH_density_coesin.push_back(integrated_density_sin_component);
-            }
-        }
-      // sum over each processor
-      dealii::Utilities::MPI::sum (SH_density_coecos,this->get_mpi_communicator(),SH_density_coecos);
-      dealii::Utilities::MPI::sum (SH_density_coesin,this->get_mpi_communicator(),SH_density_coesin);
+              }
+          }
 
       return std::make_pair(SH_density_coecos,SH_density_coesin);
     }
@@ -364,6 +390,22 @@ namespace aspect
           CMB_delta_rho = density_below - SH_CMB_dyna_topo_coes.first;
         }
 
+      // The coefficients computed above only contain the contributions of
+      // the locally owned cells. Sum all of them over all processes at once.
+      {
+        std::vector<std::vector<double> *> coefficients = {&SH_density_coes.first,
+                                                           &SH_density_coes.second
+                                                          };
+        if (include_dynamic_topo_contribution == true)
+          {
+            coefficients.push_back(&SH_surface_dyna_topo_coes.second.first);
+            coefficients.push_back(&SH_surface_dyna_topo_coes.second.second);
+            coefficients.push_back(&SH_CMB_dyna_topo_coes.second.first);
+            coefficients.push_back(&SH_CMB_dyna_topo_coes.second.second);
+          }
+        sum_spherical_harmonic_coefficients (coefficients, this->get_mpi_communicator());
+      }
+
       // Compute the spherical harmonic coefficients of geoid anomaly
       std::vector<double> density_anomaly_contribution_coecos; // a vector to store cos terms of density anomaly contribution SH coefficients
       std::vector<double> density_anomaly_contribution_coesin; // a vector to store sin terms of density anomaly contribution SH coefficients
@@ -466,20 +508,24 @@ namespace aspect
 
       // Compute the grid geoid anomaly based on spherical harmonics
       std::vector<double> geoid_anomaly;
+      std::vector<std::vector<double> > cosine_components;
+      std::vector<std::vector<double> > sine_components;
       for (unsigned int i=0; i<surface_cell_spherical_coordinates.size(); ++i)
         {
+          // normalization after Dahlen and Tromp, 1986, Appendix B.6
+          aspect::Utilities::real_spherical_harmonics(max_degree,
+                                                      surface_cell_spherical_coordinates[i].first,
+                                                      surface_cell_spherical_coordinates[i].second,
+                                                      cosine_components,
+                                                      sine_components);
+
           int ind = 0;
           double geoid_value = 0;
           for (unsigned int ideg =  min_degree; ideg < max_degree+1; ideg++)
             {
               for (unsigned int iord = 0; iord < ideg+1; iord++)
                 {
-                  // normalization after Dahlen and Tromp, 1986, Appendix B.6
-                  const std::pair<double,double> sph_harm_vals = aspect::Utilities::real_spherical_harmonic(ideg,iord,surface_cell_spherical_coordinates.at(i).first,surface_cell_spherical_coordinates.at(i).second);
-                  const double cos_component = sph_harm_vals.first; // real / cos part
-                  const double sin_component = sph_harm_vals.second; // imaginary / sine part
-
-                  geoid_value += geoid_coecos.at(ind)*cos_component+geoid_coesin.at(ind)*sin_component;
+                  geoid_value += geoid_coecos.at(ind)*cosine_components[ideg][iord]+geoid_coesin.at(ind)*sine_components[ideg][iord];
                   ++ind;
                 }
             }
@@ -773,16 +819,21 @@ namespace aspect
 
           for (unsigned int i=0; i<surface_cell_spherical_coordinates.size(); ++i)
             {
+              // normalization after Dahlen and Tromp, 1986, Appendix B.6
+              aspect::Utilities::real_spherical_harmonics(max_degree,
+                                                          surface_cell_spherical_coordinates[i].first,
+                                                          surface_cell_spherical_coordinates[i].second,
+                                                          cosine_components,
+                                                          sine_components);
+
               int ind = 0;
               double gravity_value = 0;
               for (unsigned int ideg =  min_degree; ideg < max_degree+1; ++ideg)
                 {
                   for (unsigned int iord = 0; iord < ideg+1; ++iord)
                     {
-                      // normalization after Dahlen and Tromp, 1986, Appendix B.6
-                      const std::pair<double,double> sph_harm_vals = aspect::Utilities::real_spherical_harmonic(ideg,iord,surface_cell_spherical_coordinates.at(i).first,surface_cell_spherical_coordinates.at(i).second);
-                      const double cos_component = sph_harm_vals.first; // real / cos part
-                      const double sin_component = sph_harm_vals.second; // imaginary / sine part
+                      const double cos_component = cosine_components[ideg][iord]; // real / cos part
+                      const double sin_component = sine_components[ideg][iord]; // imaginary / sine part
 
                       // the conversion from geoid to gravity anomaly is given by gravity_anomaly = (l-1)*g/R_surface * geoid_anomaly
                       // based on Forte (2007) equation [97]
@@ -911,15 +962,16 @@ namespace aspect
       const double phi = scoord[1];
       double value = 0.;
 
+      std::vector<std::vector<double> > cosine_components;
+      std::vector<std::vector<double> > sine_components;
+      aspect::Utilities::real_spherical_harmonics(max_degree, theta, phi,
+                                                  cosine_components, sine_components);
+
       for (unsigned int ideg=min_degree, k=0; ideg < max_degree+1; ideg++)
         for (unsigned int iord = 0; iord < ideg+1; iord++, k++)
-          {
-            std::pair<double,double> val = aspect::Utilities::real_spherical_harmonic( ideg, iord, theta, phi );
-
-            value += geoid_coecos[k] * val.first +
-                     geoid_coesin[k] * val.second;
+          value += geoid_coecos[k] * cosine_components[ideg][iord] +
+                   geoid_coesin[k] * sine_components[ideg][iord];
 
-          }
       return value;
     }
 
@@ -992,6 +1044,9 @@ namespace aspect
           include_dynamic_topo_contribution = prm.get_bool ("Include the contributon from dynamic topography");
           max_degree = prm.get_integer ("Maximum degree");
           min_degree = prm.get_integer ("Minimum degree");
+          AssertThrow (min_degree <= max_degree,
+                       ExcMessage("The minimum degree of the geoid postprocessor needs to be "
+                                  "smaller than or equal to its maximum degree."));
           output_in_lat_lon = prm.get_bool ("Output data in geographical coordinates");
           density_above = prm.get_double ("Density above");
           density_below = prm.get_double ("Density below");
@@ -27,6 +27,7 @@
 #include <aspect/global.h>
 #include <aspect/utilities.h>
 
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/fe/fe_values.h>
 
@@ -34,10 +35,293 @@
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+#include <array>
+#include <memory>
+
 namespace aspect
 {
   namespace Postprocess
   {
+    namespace
+    {
+      /**
+       * The gravity acceleration, gravity anomaly, gravity gradient and
+       * gravity potential at one satellite.
+       */
+      struct GravityValues
+      {
+        GravityValues ()
+          :
+          g_potential (0)
+        {}
+
+        Tensor<1,3> g;
+        Tensor<1,3> g_anomaly;
+        Tensor<2,3> g_gradient;
+        double g_potential;
+      };
+
+
+
+      /**
+       * Return @p point as a point in three dimensions. The gravity
+       * computations below are always done in three dimensions, but the
+       * postprocessor is also instantiated for dim==2.
+       */
+      template <int dim>
+      Point<3>
+      to_point_3d (const Point<dim> &point)
+      {
+        Point<3> result;
+        for (unsigned int d=0; d<dim; ++d)
+          result[d] = point[d];
+        return result;
+      }
+
+
+
+      /**
+       * Add the contribution of a point with mass @p mass and mass anomaly
+       * @p anomaly_mass at @p position to the gravity at @p satellite.
+       * Only the upper triangle of the gravity gradient is computed.
+       */
+      inline
+      void
+      add_point_mass (const Point<3> &satellite,
+                      const Point<3> &position,
+                      const double mass,
+                      const double anomaly_mass,
+                      const double G,
+                      GravityValues &values)
+      {
+        const Tensor<1,3> r = satellite - position;
+        const double dist = r.norm();
+        const double dist_3 = dist * dist * dist;
+
+        values.g -= G * mass / dist_3 * r;
+        values.g_anomaly -= G * anomaly_mass / dist_3 * r;
+        values.g_potential -= G * mass / dist;
+
+        const double grad_KK = G * mass / (dist_3 * dist * dist);
+        for (unsigned int k=0; k<3; ++k)
+          for (unsigned int l=k; l<3; ++l)
+            values.g_gradient[k][l] += grad_KK * (3.0 * r[k] * r[l] - (k == l ? dist * dist : 0.));
+      }
+
+
+
+      /**
+       * An octree of point masses that approximates the gravity of all
+       * masses in a node of the tree that is far away from a satellite by
+       * a multipole expansion (monopole and dipole moments about the center
+       * of the node), following Barnes and Hut. A node is considered far
+       * away if the radius of the smallest sphere around its center that
+       * contains all its masses is smaller than the opening angle times the
+       * distance to the satellite. The error of the expansion is
+       * proportional to the square of the opening angle, and an opening
+       * angle of zero reproduces the direct summation over all masses.
+       */
+      class MassTree
+      {
+        public:
+          MassTree (const std::vector<Point<3> > &positions,
+                    const std::vector<double> &masses,
+                    const std::vector<double> &anomaly_masses,
+                    const unsigned int max_points_per_leaf);
+
+          void
+          evaluate (const Point<3> &satellite,
+                    const double opening_angle,
+                    const double G,
+                    GravityValues &values) const;
+
+        private:
+          struct Node
+          {
+            Point<3> center;
+            double radius;
+            double mass;
+            double anomaly_mass;
+            Tensor<1,3> dipole;
+            Tensor<1,3> anomaly_dipole;
+            unsigned int begin;
+            unsigned int end;
+            std::vector<unsigned int> children;
+          };
+
+          /**
+           * Create the node for the points order[begin...end) and its
+           * children, and return its index.
+           */
+          unsigned int
+          build (std::vector<unsigned int> &order,
+                 const unsigned int begin,
+                 const unsigned int end,
+                 const unsigned int max_points_per_leaf);
+
+          std::vector<Point<3> > positions;
+          std::vector<double> masses;
+          std::vector<double> anomaly_masses;
+          std::vector<Node> nodes;
+      };
+
+
+
+      MassTree::MassTree (const std::vector<Point<3> > &unsorted_positions,
+                          const std::vector<double> &unsorted_masses,
+                          const std::vector<double> &unsorted_anomaly_masses,
+                          const unsigned int max_points_per_leaf)
+        :
+        positions (unsorted_positions),
+        masses (unsorted_masses),
+        anomaly_masses (unsorted_anomaly_masses)
+      {
+        if (positions.size() == 0)
+          return;
+
+        std::vector<unsigned int> order (positions.size());
+        for (unsigned int i=0; i<order.size(); ++i)
+          order[i] = i;
+
+        build (order, 0, order.size(), max_points_per_leaf);
+
+        // store the points in the order of the tree, so that every node
+        // refers to a contiguous range of points
+        for (unsigned int i=0; i<order.size(); ++i)
+          {
+            positions[i] = unsorted_positions[order[i]];
+            masses[i] = unsorted_masses[order[i]];
+            anomaly_masses[i] = unsorted_anomaly_masses[order[i]];
+          }
+      }
+
+
+
+      unsigned int
+      MassTree::build (std::vector<unsigned int> &order,
+                       const unsigned int begin,
+                       const unsigned int end,
+                       const unsigned int max_points_per_leaf)
+      {
+        Node node;
+        node.begin = begin;
+        node.end = end;
+
+        Point<3> lower = positions[order[begin]];
+        Point<3> upper = lower;
+        for (unsigned int i=begin; i<end; ++i)
+          for (unsigned int d=0; d<3; ++d)
+            {
+              lower[d] = std::min(lower[d], positions[order[i]][d]);
+              upper[d] = std::max(upper[d], positions[order[i]][d]);
+            }
+        for (unsigned int d=0; d<3; ++d)
+          node.center[d] = 0.5 * (lower[d] + upper[d]);
+
+        node.radius = 0;
+        node.mass = 0;
+        node.anomaly_mass = 0;
+        for (unsigned int i=begin; i<end; ++i)
+          {
+            const Tensor<1,3> offset = positions[order[i]] - node.center;
+            node.radius = std::max(node.radius, offset.norm());
+            node.mass += masses[order[i]];
+            node.anomaly_mass += anomaly_masses[order[i]];
+            node.dipole += masses[order[i]] * offset;
+            node.anomaly_dipole += anomaly_masses[order[i]] * offset;
+          }
+
+        const unsigned int index = nodes.size();
+        nodes.push_back (node);
+
+        if (end - begin <= max_points_per_leaf || node.radius == 0)
+          return index;
+
+        // Split the points into the eight octants around the center. Since
+        // the center lies in the middle of the bounding box, every split
+        // along a direction in which the points differ creates two
+        // nonempty parts.
+        std::array<unsigned int,9> octant_begin;
+        octant_begin[0] = begin;
+        octant_begin[8] = end;
+        const auto split = [&] (const unsigned int first, const unsigned int last, const unsigned int d) -> unsigned int
+        {
+          return std::partition (order.begin() + first, order.begin() + last,
+                                 [&](const unsigned int i)
+          {
+            return positions[i][d] < node.center[d];
+          }) - order.begin();
+        };
+        octant_begin[4] = split (octant_begin[0], octant_begin[8], 0);
+        octant_begin[2] = split (octant_begin[0], octant_begin[4], 1);
+        octant_begin[6] = split (octant_begin[4], octant_begin[8], 1);
+        for (unsigned int o=0; o<8; o+=2)
+          octant_begin[o+1] = split (octant_begin[o], octant_begin[o+2], 2);
+
+        std::vector<unsigned int> children;
+        for (unsigned int o=0; o<8; ++o)
+          if (octant_begin[o+1] > octant_begin[o])
+            children.push_back (build (order, octant_begin[o], octant_begin[o+1], max_points_per_leaf));
+
+        nodes[index].children = children;
+        return index;
+      }
+
+
+
+      void
+      MassTree::evaluate (const Point<3> &satellite,
+                          const double opening_angle,
+                          const double G,
+                          GravityValues &values) const
+      {
+        if (nodes.size() == 0)
+          return;
+
+        std::vector<unsigned int> nodes_to_visit (1, 0);
+        while (nodes_to_visit.size() > 0)
+          {
+            const Node &node = nodes[nodes_to_visit.back()];
+            nodes_to_visit.pop_back();
+
+            const Tensor<1,3> r = satellite - node.center;
+            const double R = r.norm();
+
+            if (node.children.size() > 0 && node.radius >= opening_angle * R)
+              nodes_to_visit.insert (nodes_to_visit.end(), node.children.begin(), node.children.end());
+            else if (node.children.size() == 0 && node.radius >= opening_angle * R)
+              for (unsigned int i=node.begin; i<node.end; ++i)
+                add_point_mass (satellite, positions[i], masses[i], anomaly_masses[i], G, values);
+            else
+              {
+                // Expand 1/|r-s| around the center of the node up to the
+                // dipole term, and differentiate the expansion to get the
+                // gravity acceleration and the gravity gradient.
+                const double R2 = R * R;
+                const double R3 = R2 * R;
+                const double R5 = R3 * R2;
+                const double R7 = R5 * R2;
+                const double dipole_r = node.dipole * r;
+                const double anomaly_dipole_r = node.anomaly_dipole * r;
+
+                values.g_potential -= G * (node.mass / R + dipole_r / R3);
+                values.g -= G * (node.mass / R3 * r + (3. * dipole_r * r - R2 * node.dipole) / R5);
+                values.g_anomaly -= G * (node.anomaly_mass / R3 * r
+                                         + (3. * anomaly_dipole_r * r - R2 * node.anomaly_dipole) / R5);
+
+                for (unsigned int k=0; k<3; ++k)
+                  for (unsigned int l=k; l<3; ++l)
+                    values.g_gradient[k][l] += G * (node.mass * (3. * r[k] * r[l] - (k == l ? R2 : 0.)) / R5
+                                                    + 15. * dipole_r * r[k] * r[l] / R7
+                                                    - 3. * (node.dipole[k] * r[l] + node.dipole[l] * r[k]
+                                                            + (k == l ? dipole_r : 0.)) / R5);
+              }
+          }
+      }
+    }
+
+
 
     template <int dim>
     GravityPointValues<dim>::GravityPointValues ()
@@ -289,9 +573,67 @@ namespace aspect
                  << '\n';
         }
 
+      // The spherical coordinates of the satellites are shifted into cartesian
+      // to allow simplification in the mathematical equation.
+      std::vector<Point<dim> > satellites_position (n_satellites);
+      for (unsigned int p=0; p < n_satellites; ++p)
+        {
+          std::array<double,dim> satellite_point_coordinate;
+          satellite_point_coordinate[0] = satellites_coordinate[p][0];
+          satellite_point_coordinate[1] = satellites_coordinate[p][1];
+          satellite_point_coordinate[2] = satellites_coordinate[p][2];
+          satellites_position[p] = Utilities::Coordinates::spherical_to_cartesian_coordinates<dim>(satellite_point_coordinate);
+        }
+
       // This is the main loop which computes gravity acceleration, potential and
-      // gradients at a point located at the spherical coordinate [r, phi, theta].
-      // This loop corresponds to the 3 integrals of Newton law:
+      // gradients at all satellites from the local quadrature points, either by
+      // summing over all of them (the integrals of Newton law), or by
+      // approximating the contributions of far away groups of quadrature points
+      // with a tree. The satellites are independent of each other, so we
+      // distribute them over threads.
+      std::vector<Point<3> > position_point_3d (position_point.size());
+      for (unsigned int i=0; i<position_point.size(); ++i)
+        position_point_3d[i] = to_point_3d (position_point[i]);
+
+      std::vector<GravityValues> local_values (n_satellites);
+      std::unique_ptr<MassTree> mass_tree;
+      if (evaluation_method == tree)
+        mass_tree = std_cxx14::make_unique<MassTree> (position_point_3d, density_JxW, density_anomalies_JxW, 16);
+
+      parallel::apply_to_subranges (0U, n_satellites,
+                                    [&] (const unsigned int begin, const unsigned int end)
+      {
+        for (unsigned int p=begin; p<end; ++p)
+          {
+            const Point<3> satellite = to_point_3d (satellites_position[p]);
+            if (evaluation_method == tree)
+              mass_tree->evaluate (satellite, tree_opening_angle, G, local_values[p]);
+            else
+              for (unsigned int i=0; i<position_point_3d.size(); ++i)
+                add_point_mass (satellite, position_point_3d[i],
+                                density_JxW[i], density_anomalies_JxW[i], G, local_values[p]);
+          }
+      },
+      16);
+
+      // Sum local gravity components of all satellites over the global domain
+      // in a single reduction:
+      const unsigned int n_values_per_satellite = 16;
+      std::vector<double> satellite_values (n_satellites * n_values_per_satellite);
+      for (unsigned int p=0; p < n_satellites; ++p)
+        {
+          double *values = &satellite_values[p * n_values_per_satellite];
+          for (unsigned int d=0; d<dim; ++d)
+            {
+              values[d] = local_values[p].g[d];
+              values[dim+d] = local_values[p].g_anomaly[d];
+              for (unsigned int e=0; e<dim; ++e)
+                values[2*dim + d*dim + e] = local_values[p].g_gradient[d][e];
+            }
+          values[n_values_per_satellite-1] = local_values[p].g_potential;
+        }
+      Utilities::MPI::sum (satellite_values, this->get_mpi_communicator(), satellite_values);
+
       double sum_g = 0;
       double min_g = std::numeric_limits<double>::max();
       double max_g = -std::numeric_limits<double>::max();
@@ -300,66 +642,20 @@ namespace aspect
       double max_g_potential = -std::numeric_limits<double>::max();
       for (unsigned int p=0; p < n_satellites; ++p)
         {
+          const Point<dim> &position_satellite = satellites_position[p];
 
-          // The spherical coordinates are shifted into cartesian to allow simplification
-          // in the mathematical equation.
-          std::array<double,dim> satellite_point_coordinate;
-          satellite_point_coordinate[0] = satellites_coordinate[p][0];
-          satellite_point_coordinate[1] = satellites_coordinate[p][1];
-          satellite_point_coordinate[2] = satellites_coordinate[p][2];
-          const Point<dim> position_satellite = Utilities::Coordinates::spherical_to_cartesian_coordinates<dim>(satellite_point_coordinate);
-
-          // For each point (i.e. satellite), the fourth integral goes over cells and
-          // quadrature points to get the unique distance between those, to calculate
-          // gravity vector components x,y,z (in tensor), potential and gradients.
-          Tensor<1,dim> local_g;
-          Tensor<1,dim> local_g_anomaly;
-          Tensor<2,dim> local_g_gradient;
-          double local_g_potential = 0;
-          local_cell_number = 0;
-          for (const auto &cell : this->get_dof_handler().active_cell_iterators())
-            if (cell->is_locally_owned())
-              {
-                for (unsigned int q = 0; q < n_quadrature_points_per_cell; ++q)
-                  {
-                    const double dist = (position_satellite - position_point[local_cell_number * n_quadrature_points_per_cell + q]).norm();
-                    // For gravity acceleration:
-                    const double KK = - G * density_JxW[local_cell_number * n_quadrature_points_per_cell + q] / std::pow(dist,3);
-                    local_g += KK * (position_satellite - position_point[local_cell_number * n_quadrature_points_per_cell + q]);
-                    // For gravity anomalies:
-                    const double KK_anomalies = - G * density_anomalies_JxW[local_cell_number * n_quadrature_points_per_cell + q] / std::pow(dist,3);
-                    local_g_anomaly += KK_anomalies * (position_satellite - position_point[local_cell_number * n_quadrature_points_per_cell + q]);
-                    // For gravity potential:
-                    local_g_potential -= G * density_JxW[local_cell_number * n_quadrature_points_per_cell + q] / dist;
-                    // For gravity gradient:
-                    const double grad_KK = G * density_JxW[local_cell_number * n_quadrature_points_per_cell + q] / std::pow(dist,5);
-                    local_g_gradient[0][0] += grad_KK * (3.0
-                                                         * std::pow((position_satellite[0] - position_point[local_cell_number * n_quadrature_points_per_cell + q][0]),2)
-                                                         - std::pow(dist,2));
-                    local_g_gradient[1][1] += grad_KK * (3.0
-                                                         * std::pow((position_satellite[1] - position_point[local_cell_number * n_quadrature_points_per_cell + q][1]),2)
-                                                         - std::pow(dist,2));
-                    local_g_gradient[2][2] += grad_KK * (3.0
-                                                         * std::pow((position_satellite[2] - position_point[local_cell_number * n_quadrature_points_per_cell + q][2]),2)
-                                                         - std::pow(dist,2));
-                    local_g_gradient[0][1] += grad_KK * (3.0
-                                                         * (position_satellite[0] - position_point[local_cell_number * n_quadrature_points_per_cell + q][0])
-                                                         * (position_satellite[1] - position_point[local_cell_number * n_quadrature_points_per_cell + q][1]));
-                    local_g_gradient[0][2] += grad_KK * (3.0
-                                                         * (position_satellite[0] - position_point[local_cell_number * n_quadrature_points_per_cell + q][0])
-                                                         * (position_satellite[2] - position_point[local_cell_number * n_quadrature_points_per_cell + q][2]));
-                    local_g_gradient[1][2] += grad_KK * (3.0
-                                                         * (position_satellite[1] - position_point[local_cell_number * n_quadrature_points_per_cell + q][1])
-                                                         * (position_satellite[2] - position_point[local_cell_number * n_quadrature_points_per_cell + q][2]));
-                  }
-                ++local_cell_number;
-              }
-
-          // Sum local gravity components over global domain:
-          const Tensor<1,dim> g          = Utilities::MPI::sum (local_g, this->get_mpi_communicator());
-          const Tensor<1,dim> g_anomaly  = Utilities::MPI::sum (local_g_anomaly, this->get_mpi_communicator());
-          const Tensor<2,dim> g_gradient = Utilities::MPI::sum (local_g_gradient, this->get_mpi_communicator());
-          const double g_potential       = Utilities::MPI::sum (local_g_potential, this->get_mpi_communicator());
+          const double *values = &satellite_values[p * n_values_per_satellite];
+          Tensor<1,dim> g;
+          Tensor<1,dim> g_anomaly;
+          Tensor<2,dim> g_gradient;
+          for (unsigned int d=0; d<dim; ++d)
+            {
+              g[d] = values[d];
+              g_anomaly[d] = values[dim+d];
+              for (unsigned int e=0; e<dim; ++e)
+                g_gradient[d][e] = values[2*dim + d*dim + e];
+            }
+          const double g_potential = values[n_values_per_satellite-1];
 
           // sum gravity components for all n_satellites:
           sum_g += g.norm();
@@ -597,6 +893,25 @@ namespace aspect
                              Patterns::List (Patterns::Double(-90.0, 90.0)),
                              "Parameter for the list of points sampling scheme: "
                              "List of satellite latitude coordinates.");
+          prm.declare_entry ("Evaluation method", "direct",
+                             Patterns::Selection ("direct|tree"),
+                             "How to compute gravity at the satellites. The `direct' method "
+                             "sums the contributions of all quadrature points for every "
+                             "satellite, which is exact but its cost is the product of the "
+                             "number of satellites and quadrature points. The `tree' method "
+                             "groups the quadrature points of each process into an octree and "
+                             "approximates the contribution of groups far away from a "
+                             "satellite by their monopole and dipole moments (Barnes-Hut "
+                             "method). Its accuracy is controlled by the ``Tree opening "
+                             "angle''.");
+          prm.declare_entry ("Tree opening angle", "0.3",
+                             Patterns::Double (0.),
+                             "Parameter for the tree evaluation method: A group of quadrature "
+                             "points is approximated by its multipole expansion if the radius "
+                             "of the group is smaller than this value times its distance to "
+                             "the satellite. The error decreases with the square of this "
+                             "value, and a value of zero gives the same result as the "
+                             "direct method.");
           prm.declare_entry ("Time between gravity output", "1e8",
                              Patterns::Double(0.0),
                              "The time interval between each generation of "
@@ -644,6 +959,13 @@ namespace aspect
           else
             AssertThrow (false, ExcMessage ("Not a valid sampling scheme."));
           quadrature_degree_increase = prm.get_integer ("Quadrature degree increase");
+          if (prm.get ("Evaluation method") == "direct")
+            evaluation_method = direct;
+          else if (prm.get ("Evaluation method") == "tree")
+            evaluation_method = tree;
+          else
+            AssertThrow (false, ExcMessage ("Not a valid evaluation method."));
+          tree_opening_angle  = prm.get_double ("Tree opening angle");
           n_points_spiral     = prm.get_integer("Number points fibonacci spiral");
           n_points_radius     = prm.get_integer("Number points radius");
           n_points_longitude  = prm.get_integer("Number points longitude");
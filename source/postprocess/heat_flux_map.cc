@@ -128,7 +128,7 @@ namespace aspect
             {
               fe_volume_values.reinit (cell);
               in.reinit(fe_volume_values, cell, simulator_access.introspection(), simulator_access.get_solution(), true);
-              simulator_access.get_material_model().evaluate(in, out);
+              simulator_access.evaluate_material_model(in, out);
 
               if (simulator_access.get_parameters().formulation_temperature_equation ==
                   Parameters<dim>::Formulation::TemperatureEquation::reference_density_profile)
@@ -247,7 +247,7 @@ namespace aspect
                   else if (fixed_heat_flux_boundaries.find(boundary_id) != fixed_heat_flux_boundaries.end())
                     {
                       face_in.reinit(fe_face_values, cell, simulator_access.introspection(), simulator_access.get_solution(), true);
-                      simulator_access.get_material_model().evaluate(face_in, face_out);
+                      simulator_access.evaluate_material_model(face_in, face_out);
 
                       if (simulator_access.get_parameters().formulation_temperature_equation ==
                           Parameters<dim>::Formulation::TemperatureEquation::reference_density_profile)
@@ -388,7 +388,7 @@ namespace aspect
                     if (prescribed_heat_flux || non_tangential_velocity)
                       {
                         face_in.reinit(fe_face_values, cell, simulator_access.introspection(), simulator_access.get_solution(), true);
-                        simulator_access.get_material_model().evaluate(face_in, face_out);
+                        simulator_access.evaluate_material_model(face_in, face_out);
 
                         if (simulator_access.get_parameters().formulation_temperature_equation ==
                             Parameters<dim>::Formulation::TemperatureEquation::reference_density_profile)
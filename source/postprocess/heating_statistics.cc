@@ -78,7 +78,7 @@ namespace aspect
             in.reinit(fe_values, cell, this->introspection(), this->get_solution());
 
             this->get_material_model().fill_additional_material_model_inputs(in, this->get_solution(), fe_values, this->introspection());
-            this->get_material_model().evaluate(in, out);
+            this->evaluate_material_model(in, out);
 
             if (this->get_parameters().formulation_temperature_equation
                 == Parameters<dim>::Formulation::TemperatureEquation::reference_density_profile)
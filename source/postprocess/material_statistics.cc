@@ -61,7 +61,7 @@ namespace aspect
             in.reinit(fe_values, cell, this->introspection(), this->get_solution());
 
             this->get_material_model().fill_additional_material_model_inputs(in, this->get_solution(), fe_values, this->introspection());
-            this->get_material_model().evaluate(in, out);
+            this->evaluate_material_model(in, out);
 
             for (unsigned int q=0; q<n_q_points; ++q)
               {
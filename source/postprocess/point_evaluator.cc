@@ -0,0 +1,280 @@
+/*
+  Copyright (C) 2020 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include <aspect/postprocess/point_evaluator.h>
+
+#include <deal.II/base/quadrature.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/grid_tools_cache.h>
+
+#include <map>
+
+namespace aspect
+{
+  namespace Postprocess
+  {
+    template <int dim>
+    PointEvaluator<dim>::PointEvaluator ()
+      :
+      points_located (false)
+    {}
+
+
+
+    template <int dim>
+    void
+    PointEvaluator<dim>::set_points (const std::vector<Point<dim> > &new_points)
+    {
+      points = new_points;
+      clear();
+    }
+
+
+
+    template <int dim>
+    const std::vector<Point<dim> > &
+    PointEvaluator<dim>::get_points () const
+    {
+      return points;
+    }
+
+
+
+    template <int dim>
+    void
+    PointEvaluator<dim>::clear ()
+    {
+      located_cells.clear();
+      points_located = false;
+    }
+
+
+
+    template <int dim>
+    void
+    PointEvaluator<dim>::locate_points (const Mapping<dim> &mapping,
+                                        const DoFHandler<dim> &dof_handler,
+                                        const MPI_Comm &mpi_communicator)
+    {
+      const Triangulation<dim> &triangulation = dof_handler.get_triangulation();
+      const FiniteElement<dim> &fe = dof_handler.get_fe();
+
+      AssertThrow (fe.is_primitive(),
+                   ExcMessage("The PointEvaluator class only supports primitive finite elements."));
+
+      // Compute the bounding box of the locally owned cells, and mark their
+      // vertices so that the search below only looks at locally owned
+      // cells. Because curved cells can extend beyond the bounding box of
+      // their vertices, enlarge the box by the largest cell diameter.
+      Point<dim> box_min, box_max;
+      bool have_owned_cells = false;
+      double max_diameter = 0;
+      std::vector<bool> owned_vertices (triangulation.n_vertices(), false);
+
+      for (const auto &cell : triangulation.active_cell_iterators())
+        if (cell->is_locally_owned())
+          {
+            for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+              {
+                owned_vertices[cell->vertex_index(v)] = true;
+
+                const Point<dim> &vertex = cell->vertex(v);
+                if (!have_owned_cells)
+                  {
+                    box_min = vertex;
+                    box_max = vertex;
+                    have_owned_cells = true;
+                  }
+                for (unsigned int d=0; d<dim; ++d)
+                  {
+                    box_min[d] = std::min(box_min[d], vertex[d]);
+                    box_max[d] = std::max(box_max[d], vertex[d]);
+                  }
+              }
+            max_diameter = std::max(max_diameter, cell->diameter());
+          }
+
+      const auto in_box = [&] (const Point<dim> &point) -> bool
+      {
+        if (!have_owned_cells)
+          return false;
+        for (unsigned int d=0; d<dim; ++d)
+          if (point[d] < box_min[d] - max_diameter || point[d] > box_max[d] + max_diameter)
+            return false;
+        return true;
+      };
+
+      // Now search for the cells around all points in our box. Points that
+      // lie on the boundary between processes are found by several
+      // processes; they are evaluated by the one with the smallest rank.
+      const unsigned int my_rank = Utilities::MPI::this_mpi_process(mpi_communicator);
+      const unsigned int n_ranks = Utilities::MPI::n_mpi_processes(mpi_communicator);
+
+      GridTools::Cache<dim> cache (triangulation, mapping);
+      typename Triangulation<dim>::active_cell_iterator cell_hint;
+
+      std::vector<std::pair<typename Triangulation<dim>::active_cell_iterator, Point<dim> > >
+      cells_and_reference_points (points.size());
+      std::vector<unsigned int> owners (points.size(), n_ranks);
+
+      for (unsigned int p=0; p<points.size(); ++p)
+        if (in_box(points[p]))
+          {
+            try
+              {
+                const auto cell_and_reference_point
+                  = GridTools::find_active_cell_around_point (cache, points[p], cell_hint, owned_vertices);
+
+                if (cell_and_reference_point.first.state() == IteratorState::valid
+                    &&
+                    cell_and_reference_point.first->is_locally_owned())
+                  {
+                    cells_and_reference_points[p] = cell_and_reference_point;
+                    owners[p] = my_rank;
+                    cell_hint = cell_and_reference_point.first;
+                  }
+              }
+            catch (const GridTools::ExcPointNotFound<dim> &)
+              {
+                // the point is not in any of our cells
+              }
+          }
+
+      Utilities::MPI::min (owners, mpi_communicator, owners);
+
+      for (unsigned int p=0; p<points.size(); ++p)
+        AssertThrow (owners[p] < n_ranks,
+                     ExcMessage ("While trying to evaluate the solution at point " +
+                                 Utilities::to_string(points[p][0]) + ", " +
+                                 Utilities::to_string(points[p][1]) +
+                                 (dim == 3
+                                  ?
+                                  ", " + Utilities::to_string(points[p][2])
+                                  :
+                                  "") + "), " +
+                                 "no processors reported that the point lies inside the " +
+                                 "set of cells they own. Are you trying to evaluate the " +
+                                 "solution at a point that lies outside of the domain?"));
+
+      // Group the points we evaluate by cell
+      std::map<typename Triangulation<dim>::active_cell_iterator, unsigned int> cell_to_index;
+      std::vector<std::vector<Point<dim> > > reference_points;
+      for (unsigned int p=0; p<points.size(); ++p)
+        if (owners[p] == my_rank)
+          {
+            const auto cell = cells_and_reference_points[p].first;
+            const auto inserted = cell_to_index.insert (std::make_pair(cell, located_cells.size()));
+            if (inserted.second)
+              {
+                LocatedCell located_cell;
+                located_cell.cell = typename DoFHandler<dim>::active_cell_iterator (&triangulation,
+                                                                                   cell->level(),
+                                                                                   cell->index(),
+                                                                                   &dof_handler);
+                located_cells.push_back (located_cell);
+                reference_points.emplace_back ();
+              }
+
+            located_cells[inserted.first->second].point_indices.push_back (p);
+            reference_points[inserted.first->second].push_back (cells_and_reference_points[p].second);
+          }
+
+      // Finally compute the values of the shape functions at the points
+      for (unsigned int c=0; c<located_cells.size(); ++c)
+        {
+          LocatedCell &located_cell = located_cells[c];
+
+          FEValues<dim> fe_values (mapping, fe,
+                                   Quadrature<dim>(reference_points[c]),
+                                   update_values);
+          fe_values.reinit (located_cell.cell);
+
+          located_cell.shape_values.reinit (located_cell.point_indices.size(), fe.dofs_per_cell);
+          for (unsigned int q=0; q<located_cell.point_indices.size(); ++q)
+            for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+              located_cell.shape_values(q,i) = fe_values.shape_value(i,q);
+        }
+
+      points_located = true;
+    }
+
+
+
+    template <int dim>
+    void
+    PointEvaluator<dim>::evaluate (const Mapping<dim> &mapping,
+                                   const DoFHandler<dim> &dof_handler,
+                                   const LinearAlgebra::BlockVector &solution,
+                                   const MPI_Comm &mpi_communicator,
+                                   std::vector<Vector<double> > &values)
+    {
+      if (!points_located)
+        locate_points (mapping, dof_handler, mpi_communicator);
+
+      const FiniteElement<dim> &fe = dof_handler.get_fe();
+      const unsigned int n_components = fe.n_components();
+
+      // Evaluate the points we own, and leave the values of all other
+      // points at zero so that a sum over all processes collects the
+      // values of all points in one reduction.
+      std::vector<double> point_values (points.size() * n_components, 0.);
+      std::vector<types::global_dof_index> local_dof_indices (fe.dofs_per_cell);
+
+      for (const LocatedCell &located_cell : located_cells)
+        {
+          located_cell.cell->get_dof_indices (local_dof_indices);
+
+          for (unsigned int q=0; q<located_cell.point_indices.size(); ++q)
+            {
+              double *values_at_point = &point_values[located_cell.point_indices[q] * n_components];
+              for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+                values_at_point[fe.system_to_component_index(i).first]
+                += solution(local_dof_indices[i]) * located_cell.shape_values(q,i);
+            }
+        }
+
+      Utilities::MPI::sum (point_values, mpi_communicator, point_values);
+
+      values.resize (points.size());
+      for (unsigned int p=0; p<points.size(); ++p)
+        {
+          values[p].reinit (n_components);
+          for (unsigned int c=0; c<n_components; ++c)
+            values[p][c] = point_values[p * n_components + c];
+        }
+    }
+  }
+}
+
+
+// explicit instantiations
+namespace aspect
+{
+  namespace Postprocess
+  {
+#define INSTANTIATE(dim) \
+  template class PointEvaluator<dim>;
+
+    ASPECT_INSTANTIATE(INSTANTIATE)
+
+#undef INSTANTIATE
+  }
+}
@@ -45,6 +45,21 @@ namespace aspect
       use_natural_coordinates (false)
     {}
 
+    template <int dim>
+    void
+    PointValues<dim>::initialize ()
+    {
+      // the cells around the evaluation points need to be found again
+      // whenever the mesh changes
+      this->get_triangulation().signals.post_refinement.connect(
+        [&]()
+      {
+        this->point_evaluator.clear();
+      });
+    }
+
+
+
     template <int dim>
     std::pair<std::string,std::string>
     PointValues<dim>::execute (TableHandler &)
@@ -59,57 +74,21 @@ namespace aspect
       if (this->get_time() < last_output_time + output_interval)
         return std::pair<std::string,std::string>();
 
-      // evaluate the solution at all of our evaluation points
-      std::vector<Vector<double> >
-      current_point_values (evaluation_points_cartesian.size(),
-                            Vector<double> (this->introspection().n_components));
-
-      for (unsigned int p=0; p<evaluation_points_cartesian.size(); ++p)
-        {
-          // try to evaluate the solution at this point. in parallel, the point
-          // will be on only one processor's owned cells, so the others are
-          // going to throw an exception. make sure at least one processor
-          // finds the given point
-          bool point_found = false;
-
-          try
-            {
-              VectorTools::point_value(this->get_mapping(),
-                                       this->get_dof_handler(),
-                                       this->get_solution(),
-                                       evaluation_points_cartesian[p],
-                                       current_point_values[p]);
-              point_found = true;
-            }
-          catch (const VectorTools::ExcPointNotAvailableHere &)
-            {
-              // ignore
-            }
-
-          // ensure that at least one processor found things
-          const int n_procs = Utilities::MPI::sum (point_found ? 1 : 0, this->get_mpi_communicator());
-          AssertThrow (n_procs > 0,
-                       ExcMessage ("While trying to evaluate the solution at point " +
-                                   Utilities::to_string(evaluation_points_cartesian[p][0]) + ", " +
-                                   Utilities::to_string(evaluation_points_cartesian[p][1]) +
-                                   (dim == 3
-                                    ?
-                                    ", " + Utilities::to_string(evaluation_points_cartesian[p][2])
-                                    :
-                                    "") + "), " +
-                                   "no processors reported that the point lies inside the " +
-                                   "set of cells they own. Are you trying to evaluate the " +
-                                   "solution at a point that lies outside of the domain?"
-                                  ));
-
-          // Reduce all collected values into local Vector
-          Utilities::MPI::sum (current_point_values[p], this->get_mpi_communicator(),
-                               current_point_values[p]);
-
-          // Normalize in cases where points are claimed by multiple processors
-          if (n_procs > 1)
-            current_point_values[p] /= n_procs;
-        }
+      // evaluate the solution at all of our evaluation points. the
+      // evaluator locates the points only once after every mesh change,
+      // unless the mesh is deformed, in which case the location of the
+      // points relative to the cells changes in every time step
+      if (point_evaluator.get_points() != evaluation_points_cartesian)
+        point_evaluator.set_points (evaluation_points_cartesian);
+      if (this->get_parameters().mesh_deformation_enabled)
+        point_evaluator.clear();
+
+      std::vector<Vector<double> > current_point_values;
+      point_evaluator.evaluate (this->get_mapping(),
+                                this->get_dof_handler(),
+                                this->get_solution(),
+                                this->get_mpi_communicator(),
+                                current_point_values);
 
       // finally push these point values all onto the list we keep
       point_values.push_back (std::make_pair (this->get_time(),
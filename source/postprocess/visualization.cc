@@ -38,6 +38,9 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <type_traits>
 
 #include <boost/lexical_cast.hpp>
@@ -155,6 +158,123 @@ namespace aspect
                 computed_quantities[q][i] = input_data.solution_values[q][i] * velocity_scaling_factor;
           }
       };
+
+
+
+      /**
+       * Round @p value to a floating point number that has only
+       * @p mantissa_bits significant bits in its mantissa. Data rounded
+       * this way is compressed much better by the zlib compression of
+       * VTU output files. Infinite values and NaNs are returned unchanged.
+       */
+      inline
+      float
+      quantize (const float value,
+                const unsigned int mantissa_bits)
+      {
+        static_assert (sizeof(float) == sizeof(std::uint32_t),
+                       "This function requires 32 bit floating point numbers.");
+        const unsigned int dropped_bits = std::numeric_limits<float>::digits - 1 - mantissa_bits;
+        if (dropped_bits == 0)
+          return value;
+
+        std::uint32_t bits;
+        std::memcpy (&bits, &value, sizeof(bits));
+
+        const std::uint32_t exponent_mask = 0x7f800000u;
+        if ((bits & exponent_mask) == exponent_mask)
+          return value;
+
+        // round to nearest by adding half of the last kept bit, then
+        // clear the dropped bits
+        bits += (std::uint32_t(1) << (dropped_bits-1));
+        bits &= ~((std::uint32_t(1) << dropped_bits) - 1);
+
+        float result;
+        std::memcpy (&result, &bits, sizeof(result));
+        return result;
+      }
+
+
+
+      /**
+       * A DataOut object that can reduce the size of the output: It can
+       * restrict the output to the cells within a box, and it can reduce
+       * the precision of the output data after the patches have been built.
+       */
+      template <int dim>
+      class ReducedDataOut : public DataOut<dim>
+      {
+        public:
+          /**
+           * Only output the locally owned cells whose bounding box intersects
+           * the box spanned by @p region_min and @p region_max. This
+           * function needs to be called before build_patches().
+           */
+          void
+          select_region (const Point<dim> &region_min,
+                         const Point<dim> &region_max)
+          {
+            using cell_iterator = typename DataOut<dim>::cell_iterator;
+
+            const auto in_region = [region_min, region_max] (const cell_iterator &cell) -> bool
+            {
+              if (!cell->is_active() || !cell->is_locally_owned())
+                return false;
+
+              Point<dim> cell_min = cell->vertex(0);
+              Point<dim> cell_max = cell->vertex(0);
+              for (unsigned int v=1; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+                for (unsigned int d=0; d<dim; ++d)
+                  {
+                    cell_min[d] = std::min(cell_min[d], cell->vertex(v)[d]);
+                    cell_max[d] = std::max(cell_max[d], cell->vertex(v)[d]);
+                  }
+
+              for (unsigned int d=0; d<dim; ++d)
+                if (cell_max[d] < region_min[d] || cell_min[d] > region_max[d])
+                  return false;
+              return true;
+            };
+
+            const auto next_cell = [in_region] (const Triangulation<dim> &triangulation,
+                                                const cell_iterator &cell) -> cell_iterator
+            {
+              cell_iterator next = cell;
+              ++next;
+              while (next != triangulation.end() && !in_region(next))
+                ++next;
+              return next;
+            };
+
+            const auto first_cell = [in_region] (const Triangulation<dim> &triangulation) -> cell_iterator
+            {
+              cell_iterator cell = triangulation.begin();
+              while (cell != triangulation.end() && !in_region(cell))
+                ++cell;
+              return cell;
+            };
+
+            this->set_cell_selection (first_cell, next_cell);
+          }
+
+          /**
+           * Round all output data to @p mantissa_bits significant bits. The
+           * coordinates of the vertices are not changed. This function
+           * needs to be called after build_patches().
+           */
+          void
+          quantize_data (const unsigned int mantissa_bits)
+          {
+            if (mantissa_bits >= static_cast<unsigned int>(std::numeric_limits<float>::digits) - 1)
+              return;
+
+            for (auto &patch : this->patches)
+              for (unsigned int i=0; i<patch.data.n_rows(); ++i)
+                for (unsigned int j=0; j<patch.data.n_cols(); ++j)
+                  patch.data(i,j) = quantize (patch.data(i,j), mantissa_bits);
+          }
+      };
     }
 
 
@@ -384,6 +504,78 @@ namespace aspect
 
 
 
+    namespace
+    {
+      /**
+       * Combine the VTU files @p vtu_file that every process of the
+       * communicator @p comm has created for its own part of the mesh into
+       * a single file that contains one piece per process. The combined
+       * file is returned on the first process of @p comm, all other
+       * processes return an empty string.
+       */
+      std::string
+      aggregate_vtu_files (const std::string &vtu_file,
+                           const MPI_Comm comm)
+      {
+        // Every file consists of a header, the <Piece> section that
+        // describes the cells of this process, and a footer. Only the
+        // pieces need to be sent to the aggregating process.
+        const std::string piece_end_tag = "</Piece>";
+        const std::size_t pieces_begin = vtu_file.find("<Piece");
+        const std::size_t last_piece_end = vtu_file.rfind(piece_end_tag);
+        const bool found_pieces = (pieces_begin != std::string::npos && last_piece_end != std::string::npos);
+        const std::size_t pieces_end = (found_pieces ? last_piece_end + piece_end_tag.size() : 0);
+        const std::size_t piece_size = (found_pieces ? pieces_end - pieces_begin : 0);
+
+        // Check for errors on all processes together before the first
+        // gather: if only some processes threw an exception, the others
+        // would wait forever for them in the collective calls below.
+        AssertThrow (Utilities::MPI::min (found_pieces ? 1 : 0, comm) == 1,
+                     ExcMessage("Could not find the <Piece> section in the VTU output."));
+        AssertThrow (Utilities::MPI::sum (static_cast<double>(piece_size), comm)
+                     < static_cast<double>(std::numeric_limits<int>::max()),
+                     ExcMessage("The VTU output of a group of processes is too large to be "
+                                "aggregated into one file. Increase the number of grouped files."));
+        const int local_size = piece_size;
+
+        const unsigned int my_rank = Utilities::MPI::this_mpi_process(comm);
+        const unsigned int n_ranks = Utilities::MPI::n_mpi_processes(comm);
+
+        std::vector<int> sizes (my_rank == 0 ? n_ranks : 0);
+        int ierr = MPI_Gather(&local_size, 1, MPI_INT,
+                              sizes.data(), 1, MPI_INT,
+                              0, comm);
+        AssertThrowMPI(ierr);
+
+        // The sum of all sizes was checked to fit into an int above.
+        std::vector<int> offsets (sizes.size());
+        std::size_t total_size = 0;
+        for (unsigned int i=0; i<sizes.size(); ++i)
+          {
+            offsets[i] = total_size;
+            total_size += sizes[i];
+          }
+
+        std::vector<char> pieces (total_size);
+        ierr = MPI_Gatherv(const_cast<char *>(vtu_file.data() + pieces_begin), local_size, MPI_CHAR,
+                           pieces.data(), sizes.data(), offsets.data(), MPI_CHAR,
+                           0, comm);
+        AssertThrowMPI(ierr);
+
+        if (my_rank != 0)
+          return std::string();
+
+        std::string aggregated_file;
+        aggregated_file.reserve(pieces_begin + total_size + (vtu_file.size() - pieces_end));
+        aggregated_file.append(vtu_file, 0, pieces_begin);
+        aggregated_file.append(pieces.begin(), pieces.end());
+        aggregated_file.append(vtu_file, pieces_end, std::string::npos);
+        return aggregated_file;
+      }
+    }
+
+
+
     template <int dim>
     template <typename DataOutType>
     std::string
@@ -459,8 +651,15 @@ namespace aspect
             }
           const unsigned int n_processes = Utilities::MPI::n_mpi_processes(
                                              this->get_mpi_communicator());
-          const unsigned int my_file_id = (
-                                            group_files == 0 ? my_id : my_id % group_files);
+          // If we aggregate grouped files, every file contains the data of
+          // a contiguous block of processes, otherwise the processes are
+          // distributed over the files in a round-robin fashion
+          const unsigned int my_file_id =
+            (group_files == 0 || group_files >= n_processes ?
+             my_id :
+             (aggregate_grouped_files ?
+              static_cast<unsigned int>((static_cast<std::uint64_t>(my_id) * group_files) / n_processes) :
+              my_id % group_files));
           const std::string filename = this->get_output_directory() + "solution/"
                                        + solution_file_prefix + "."
                                        + Utilities::int_to_string(my_file_id, 4) + ".vtu";
@@ -470,6 +669,7 @@ namespace aspect
           vtk_flags.time = time_in_years_or_seconds;
 
           vtk_flags.write_higher_order_cells = write_higher_order_output;
+          vtk_flags.compression_level = vtu_compression_level;
 
           data_out.set_flags(vtk_flags);
           // Write as many files as processes. For this case we support writing in a
@@ -498,6 +698,41 @@ namespace aspect
               else
                 writer(filename, temporary_output_location, file_contents);
             }
+          else if (aggregate_grouped_files)
+            {
+              // Collect the data of all processes that write into the same
+              // file on the first process of the group, which then writes
+              // the file like in the case above, i.e., possibly in a
+              // background thread and to a temporary location.
+              MPI_Comm comm;
+              int ierr = MPI_Comm_split(this->get_mpi_communicator(), my_file_id, my_id, &comm);
+              AssertThrowMPI(ierr);
+
+              std::string aggregated_contents;
+              {
+                std::ostringstream tmp;
+                data_out.write(tmp,
+                               DataOutBase::parse_output_format(output_format));
+                aggregated_contents = aggregate_vtu_files(tmp.str(), comm);
+              }
+              const bool is_aggregator = (Utilities::MPI::this_mpi_process(comm) == 0);
+
+              ierr = MPI_Comm_free(&comm);
+              AssertThrowMPI(ierr);
+
+              if (is_aggregator)
+                {
+                  const std::string *file_contents = new std::string(std::move(aggregated_contents));
+                  if (write_in_background_thread)
+                    {
+                      output_history.background_thread.join();
+                      output_history.background_thread = Threads::new_thread(&writer,
+                                                                             filename, temporary_output_location, file_contents);
+                    }
+                  else
+                    writer(filename, temporary_output_location, file_contents);
+                }
+            }
           else
             // Just write one data file in parallel
             if (group_files == 1)
@@ -580,8 +815,10 @@ namespace aspect
 
       std::unique_ptr<internal::MeshDeformationPostprocessor<dim> > mesh_deformation_variables;
 
-      DataOut<dim> data_out;
+      internal::ReducedDataOut<dim> data_out;
       data_out.attach_dof_handler (this->get_dof_handler());
+      if (restrict_output_region)
+        data_out.select_region (output_region_min, output_region_max);
       data_out.add_data_vector (this->get_solution(),
                                 base_variables);
 
@@ -742,9 +979,10 @@ namespace aspect
                                 DataOut<dim>::curved_inner_cells
                                 :
                                 DataOut<dim>::no_curved_cells);
+        data_out.quantize_data (output_precision_bits);
 
         solution_file_prefix
-          = write_data_out_data(data_out, cell_output_history);
+          = write_data_out_data(static_cast<DataOut<dim> &>(data_out), cell_output_history);
         statistics.add_value ("Visualization file name",
                               this->get_output_directory()
                               + "solution/"
@@ -902,6 +1140,28 @@ namespace aspect
                              "solution, while a larger value will create that many files "
                              "(at most as many as there are MPI ranks).");
 
+          prm.declare_entry ("Aggregate grouped files", "false",
+                             Patterns::Bool(),
+                             "If the ``Number of grouped files'' is larger than zero but "
+                             "smaller than the number of MPI ranks, VTU output files are "
+                             "by default written collectively with MPI I/O. If this parameter "
+                             "is set to `true', the data of each group of processes is instead "
+                             "collected on one aggregator process per file, which then writes "
+                             "the file on its own. Each group consists of a contiguous block "
+                             "of MPI ranks, so that the aggregators are spread evenly across "
+                             "the machine, and the ``Number of grouped files'' determines the "
+                             "number of aggregators. Contrary to MPI I/O, this allows writing "
+                             "grouped files in a background thread and to a temporary output "
+                             "location, but requires the aggregators to hold the output of "
+                             "their whole group in memory.");
+
+          prm.declare_entry ("VTU compression level", "best compression",
+                             Patterns::Selection("none|best speed|default|best compression"),
+                             "The zlib compression level that is used for the data in VTU "
+                             "output files. Higher compression levels produce smaller "
+                             "files, but take longer to write. Choosing a faster level "
+                             "can reduce the time spent writing output considerably.");
+
           prm.declare_entry ("Write in background thread", "false",
                              Patterns::Bool(),
                              "File operations can potentially take a long time, blocking the "
@@ -1010,6 +1270,36 @@ namespace aspect
                              "has its own velocity field.  This may be written as an output field "
                              "by setting this parameter to true.");
 
+          prm.declare_entry ("Output precision bits", "23",
+                             Patterns::Integer(1,23),
+                             "The output data is stored as single precision floating point "
+                             "numbers with 23 bits in the mantissa. If this parameter is "
+                             "set to a smaller value, all output data (but not the coordinates "
+                             "of the mesh) is rounded to this number of significant bits "
+                             "before it is written. Rounded data is compressed much better "
+                             "by the zlib compression of the 'vtu' output format, which can "
+                             "reduce the size of the output files considerably. Other output "
+                             "formats, including 'hdf5', are not compressed, and their size "
+                             "is not reduced by this option. "
+                             "For example, 10 bits retain a relative accuracy of about "
+                             "$10^{-3}$. This option does not affect surface output.");
+
+          prm.declare_entry ("Output region minimum point", "",
+                             Patterns::List(Patterns::Double()),
+                             "The lower corner of a box that restricts the output to the "
+                             "cells that intersect with it. The point needs to be given "
+                             "in Cartesian coordinates, with as many entries as there "
+                             "are spatial dimensions. If this parameter and the ``Output "
+                             "region maximum point'' are empty, the whole domain is written. "
+                             "This option does not affect surface output. "
+                             "Units: \si{\meter}.");
+
+          prm.declare_entry ("Output region maximum point", "",
+                             Patterns::List(Patterns::Double()),
+                             "The upper corner of the box that restricts the output, see "
+                             "``Output region minimum point''. "
+                             "Units: \si{\meter}.");
+
           // Finally also construct a string for Patterns::MultipleSelection that
           // contains the names of all registered visualization postprocessors.
           // Also add a number of removed plugins that are now combined in 'material properties'
@@ -1082,6 +1372,20 @@ namespace aspect
 
           output_format   = prm.get ("Output format");
           group_files     = prm.get_integer("Number of grouped files");
+          aggregate_grouped_files = prm.get_bool("Aggregate grouped files");
+
+          const std::string compression_level = prm.get("VTU compression level");
+          if (compression_level == "none")
+            vtu_compression_level = DataOutBase::VtkFlags::no_compression;
+          else if (compression_level == "best speed")
+            vtu_compression_level = DataOutBase::VtkFlags::best_speed;
+          else if (compression_level == "default")
+            vtu_compression_level = DataOutBase::VtkFlags::default_compression;
+          else if (compression_level == "best compression")
+            vtu_compression_level = DataOutBase::VtkFlags::best_compression;
+          else
+            AssertThrow(false, ExcNotImplemented());
+
           write_in_background_thread = prm.get_bool("Write in background thread");
           temporary_output_location = prm.get("Temporary output location");
 
@@ -1113,6 +1417,32 @@ namespace aspect
             }
 
           output_mesh_velocity = prm.get_bool("Output mesh velocity");
+          output_precision_bits = prm.get_integer("Output precision bits");
+
+          {
+            const std::vector<double> region_min
+              = Utilities::string_to_double(Utilities::split_string_list(prm.get("Output region minimum point")));
+            const std::vector<double> region_max
+              = Utilities::string_to_double(Utilities::split_string_list(prm.get("Output region maximum point")));
+
+            restrict_output_region = (region_min.size() > 0 || region_max.size() > 0);
+            if (restrict_output_region)
+              {
+                AssertThrow(region_min.size() == dim && region_max.size() == dim,
+                            ExcMessage("The parameters 'Output region minimum point' and "
+                                       "'Output region maximum point' need to have exactly "
+                                       "as many entries as there are spatial dimensions."));
+                for (unsigned int d=0; d<dim; ++d)
+                  {
+                    AssertThrow(region_min[d] <= region_max[d],
+                                ExcMessage("Every coordinate of the 'Output region minimum point' "
+                                           "needs to be smaller than the corresponding coordinate "
+                                           "of the 'Output region maximum point'."));
+                    output_region_min[d] = region_min[d];
+                    output_region_max[d] = region_max[d];
+                  }
+              }
+          }
 
           // now also see which derived quantities we are to compute
           viz_names = Utilities::split_string_list(prm.get("List of output variables"));
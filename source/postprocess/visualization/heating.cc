@@ -125,7 +125,7 @@ namespace aspect
                                                                          this->get_solution(),
                                                                          fe_values,
                                                                          this->introspection());
-        this->get_material_model().evaluate(in, out);
+        this->evaluate_material_model(in, out);
 
         if (this->get_parameters().formulation_temperature_equation
             == Parameters<dim>::Formulation::TemperatureEquation::reference_density_profile)
@@ -58,7 +58,7 @@ namespace aspect
                                                      this->n_compositional_fields());
 
         // Compute the viscosity...
-        this->get_material_model().evaluate(in, out);
+        this->evaluate_material_model(in, out);
 
         // ...and use it to compute the stresses
         for (unsigned int q=0; q<n_quadrature_points; ++q)
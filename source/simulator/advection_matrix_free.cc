@@ -0,0 +1,708 @@
+/*
+  Copyright (C) 2020 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <aspect/advection_matrix_free.h>
+#include <aspect/simulator/assemblers/advection.h>
+#include <aspect/mesh_deformation/interface.h>
+
+#include <deal.II/dofs/dof_renumbering.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include <deal.II/fe/fe_values.h>
+
+#include <deal.II/base/function.h>
+#include <deal.II/lac/solver_gmres.h>
+
+
+namespace aspect
+{
+  /**
+   * Implementation of the matrix-free advection operator.
+   */
+  template <int dim, int degree, typename number>
+  MatrixFreeAdvectionOperators::AdvectionOperator<dim,degree,number>::AdvectionOperator ()
+    :
+    MatrixFreeOperators::Base<dim, dealii::LinearAlgebra::distributed::Vector<number> >(),
+    mass_coefficient(nullptr),
+    advection_coefficient(nullptr),
+    diffusion_coefficient(nullptr)
+  {}
+
+  template <int dim, int degree, typename number>
+  void
+  MatrixFreeAdvectionOperators::AdvectionOperator<dim,degree,number>::clear ()
+  {
+    mass_coefficient = nullptr;
+    advection_coefficient = nullptr;
+    diffusion_coefficient = nullptr;
+    MatrixFreeOperators::Base<dim,dealii::LinearAlgebra::distributed::Vector<number> >::clear();
+  }
+
+  template <int dim, int degree, typename number>
+  void
+  MatrixFreeAdvectionOperators::AdvectionOperator<dim,degree,number>::
+  fill_cell_data (const Table<2, VectorizedArray<number>> &mass_coefficient_table,
+                  const Table<2, Tensor<1, dim, VectorizedArray<number>>> &advection_coefficient_table,
+                  const Table<2, VectorizedArray<number>> &diffusion_coefficient_table)
+  {
+    mass_coefficient = &mass_coefficient_table;
+    advection_coefficient = &advection_coefficient_table;
+    diffusion_coefficient = &diffusion_coefficient_table;
+  }
+
+  template <int dim, int degree, typename number>
+  void
+  MatrixFreeAdvectionOperators::AdvectionOperator<dim,degree,number>
+  ::local_apply (const dealii::MatrixFree<dim, number>                 &data,
+                 dealii::LinearAlgebra::distributed::Vector<number>       &dst,
+                 const dealii::LinearAlgebra::distributed::Vector<number> &src,
+                 const std::pair<unsigned int, unsigned int>           &cell_range) const
+  {
+    FEEvaluation<dim,degree,degree+1,1,number> field (data, this->selected_rows[0]);
+
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        field.reinit (cell);
+        field.read_dof_values (src);
+        field.evaluate (true,true,false);
+
+        for (unsigned int q=0; q<field.n_q_points; ++q)
+          {
+            const Tensor<1,dim,VectorizedArray<number>> gradient = field.get_gradient(q);
+
+            field.submit_value ((*mass_coefficient)(cell, q) * field.get_value(q)
+                                + (*advection_coefficient)(cell, q) * gradient, q);
+            field.submit_gradient ((*diffusion_coefficient)(cell, q) * gradient, q);
+          }
+
+        field.integrate (true,true);
+        field.distribute_local_to_global (dst);
+      }
+  }
+
+  template <int dim, int degree, typename number>
+  void
+  MatrixFreeAdvectionOperators::AdvectionOperator<dim,degree,number>
+  ::apply_add (dealii::LinearAlgebra::distributed::Vector<number> &dst,
+               const dealii::LinearAlgebra::distributed::Vector<number> &src) const
+  {
+    MatrixFreeOperators::Base<dim,dealii::LinearAlgebra::distributed::Vector<number> >::
+    data->cell_loop(&AdvectionOperator::local_apply, this, dst, src);
+  }
+
+  template <int dim, int degree, typename number>
+  void
+  MatrixFreeAdvectionOperators::AdvectionOperator<dim,degree,number>
+  ::compute_diagonal ()
+  {
+    this->inverse_diagonal_entries.
+    reset(new DiagonalMatrix<dealii::LinearAlgebra::distributed::Vector<number> >());
+    dealii::LinearAlgebra::distributed::Vector<number> &inverse_diagonal =
+      this->inverse_diagonal_entries->get_vector();
+    this->data->initialize_dof_vector(inverse_diagonal, this->selected_rows[0]);
+    unsigned int dummy = 0;
+    this->data->cell_loop (&AdvectionOperator::local_compute_diagonal, this,
+                           inverse_diagonal, dummy);
+
+    this->set_constrained_entries_to_one(inverse_diagonal);
+
+    for (unsigned int i=0; i<inverse_diagonal.local_size(); ++i)
+      {
+        Assert(inverse_diagonal.local_element(i) > 0.,
+               ExcMessage("No diagonal entry of the advection operator "
+                          "should be zero or negative."));
+        inverse_diagonal.local_element(i) =
+          1./inverse_diagonal.local_element(i);
+      }
+  }
+
+  template <int dim, int degree, typename number>
+  void
+  MatrixFreeAdvectionOperators::AdvectionOperator<dim,degree,number>
+  ::local_compute_diagonal (const MatrixFree<dim,number>                     &data,
+                            dealii::LinearAlgebra::distributed::Vector<number>  &dst,
+                            const unsigned int &,
+                            const std::pair<unsigned int,unsigned int>       &cell_range) const
+  {
+    FEEvaluation<dim,degree,degree+1,1,number> field (data, this->selected_rows[0]);
+
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        field.reinit (cell);
+        AlignedVector<VectorizedArray<number> > diagonal(field.dofs_per_cell);
+        for (unsigned int i=0; i<field.dofs_per_cell; ++i)
+          {
+            for (unsigned int j=0; j<field.dofs_per_cell; ++j)
+              field.begin_dof_values()[j] = VectorizedArray<number>();
+            field.begin_dof_values()[i] = make_vectorized_array<number> (1.);
+
+            field.evaluate (true,true,false);
+            for (unsigned int q=0; q<field.n_q_points; ++q)
+              {
+                const Tensor<1,dim,VectorizedArray<number>> gradient = field.get_gradient(q);
+
+                field.submit_value ((*mass_coefficient)(cell, q) * field.get_value(q)
+                                    + (*advection_coefficient)(cell, q) * gradient, q);
+                field.submit_gradient ((*diffusion_coefficient)(cell, q) * gradient, q);
+              }
+            field.integrate (true,true);
+
+            diagonal[i] = field.begin_dof_values()[i];
+          }
+
+        for (unsigned int i=0; i<field.dofs_per_cell; ++i)
+          field.begin_dof_values()[i] = diagonal[i];
+        field.distribute_local_to_global (dst);
+      }
+  }
+
+
+
+  template <int dim, int degree>
+  AdvectionMatrixFreeHandlerImplementation<dim, degree>::AdvectionMatrixFreeHandlerImplementation (Simulator<dim> &simulator)
+    : sim(simulator),
+
+      dof_handler_temperature(simulator.triangulation),
+      dof_handler_composition(simulator.triangulation),
+
+      fe(degree),
+
+      setup_timestep_number(numbers::invalid_unsigned_int)
+  {
+    AssertThrow(!sim.parameters.include_melt_transport,
+                ExcMessage("The matrix-free advection solver does not support melt transport."));
+    AssertThrow(!sim.parameters.use_discontinuous_temperature_discretization
+                && !sim.parameters.use_discontinuous_composition_discretization,
+                ExcMessage("The matrix-free advection solver requires continuous "
+                           "temperature and composition discretizations."));
+    AssertThrow(sim.parameters.advection_stabilization_method
+                == Parameters<dim>::AdvectionStabilizationMethod::entropy_viscosity,
+                ExcMessage("The matrix-free advection solver only supports the "
+                           "entropy viscosity stabilization method."));
+    AssertThrow(sim.parameters.fixed_heat_flux_boundary_indicators.empty(),
+                ExcMessage("The matrix-free advection solver does not support "
+                           "fixed heat flux boundaries."));
+    AssertThrow(sim.introspection.n_compositional_fields == 0
+                || sim.parameters.composition_degree == sim.parameters.temperature_degree,
+                ExcMessage("The matrix-free advection solver requires the same polynomial "
+                           "degree for temperature and compositional fields, because all "
+                           "fields share one MatrixFree object."));
+
+    // The quadrature used by the matrix-based assembly has
+    // degree + (stokes_velocity_degree+1)/2 points per direction. We
+    // use degree+1 points, which is the same for the supported velocity degrees.
+    AssertThrow(sim.parameters.stokes_velocity_degree <= 2,
+                ExcMessage("The matrix-free advection solver currently only supports "
+                           "a Stokes velocity degree of at most 2."));
+  }
+
+
+
+  template <int dim, int degree>
+  void AdvectionMatrixFreeHandlerImplementation<dim, degree>::setup_dofs()
+  {
+    // The constraints of the matrix-free operators are homogeneous versions of
+    // the constraints in Simulator::current_constraints. The latter may exclude
+    // outflow boundaries from fixed boundaries, which would change the
+    // constraints in every time step. We do not support this.
+    AssertThrow(sim.boundary_temperature_manager.allows_fixed_temperature_on_outflow_boundaries()
+                && sim.boundary_composition_manager.allows_fixed_composition_on_outflow_boundaries(),
+                ExcMessage("The matrix-free advection solver requires that fixed temperature "
+                           "and composition boundary conditions are also applied on "
+                           "outflow boundaries."));
+
+    // Temperature DoFHandler
+    {
+      dof_handler_temperature.clear();
+      dof_handler_temperature.distribute_dofs(fe);
+
+      DoFRenumbering::hierarchical(dof_handler_temperature);
+
+      constraints_temperature.clear();
+      IndexSet locally_relevant_dofs;
+      DoFTools::extract_locally_relevant_dofs (dof_handler_temperature,
+                                               locally_relevant_dofs);
+      constraints_temperature.reinit(locally_relevant_dofs);
+
+      // Periodic constraints have to be set up before the hanging node
+      // constraints, see Simulator::setup_dofs().
+      for (const auto &p : sim.geometry_model->get_periodic_boundary_pairs())
+        DoFTools::make_periodicity_constraints(dof_handler_temperature,
+                                               p.first.first,
+                                               p.first.second,
+                                               p.second,
+                                               constraints_temperature);
+
+      DoFTools::make_hanging_node_constraints (dof_handler_temperature, constraints_temperature);
+
+      for (const auto p : sim.boundary_temperature_manager.get_fixed_temperature_boundary_indicators())
+        VectorTools::interpolate_boundary_values (*sim.mapping,
+                                                  dof_handler_temperature,
+                                                  p,
+                                                  Functions::ZeroFunction<dim>(),
+                                                  constraints_temperature);
+      constraints_temperature.close();
+    }
+
+    // Composition DoFHandler, shared by all compositional fields
+    {
+      dof_handler_composition.clear();
+      dof_handler_composition.distribute_dofs(fe);
+
+      DoFRenumbering::hierarchical(dof_handler_composition);
+
+      constraints_composition.clear();
+      IndexSet locally_relevant_dofs;
+      DoFTools::extract_locally_relevant_dofs (dof_handler_composition,
+                                               locally_relevant_dofs);
+      constraints_composition.reinit(locally_relevant_dofs);
+
+      for (const auto &p : sim.geometry_model->get_periodic_boundary_pairs())
+        DoFTools::make_periodicity_constraints(dof_handler_composition,
+                                               p.first.first,
+                                               p.first.second,
+                                               p.second,
+                                               constraints_composition);
+
+      DoFTools::make_hanging_node_constraints (dof_handler_composition, constraints_composition);
+
+      for (const auto p : sim.boundary_composition_manager.get_fixed_composition_boundary_indicators())
+        VectorTools::interpolate_boundary_values (*sim.mapping,
+                                                  dof_handler_composition,
+                                                  p,
+                                                  Functions::ZeroFunction<dim>(),
+                                                  constraints_composition);
+      constraints_composition.close();
+    }
+
+    setup_operators();
+  }
+
+
+
+  template <int dim, int degree>
+  void AdvectionMatrixFreeHandlerImplementation<dim, degree>::setup_operators()
+  {
+    typename MatrixFree<dim,double>::AdditionalData additional_data;
+    additional_data.tasks_parallel_scheme =
+      MatrixFree<dim,double>::AdditionalData::none;
+    additional_data.mapping_update_flags = (update_values | update_gradients |
+                                            update_JxW_values);
+
+    std::vector<const DoFHandler<dim>*> advection_dofs;
+    advection_dofs.push_back(&dof_handler_temperature);
+    advection_dofs.push_back(&dof_handler_composition);
+    std::vector<const AffineConstraints<double> *> advection_constraints;
+    advection_constraints.push_back(&constraints_temperature);
+    advection_constraints.push_back(&constraints_composition);
+
+    matrix_free.reset(new MatrixFree<dim,double>());
+    matrix_free->reinit(*sim.mapping, advection_dofs, advection_constraints,
+                        QGauss<1>(degree+1), additional_data);
+
+    temperature_matrix.clear();
+    temperature_matrix.initialize(matrix_free, std::vector<unsigned int>(1, 0));
+
+    composition_matrix.clear();
+    composition_matrix.initialize(matrix_free, std::vector<unsigned int>(1, 1));
+
+    setup_timestep_number = sim.timestep_number;
+  }
+
+
+
+  template <int dim, int degree>
+  bool
+  AdvectionMatrixFreeHandlerImplementation<dim, degree>::is_applicable (const typename Simulator<dim>::AdvectionField &advection_field) const
+  {
+    if (advection_field.is_temperature())
+      return true;
+
+    return (advection_field.advection_method(sim.introspection)
+            == Parameters<dim>::AdvectionFieldMethod::fem_field);
+  }
+
+
+
+  template <int dim, int degree>
+  MatrixFreeAdvectionOperators::AdvectionOperator<dim,degree,double> &
+  AdvectionMatrixFreeHandlerImplementation<dim, degree>::get_operator (const typename Simulator<dim>::AdvectionField &advection_field)
+  {
+    return (advection_field.is_temperature() ? temperature_matrix : composition_matrix);
+  }
+
+
+
+  template <int dim, int degree>
+  void
+  AdvectionMatrixFreeHandlerImplementation<dim, degree>::evaluate_material_model (const typename Simulator<dim>::AdvectionField &advection_field)
+  {
+    const Introspection<dim> &introspection = sim.introspection;
+    const QGauss<dim> quadrature_formula (degree+1);
+    const unsigned int n_q_points = quadrature_formula.size();
+    const unsigned int n_cells = matrix_free->n_macro_cells();
+
+    FEValues<dim> fe_values (*sim.mapping,
+                             sim.finite_element,
+                             quadrature_formula,
+                             update_values   |
+                             update_gradients |
+                             update_quadrature_points |
+                             update_JxW_values);
+
+    MaterialModel::MaterialModelInputs<dim> in(n_q_points, introspection.n_compositional_fields);
+    MaterialModel::MaterialModelOutputs<dim> out(n_q_points, introspection.n_compositional_fields);
+    HeatingModel::HeatingModelOutputs heating_model_outputs(n_q_points, introspection.n_compositional_fields);
+
+    for (unsigned int i=0; i<sim.assemblers->advection_system.size(); ++i)
+      sim.assemblers->advection_system[i]->create_additional_material_model_outputs(out);
+
+    sim.heating_model_manager.create_additional_material_model_inputs_and_outputs(in, out);
+
+    Vector<double> viscosity_per_cell(sim.triangulation.n_active_cells());
+    sim.get_artificial_viscosity(viscosity_per_cell, advection_field);
+
+    const bool advection_field_is_temperature = advection_field.is_temperature();
+    const FEValuesExtractors::Scalar solution_field = advection_field.scalar_extractor(introspection);
+
+    const bool   use_bdf2_scheme = (sim.timestep_number > 1);
+    const double time_step = sim.time_step;
+    const double old_time_step = sim.old_time_step;
+
+    const double bdf2_factor = (use_bdf2_scheme)? ((2*time_step + old_time_step) /
+                                                   (time_step + old_time_step)) : 1.0;
+
+    std::vector<double> old_field_values(n_q_points);
+    std::vector<double> old_old_field_values(n_q_points);
+    std::vector<Tensor<1,dim> > current_velocity_values(n_q_points);
+    std::vector<Tensor<1,dim> > mesh_velocity_values(n_q_points);
+
+    mass_coefficient_table.reinit(TableIndices<2>(n_cells, n_q_points));
+    advection_coefficient_table.reinit(TableIndices<2>(n_cells, n_q_points));
+    diffusion_coefficient_table.reinit(TableIndices<2>(n_cells, n_q_points));
+    rhs_table.reinit(TableIndices<2>(n_cells, n_q_points));
+
+    const unsigned int dof_index = (advection_field_is_temperature ? 0 : 1);
+
+    for (unsigned int cell=0; cell<n_cells; ++cell)
+      {
+        const unsigned int n_components_filled = matrix_free->n_components_filled(cell);
+        for (unsigned int i=0; i<n_components_filled; ++i)
+          {
+            typename DoFHandler<dim>::active_cell_iterator matrix_free_cell =
+              matrix_free->get_cell_iterator(cell, i, dof_index);
+            typename DoFHandler<dim>::active_cell_iterator simulator_cell(&sim.triangulation,
+                                                                         matrix_free_cell->level(),
+                                                                         matrix_free_cell->index(),
+                                                                         &sim.dof_handler);
+
+            fe_values.reinit (simulator_cell);
+
+            fe_values[solution_field].get_function_values (sim.old_solution,
+                                                           old_field_values);
+            fe_values[solution_field].get_function_values (sim.old_old_solution,
+                                                           old_old_field_values);
+            fe_values[introspection.extractors.velocities].get_function_values(sim.current_linearization_point,
+                                                                               current_velocity_values);
+
+            // get the mesh velocity, as we need to subtract it off of the advection systems
+            if (sim.parameters.mesh_deformation_enabled)
+              fe_values[introspection.extractors.velocities].get_function_values(sim.mesh_deformation->mesh_velocity,
+                                                                                 mesh_velocity_values);
+
+            sim.compute_material_model_input_values (sim.current_linearization_point,
+                                                     fe_values,
+                                                     simulator_cell,
+                                                     true,
+                                                     in);
+            sim.material_model->fill_additional_material_model_inputs(in,
+                                                                      sim.current_linearization_point,
+                                                                      fe_values,
+                                                                      introspection);
+            sim.material_model->evaluate(in, out);
+
+            if (sim.parameters.formulation_temperature_equation ==
+                Parameters<dim>::Formulation::TemperatureEquation::reference_density_profile)
+              for (unsigned int q=0; q<n_q_points; ++q)
+                out.densities[q] = sim.adiabatic_conditions->density(in.position[q]);
+
+            MaterialModel::MaterialAveraging::average (sim.parameters.material_averaging,
+                                                       simulator_cell,
+                                                       quadrature_formula,
+                                                       *sim.mapping,
+                                                       out);
+
+            sim.heating_model_manager.evaluate(in, out, heating_model_outputs);
+
+            const double artificial_viscosity = viscosity_per_cell[simulator_cell->active_cell_index()];
+            Assert (artificial_viscosity >= 0, ExcMessage ("The artificial viscosity needs to be a non-negative quantity."));
+
+            // The coefficients below are the same as in Assemblers::AdvectionSystem
+            // for the entropy viscosity stabilization method.
+            for (unsigned int q=0; q<n_q_points; ++q)
+              {
+                const double density_c_P =
+                  ((advection_field_is_temperature)
+                   ?
+                   out.densities[q] * out.specific_heat[q]
+                   :
+                   1.0);
+
+                const double latent_heat_LHS =
+                  ((advection_field_is_temperature)
+                   ?
+                   heating_model_outputs.lhs_latent_heat_terms[q]
+                   :
+                   0.0);
+                Assert (density_c_P + latent_heat_LHS >= 0,
+                        ExcMessage ("The sum of density times c_P and the latent heat contribution "
+                                    "to the left hand side needs to be a non-negative quantity."));
+
+                const double gamma =
+                  ((advection_field_is_temperature)
+                   ?
+                   heating_model_outputs.heating_source_terms[q]
+                   :
+                   0.0);
+
+                const double reaction_term =
+                  ((advection_field_is_temperature)
+                   ?
+                   0.0
+                   :
+                   out.reaction_terms[q][advection_field.compositional_variable]);
+
+                const double field_term_for_rhs
+                  = (use_bdf2_scheme ?
+                     (old_field_values[q] *
+                      (1 + time_step/old_time_step)
+                      -
+                      old_old_field_values[q] *
+                      (time_step * time_step) /
+                      (old_time_step * (time_step + old_time_step)))
+                     :
+                     old_field_values[q])
+                    *
+                    (density_c_P + latent_heat_LHS);
+
+                Tensor<1,dim> current_u = current_velocity_values[q];
+                if (sim.parameters.mesh_deformation_enabled)
+                  current_u -= mesh_velocity_values[q];
+
+                const double conductivity = (advection_field_is_temperature
+                                             ?
+                                             out.thermal_conductivities[q]
+                                             :
+                                             0.0);
+
+                const double diffusion_constant = std::max (conductivity, artificial_viscosity);
+
+                mass_coefficient_table(cell, q)[i] = bdf2_factor * (density_c_P + latent_heat_LHS);
+                for (unsigned int d=0; d<dim; ++d)
+                  advection_coefficient_table(cell, q)[d][i] = time_step * (density_c_P + latent_heat_LHS) * current_u[d];
+                diffusion_coefficient_table(cell, q)[i] = time_step * diffusion_constant;
+                rhs_table(cell, q)[i] = field_term_for_rhs + time_step * gamma + reaction_term;
+              }
+          }
+      }
+  }
+
+
+
+  template <int dim, int degree>
+  void
+  AdvectionMatrixFreeHandlerImplementation<dim, degree>::assemble (const typename Simulator<dim>::AdvectionField &advection_field)
+  {
+    Assert (is_applicable(advection_field), ExcInternalError());
+
+    // This class replicates the terms of Assemblers::AdvectionSystem (and
+    // Assemblers::DiffusionSystem, which only contributes to fields that are not
+    // solved here). Make sure no other assemblers have been added, for example
+    // by a plugin.
+    for (unsigned int i=0; i<sim.assemblers->advection_system.size(); ++i)
+      AssertThrow(dynamic_cast<const Assemblers::AdvectionSystem<dim>*>(sim.assemblers->advection_system[i].get()) != nullptr
+                  ||
+                  dynamic_cast<const Assemblers::DiffusionSystem<dim>*>(sim.assemblers->advection_system[i].get()) != nullptr,
+                  ExcMessage("The matrix-free advection solver does not support additional "
+                             "advection assemblers."));
+    AssertThrow(sim.assemblers->advection_system_on_boundary_face.empty()
+                && sim.assemblers->advection_system_on_interior_face.empty(),
+                ExcMessage("The matrix-free advection solver does not support face "
+                           "assemblers for the advection systems."));
+
+    // The mapping changes in every time step if the mesh is deformed.
+    if (sim.parameters.mesh_deformation_enabled
+        && setup_timestep_number != sim.timestep_number)
+      setup_operators();
+
+    evaluate_material_model(advection_field);
+
+    AdvectionMatrixType &advection_matrix = get_operator(advection_field);
+    advection_matrix.fill_cell_data(mass_coefficient_table,
+                                    advection_coefficient_table,
+                                    diffusion_coefficient_table);
+    advection_matrix.compute_diagonal();
+
+    const unsigned int block_idx = advection_field.block_index(sim.introspection);
+    const unsigned int dof_index = (advection_field.is_temperature() ? 0 : 1);
+
+    dealii::LinearAlgebra::distributed::Vector<double> rhs;
+    dealii::LinearAlgebra::distributed::Vector<double> u0;
+    advection_matrix.initialize_dof_vector(rhs);
+    advection_matrix.initialize_dof_vector(u0);
+
+    // The vector u0 is a zero vector, but with correct boundary values.
+    {
+      LinearAlgebra::BlockVector boundary_values (sim.introspection.index_sets.system_partitioning,
+                                                  sim.mpi_communicator);
+      sim.current_constraints.distribute(boundary_values);
+      copy(u0, boundary_values.block(block_idx));
+    }
+    u0.update_ghost_values();
+    rhs = 0;
+
+    // Integrate the right-hand side and, like the matrix-free apply_add()
+    // functions, apply the negative of the operator to u0 to correct for the
+    // inhomogeneous boundary values.
+    FEEvaluation<dim,degree,degree+1,1,double> field (*matrix_free, dof_index);
+
+    for (unsigned int cell=0; cell<matrix_free->n_macro_cells(); ++cell)
+      {
+        // We must use read_dof_values_plain() as to not overwrite boundary information
+        // with the zero boundary used by the advection operator.
+        field.reinit (cell);
+        field.read_dof_values_plain (u0);
+        field.evaluate (true,true,false);
+
+        for (unsigned int q=0; q<field.n_q_points; ++q)
+          {
+            const Tensor<1,dim,VectorizedArray<double>> gradient = field.get_gradient(q);
+
+            field.submit_value (rhs_table(cell, q)
+                                - mass_coefficient_table(cell, q) * field.get_value(q)
+                                - advection_coefficient_table(cell, q) * gradient, q);
+            field.submit_gradient (-diffusion_coefficient_table(cell, q) * gradient, q);
+          }
+
+        field.integrate (true,true);
+        field.distribute_local_to_global (rhs);
+      }
+
+    rhs.compress(VectorOperation::add);
+
+    copy(sim.system_rhs.block(block_idx), rhs);
+  }
+
+
+
+  template <int dim, int degree>
+  double
+  AdvectionMatrixFreeHandlerImplementation<dim, degree>::solve (const typename Simulator<dim>::AdvectionField &advection_field,
+                                                                SolverControl &solver_control,
+                                                                LinearAlgebra::Vector &solution)
+  {
+    const AdvectionMatrixType &advection_matrix = get_operator(advection_field);
+    const unsigned int block_idx = advection_field.block_index(sim.introspection);
+
+    dealii::LinearAlgebra::distributed::Vector<double> solution_copy;
+    dealii::LinearAlgebra::distributed::Vector<double> rhs_copy;
+    dealii::LinearAlgebra::distributed::Vector<double> residual;
+    advection_matrix.initialize_dof_vector(solution_copy);
+    advection_matrix.initialize_dof_vector(rhs_copy);
+    advection_matrix.initialize_dof_vector(residual);
+
+    copy(solution_copy, solution);
+    copy(rhs_copy, sim.system_rhs.block(block_idx));
+
+    // Compute the residual before we solve and return this at the end.
+    // This is used in the nonlinear solver.
+    advection_matrix.vmult(residual, solution_copy);
+    residual.sadd(-1., 1., rhs_copy);
+    const double initial_residual = residual.l2_norm();
+
+    SolverGMRES<dealii::LinearAlgebra::distributed::Vector<double> >
+    solver(solver_control,
+           SolverGMRES<dealii::LinearAlgebra::distributed::Vector<double> >::AdditionalData(sim.parameters.advection_gmres_restart_length,true));
+
+    solver.solve (advection_matrix,
+                  solution_copy,
+                  rhs_copy,
+                  *advection_matrix.get_matrix_diagonal_inverse());
+
+    copy(solution, solution_copy);
+
+    return initial_residual;
+  }
+
+
+
+  template <int dim, int degree>
+  void
+  AdvectionMatrixFreeHandlerImplementation<dim, degree>::copy (dealii::LinearAlgebra::distributed::Vector<double> &out,
+                                                               const LinearAlgebra::Vector &in)
+  {
+    // The loop below relies on both vectors using the same DoF numbering and
+    // parallel partitioning. This is cheap to check compared to the solve, so
+    // also check it in release mode instead of silently scrambling the vector.
+    AssertThrow(out.locally_owned_elements() == in.locally_owned_elements(),
+                ExcMessage("The matrix-free advection solver requires the same parallel "
+                           "partitioning for its vectors as the Simulator."));
+
+    for (const auto idx : in.locally_owned_elements())
+      out(idx) = in(idx);
+  }
+
+
+
+  template <int dim, int degree>
+  void
+  AdvectionMatrixFreeHandlerImplementation<dim, degree>::copy (LinearAlgebra::Vector &out,
+                                                               const dealii::LinearAlgebra::distributed::Vector<double> &in)
+  {
+    AssertThrow(out.locally_owned_elements() == in.locally_owned_elements(),
+                ExcMessage("The matrix-free advection solver requires the same parallel "
+                           "partitioning for its vectors as the Simulator."));
+
+    for (const auto idx : out.locally_owned_elements())
+      out(idx) = in(idx);
+
+    out.compress(VectorOperation::insert);
+  }
+}
+
+
+
+// explicit instantiation of the functions we implement in this file
+namespace aspect
+{
+#define INSTANTIATE(dim) \
+  template class AdvectionMatrixFreeHandler<dim>; \
+  template class AdvectionMatrixFreeHandlerImplementation<dim,1>; \
+  template class AdvectionMatrixFreeHandlerImplementation<dim,2>; \
+  template class AdvectionMatrixFreeHandlerImplementation<dim,3>;
+
+  ASPECT_INSTANTIATE(INSTANTIATE)
+
+#undef INSTANTIATE
+}
@@ -213,20 +213,21 @@ namespace aspect
                    ) * JxW;
 
 
-              for (unsigned int j=0; j<advection_dofs_per_cell; ++j)
-                {
-                  data.local_matrix(i,j)
-                  += (
-                       (time_step * diffusion_constant
-                        * (scratch.grad_phi_field[i] * scratch.grad_phi_field[j]))
-                       + ((time_step * (scratch.phi_field[i] * (current_u * scratch.grad_phi_field[j])))
-                          + (bdf2_factor * scratch.phi_field[i] * scratch.phi_field[j])) *
-                       (density_c_P + latent_heat_LHS)
-                     )
-                     * JxW;
-                }
-
-              if (use_supg)
+              if (scratch.assemble_local_matrix)
+                for (unsigned int j=0; j<advection_dofs_per_cell; ++j)
+                  {
+                    data.local_matrix(i,j)
+                    += (
+                         (time_step * diffusion_constant
+                          * (scratch.grad_phi_field[i] * scratch.grad_phi_field[j]))
+                         + ((time_step * (scratch.phi_field[i] * (current_u * scratch.grad_phi_field[j])))
+                            + (bdf2_factor * scratch.phi_field[i] * scratch.phi_field[j])) *
+                         (density_c_P + latent_heat_LHS)
+                       )
+                       * JxW;
+                  }
+
+              if (use_supg && scratch.assemble_local_matrix)
                 {
                   for (unsigned int j=0; j<advection_dofs_per_cell; ++j)
                     {
@@ -365,15 +366,16 @@ namespace aspect
                  *
                  JxW;
 
-              for (unsigned int j=0; j<advection_dofs_per_cell; ++j)
-                {
-                  data.local_matrix(i,j)
-                  += (parameters.diffusion_length_scale * parameters.diffusion_length_scale *
-                      (scratch.grad_phi_field[i] * scratch.grad_phi_field[j])
-                      + (scratch.phi_field[i] * scratch.phi_field[j])
-                     )
-                     * JxW;
-                }
+              if (scratch.assemble_local_matrix)
+                for (unsigned int j=0; j<advection_dofs_per_cell; ++j)
+                  {
+                    data.local_matrix(i,j)
+                    += (parameters.diffusion_length_scale * parameters.diffusion_length_scale *
+                        (scratch.grad_phi_field[i] * scratch.grad_phi_field[j])
+                        + (scratch.phi_field[i] * scratch.phi_field[j])
+                       )
+                       * JxW;
+                  }
             }
         }
     }
@@ -269,7 +269,9 @@ namespace aspect
           face_heating_model_outputs(face_quadrature.size(), n_compositional_fields),
           neighbor_face_heating_model_outputs(face_quadrature.size(), n_compositional_fields),
           advection_field(&field),
-          artificial_viscosity(numbers::signaling_nan<double>())
+          artificial_viscosity(numbers::signaling_nan<double>()),
+          assemble_matrix(true),
+          assemble_local_matrix(true)
         {}
 
 
@@ -353,7 +355,9 @@ namespace aspect
           face_heating_model_outputs(scratch.face_heating_model_outputs),
           neighbor_face_heating_model_outputs(scratch.neighbor_face_heating_model_outputs),
           advection_field(scratch.advection_field),
-          artificial_viscosity(scratch.artificial_viscosity)
+          artificial_viscosity(scratch.artificial_viscosity),
+          assemble_matrix(scratch.assemble_matrix),
+          assemble_local_matrix(scratch.assemble_local_matrix)
         {}
 
 
@@ -33,6 +33,7 @@
 #include <aspect/simulator/assemblers/advection.h>
 
 #include <aspect/stokes_matrix_free.h>
+#include <aspect/advection_matrix_free.h>
 
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/work_stream.h>
@@ -44,6 +45,11 @@
 #include <deal.II/dofs/dof_tools.h>
 #include <deal.II/fe/fe_values.h>
 
+#ifndef ASPECT_USE_PETSC
+#include <Epetra_MultiVector.h>
+#include <Teuchos_ParameterList.hpp>
+#endif
+
 #include <limits>
 
 
@@ -525,12 +531,31 @@ namespace aspect
         Mp_preconditioner_AMG->initialize (system_preconditioner_matrix.block(1,1), Amg_data);
       }
 
-    if (parameters.use_full_A_block_preconditioner)
-      Amg_preconditioner->initialize (system_matrix.block(0,0),
-                                      Amg_data);
+    const LinearAlgebra::SparseMatrix &A_block_matrix = (parameters.use_full_A_block_preconditioner
+                                                         ?
+                                                         system_matrix.block(0,0)
+                                                         :
+                                                         system_preconditioner_matrix.block(0,0));
+
+#ifndef ASPECT_USE_PETSC
+    if (parameters.AMG_use_unsmoothed_aggregation)
+      {
+        // Let ML use the tentative prolongation without smoothing it. This
+        // results in much sparser coarse level matrices, which reduces the
+        // memory footprint of the hierarchy and the memory traffic of
+        // every application of the preconditioner.
+        Teuchos::ParameterList parameter_list;
+        std::unique_ptr<Epetra_MultiVector> distributed_constant_modes;
+        Amg_data.set_parameters (parameter_list,
+                                 distributed_constant_modes,
+                                 A_block_matrix.trilinos_matrix());
+        parameter_list.set ("aggregation: damping factor", 0.);
+
+        Amg_preconditioner->initialize (A_block_matrix, parameter_list);
+      }
     else
-      Amg_preconditioner->initialize (system_preconditioner_matrix.block(0,0),
-                                      Amg_data);
+#endif
+      Amg_preconditioner->initialize (A_block_matrix, Amg_data);
 
     rebuild_stokes_preconditioner = false;
 
@@ -889,6 +914,18 @@ namespace aspect
         ++i;
       }
 
+    // If we only assemble the right hand side, we still need the local
+    // matrix on cells with inhomogeneous constraints to apply them
+    // to the right hand side.
+    scratch.assemble_local_matrix = scratch.assemble_matrix;
+    if (!scratch.assemble_matrix)
+      for (unsigned int i=0; i<advection_dofs_per_cell; ++i)
+        if (current_constraints.is_inhomogeneously_constrained(data.local_dof_indices[i]))
+          {
+            scratch.assemble_local_matrix = true;
+            break;
+          }
+
     data.local_matrix = 0;
     data.local_rhs = 0;
 
@@ -1128,32 +1165,62 @@ namespace aspect
 
   template <int dim>
   void Simulator<dim>::assemble_advection_system (const AdvectionField &advection_field)
+  {
+    Vector<double> viscosity_per_cell;
+    {
+      TimerOutput::Scope timer (computing_timer, (advection_field.is_temperature() ?
+                                                  "Assemble temperature system" :
+                                                  "Assemble composition system"));
+
+      // The matrix-free advection solver computes the right-hand side itself
+      // and never builds the matrix.
+      if (advection_matrix_free && advection_matrix_free->is_applicable(advection_field))
+        {
+          advection_matrix_free->assemble(advection_field);
+          return;
+        }
+
+      viscosity_per_cell.reinit(triangulation.n_active_cells());
+      get_artificial_viscosity(viscosity_per_cell, advection_field);
+    }
+
+    assemble_advection_system (advection_field, viscosity_per_cell, true);
+  }
+
+
+
+  template <int dim>
+  void Simulator<dim>::assemble_advection_system (const AdvectionField &advection_field,
+                                                  const Vector<double> &viscosity_per_cell,
+                                                  const bool assemble_matrix)
   {
     TimerOutput::Scope timer (computing_timer, (advection_field.is_temperature() ?
                                                 "Assemble temperature system" :
                                                 "Assemble composition system"));
 
+    Assert (!advection_matrix_free || !advection_matrix_free->is_applicable(advection_field),
+            ExcInternalError());
+
     const unsigned int block_idx = advection_field.block_index(introspection);
 
-    if (!advection_field.is_temperature() && advection_field.compositional_variable!=0)
+    if (assemble_matrix)
       {
-        // Allocate the system matrix for the current compositional field by
-        // reusing the Trilinos sparsity pattern from the matrix stored for
-        // composition 0 (this is the place we allocate the matrix at).
-        const unsigned int block0_idx = AdvectionField::composition(0).block_index(introspection);
-        system_matrix.block(block_idx, block_idx).reinit(system_matrix.block(block0_idx, block0_idx));
-      }
+        if (!advection_field.is_temperature() && advection_field.compositional_variable!=0)
+          {
+            // Allocate the system matrix for the current compositional field by
+            // reusing the Trilinos sparsity pattern from the matrix stored for
+            // composition 0 (this is the place we allocate the matrix at).
+            const unsigned int block0_idx = AdvectionField::composition(0).block_index(introspection);
+            system_matrix.block(block_idx, block_idx).reinit(system_matrix.block(block0_idx, block0_idx));
+          }
 
-    system_matrix.block(block_idx, block_idx) = 0;
+        system_matrix.block(block_idx, block_idx) = 0;
+      }
     system_rhs.block(block_idx) = 0;
 
 
     using CellFilter = FilteredIterator<typename DoFHandler<dim>::active_cell_iterator>;
 
-    Vector<double> viscosity_per_cell;
-    viscosity_per_cell.reinit(triangulation.n_active_cells());
-    get_artificial_viscosity(viscosity_per_cell, advection_field);
-
     // We have to assemble the term u.grad phi_i * phi_j, which is
     // of total polynomial degree
     //   stokes_deg + 2*temp_deg -1
@@ -1204,9 +1271,36 @@ namespace aspect
 
     auto copier = [&](const internal::Assembly::CopyData::AdvectionSystem<dim> &data)
     {
-      this->copy_local_to_global_advection_system(advection_field, data);
+      if (assemble_matrix)
+        this->copy_local_to_global_advection_system(advection_field, data);
+      else
+        // only copy the right hand side, but still use the local matrix
+        // to account for inhomogeneous constraints (if the local matrix
+        // was not computed, the cell has no inhomogeneous constraints and
+        // the matrix is not used)
+        current_constraints.distribute_local_to_global (data.local_rhs,
+                                                        data.local_dof_indices,
+                                                        system_rhs,
+                                                        data.local_matrix);
     };
 
+    internal::Assembly::Scratch::
+    AdvectionSystem<dim> scratch (finite_element,
+                                  finite_element.base_element(advection_field.base_element(introspection)),
+                                  *mapping,
+                                  QGauss<dim>(advection_quadrature_degree),
+                                  /* Only generate a valid face quadrature if necessary.
+                                   * Otherwise, generate invalid face quadrature rule.
+                                   */
+                                  (allocate_face_quadrature ?
+                                   QGauss<dim-1>(advection_quadrature_degree) :
+                                   Quadrature<dim-1> ()),
+                                  update_flags,
+                                  face_update_flags,
+                                  introspection.n_compositional_fields,
+                                  advection_field);
+    scratch.assemble_matrix = assemble_matrix;
+
     WorkStream::
     run (CellFilter (IteratorFilters::LocallyOwnedCell(),
                      dof_handler.begin_active()),
@@ -1214,26 +1308,13 @@ namespace aspect
                      dof_handler.end()),
          worker,
          copier,
-         internal::Assembly::Scratch::
-         AdvectionSystem<dim> (finite_element,
-                               finite_element.base_element(advection_field.base_element(introspection)),
-                               *mapping,
-                               QGauss<dim>(advection_quadrature_degree),
-                               /* Only generate a valid face quadrature if necessary.
-                                * Otherwise, generate invalid face quadrature rule.
-                                */
-                               (allocate_face_quadrature ?
-                                QGauss<dim-1>(advection_quadrature_degree) :
-                                Quadrature<dim-1> ()),
-                               update_flags,
-                               face_update_flags,
-                               introspection.n_compositional_fields,
-                               advection_field),
+         scratch,
          internal::Assembly::CopyData::
          AdvectionSystem<dim> (finite_element.base_element(advection_field.base_element(introspection)),
                                allocate_neighbor_contributions));
 
-    system_matrix.compress(VectorOperation::add);
+    if (assemble_matrix)
+      system_matrix.compress(VectorOperation::add);
     system_rhs.compress(VectorOperation::add);
   }
 }
@@ -1273,6 +1354,9 @@ namespace aspect
                                                                         const AdvectionField          &advection_field, \
                                                                         const internal::Assembly::CopyData::AdvectionSystem<dim> &data); \
   template void Simulator<dim>::assemble_advection_system (const AdvectionField     &advection_field); \
+  template void Simulator<dim>::assemble_advection_system (const AdvectionField     &advection_field, \
+                                                           const Vector<double>     &viscosity_per_cell, \
+                                                           const bool                assemble_matrix); \
   template void Simulator<dim>::compute_material_model_input_values ( \
                                                                       const LinearAlgebra::BlockVector                      &input_solution, \
                                                                       const FEValuesBase<dim,dim>                           &input_finite_element_values, \
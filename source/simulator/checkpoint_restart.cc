@@ -23,8 +23,11 @@
 #include <aspect/utilities.h>
 #include <aspect/mesh_deformation/interface.h>
 #include <aspect/melt.h>
+#include <aspect/stokes_matrix_free.h>
 
 #include <deal.II/base/mpi.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/thread_management.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/distributed/solution_transfer.h>
 
@@ -32,6 +35,10 @@
 #  include <zlib.h>
 #endif
 
+#include <functional>
+#include <list>
+#include <streambuf>
+
 namespace aspect
 {
   namespace
@@ -69,6 +76,330 @@ namespace aspect
   }
 
 
+#ifdef DEAL_II_WITH_ZLIB
+  namespace
+  {
+    /**
+     * The size of the uncompressed chunks the resume file is split into.
+     * Each chunk is compressed independently, so that the chunks can be
+     * compressed and uncompressed in parallel.
+     */
+    const unsigned int checkpoint_chunk_size = 16*1024*1024;
+
+
+
+    /**
+     * Compress one chunk of data with zlib.
+     */
+    std::vector<char> compress_chunk (const std::vector<char> &data)
+    {
+      uLongf compressed_data_length = compressBound (data.size());
+      std::vector<char> compressed_data (compressed_data_length);
+      const int err = compress2 ((Bytef *) &compressed_data[0],
+                                 &compressed_data_length,
+                                 (const Bytef *) data.data(),
+                                 data.size(),
+                                 Z_BEST_COMPRESSION);
+      AssertThrow (err == Z_OK,
+                   ExcMessage (std::string("Compressing the data buffer resulted in an error with code <")
+                               +
+                               Utilities::int_to_string(err)
+                               +
+                               ">."));
+
+      compressed_data.resize (compressed_data_length);
+      return compressed_data;
+    }
+
+
+
+    /**
+     * Uncompress one chunk of data with zlib. @p uncompressed_size is the
+     * size of the chunk before compression.
+     */
+    std::vector<char> uncompress_chunk (const std::vector<char> &compressed_data,
+                                        const uint32_t uncompressed_size)
+    {
+      std::vector<char> data (uncompressed_size);
+      uLongf data_length = uncompressed_size;
+      const int err = uncompress ((Bytef *) data.data(), &data_length,
+                                  (const Bytef *) compressed_data.data(), compressed_data.size());
+      AssertThrow (err == Z_OK && data_length == uncompressed_size,
+                   ExcMessage (std::string("Uncompressing the data buffer resulted in an error with code <")
+                               +
+                               Utilities::int_to_string(err)
+                               +
+                               ">."));
+      return data;
+    }
+
+
+
+    /**
+     * A stream buffer that collects the data written into it in chunks of
+     * size checkpoint_chunk_size, and compresses every full chunk on a
+     * separate task while the serialization continues. This way, we never
+     * hold an uncompressed copy of the whole serialized state in memory.
+     * At most as many chunks as there are threads are compressed at the
+     * same time.
+     *
+     * If @p discard_data is true, the data is thrown away instead of
+     * compressed. This is used on all processes but the root process.
+     */
+    class CompressingStreamBuffer : public std::streambuf
+    {
+      public:
+        CompressingStreamBuffer (const bool discard_data)
+          :
+          discard_data (discard_data),
+          buffer (checkpoint_chunk_size),
+          last_chunk_size (0)
+        {
+          setp (buffer.data(), buffer.data() + buffer.size());
+        }
+
+        /**
+         * Compress the last, partially filled chunk, wait for all
+         * compression tasks to finish, and write the header and all
+         * compressed chunks to @p out. The header has the same layout as
+         * the one of the single-chunk format of previous versions: the
+         * number of chunks, the size of a chunk, the size of the last chunk,
+         * and the compressed size of every chunk.
+         */
+        void write (std::ostream &out)
+        {
+          Assert (discard_data == false, ExcInternalError());
+
+          last_chunk_size = pptr() - pbase();
+          if (last_chunk_size > 0 || compressed_chunks.size() + pending_chunks.size() == 0)
+            start_compression();
+          else
+            last_chunk_size = checkpoint_chunk_size;
+
+          while (pending_chunks.size() > 0)
+            finish_oldest_compression();
+
+          std::vector<uint32_t> compression_header (3 + compressed_chunks.size());
+          compression_header[0] = compressed_chunks.size();
+          compression_header[1] = (compressed_chunks.size() > 1
+                                   ?
+                                   checkpoint_chunk_size
+                                   :
+                                   last_chunk_size);
+          compression_header[2] = last_chunk_size;
+          for (unsigned int i=0; i<compressed_chunks.size(); ++i)
+            compression_header[3+i] = compressed_chunks[i].size();
+
+          out.write ((const char *)compression_header.data(),
+                     compression_header.size() * sizeof(compression_header[0]));
+          for (const auto &chunk : compressed_chunks)
+            out.write (chunk.data(), chunk.size());
+        }
+
+      protected:
+        int_type overflow (int_type ch) override
+        {
+          start_compression();
+
+          if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            {
+              *pptr() = traits_type::to_char_type(ch);
+              pbump(1);
+            }
+          return traits_type::not_eof(ch);
+        }
+
+      private:
+        /**
+         * Hand the data currently in the buffer to a new compression task
+         * and reset the buffer.
+         */
+        void start_compression ()
+        {
+          if (discard_data == false)
+            {
+              if (pending_chunks.size() >= MultithreadInfo::n_threads())
+                finish_oldest_compression();
+
+              auto chunk = std::make_shared<std::vector<char>> (pbase(), pptr());
+              pending_chunks.push_back (Threads::new_task (std::function<std::vector<char> ()>(
+                                                             [chunk] ()
+              {
+                return compress_chunk(*chunk);
+              })));
+            }
+
+          setp (buffer.data(), buffer.data() + buffer.size());
+        }
+
+        void finish_oldest_compression ()
+        {
+          pending_chunks.front().join();
+          compressed_chunks.emplace_back (std::move(pending_chunks.front().return_value()));
+          pending_chunks.pop_front();
+        }
+
+        const bool discard_data;
+        std::vector<char> buffer;
+        uint32_t last_chunk_size;
+        std::list<Threads::Task<std::vector<char>>> pending_chunks;
+        std::vector<std::vector<char>> compressed_chunks;
+    };
+
+
+
+    /**
+     * A stream buffer that reads a file written by CompressingStreamBuffer
+     * and uncompresses it one chunk after the other. While the current
+     * chunk is deserialized, the next one is already uncompressed on a
+     * separate task.
+     */
+    class DecompressingStreamBuffer : public std::streambuf
+    {
+      public:
+        DecompressingStreamBuffer (std::istream &in)
+          :
+          in (in),
+          next_chunk (0)
+        {
+          uint32_t header[3];
+          in.read ((char *)header, 3 * sizeof(header[0]));
+          AssertThrow (in && header[0] > 0,
+                       ExcMessage ("Cannot read the header of the snapshot resume file."));
+
+          n_chunks = header[0];
+          chunk_size = header[1];
+          last_chunk_size = header[2];
+
+          compressed_sizes.resize (n_chunks);
+          in.read ((char *)compressed_sizes.data(), n_chunks * sizeof(compressed_sizes[0]));
+          AssertThrow (in,
+                       ExcMessage ("Cannot read the header of the snapshot resume file."));
+
+          start_decompression();
+        }
+
+      protected:
+        int_type underflow () override
+        {
+          if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+
+          if (pending_chunk.joinable() == false)
+            return traits_type::eof();
+
+          pending_chunk.join();
+          current_chunk = std::move(pending_chunk.return_value());
+          pending_chunk = Threads::Task<std::vector<char>>();
+          start_decompression();
+
+          setg (current_chunk.data(), current_chunk.data(), current_chunk.data() + current_chunk.size());
+          return traits_type::to_int_type(*gptr());
+        }
+
+      private:
+        /**
+         * Read the next compressed chunk from the file, if there is one
+         * left, and start a task that uncompresses it.
+         */
+        void start_decompression ()
+        {
+          if (next_chunk == n_chunks)
+            return;
+
+          auto compressed_chunk = std::make_shared<std::vector<char>> (compressed_sizes[next_chunk]);
+          in.read (compressed_chunk->data(), compressed_chunk->size());
+          AssertThrow (in,
+                       ExcMessage ("Cannot read the snapshot resume file."));
+
+          const uint32_t uncompressed_size = (next_chunk == n_chunks-1
+                                              ?
+                                              last_chunk_size
+                                              :
+                                              chunk_size);
+          pending_chunk = Threads::new_task (std::function<std::vector<char> ()>(
+                                               [compressed_chunk, uncompressed_size] ()
+          {
+            return uncompress_chunk(*compressed_chunk, uncompressed_size);
+          }));
+
+          ++next_chunk;
+        }
+
+        std::istream &in;
+        uint32_t n_chunks;
+        uint32_t chunk_size;
+        uint32_t last_chunk_size;
+        std::vector<uint32_t> compressed_sizes;
+        uint32_t next_chunk;
+        Threads::Task<std::vector<char>> pending_chunk;
+        std::vector<char> current_chunk;
+    };
+  }
+#endif
+
+
+  namespace
+  {
+    /**
+     * Rename the files of a snapshot that has just been written completely
+     * to put the new one in place of the old one. The previous snapshot is
+     * kept with the suffix '.old'. Since renaming is cheap compared to
+     * writing, restart remains usable even if the model is cancelled while
+     * the new snapshot is being written.
+     */
+    void install_new_snapshot (const std::string &output_directory,
+                               const bool resume_computation)
+    {
+      // if we have previously written a snapshot, then keep the last
+      // snapshot in case this one fails to save. Note: static variables
+      // will only be initialized once per model run.
+      static bool previous_snapshot_exists = (resume_computation == true);
+
+      if (previous_snapshot_exists == true)
+        {
+          move_file (output_directory + "restart.mesh",
+                     output_directory + "restart.mesh.old");
+          move_file (output_directory + "restart.mesh.info",
+                     output_directory + "restart.mesh.info.old");
+          move_file (output_directory + "restart.resume.z",
+                     output_directory + "restart.resume.z.old");
+
+          move_file (output_directory + "restart.mesh_fixed.data",
+                     output_directory + "restart.mesh_fixed.data.old");
+
+          if (Utilities::fexists(output_directory + "restart.mesh_variable.data"))
+            {
+              move_file (output_directory + "restart.mesh_variable.data",
+                         output_directory + "restart.mesh_variable.data.old");
+            }
+
+        }
+
+      move_file (output_directory + "restart.mesh.new",
+                 output_directory + "restart.mesh");
+      move_file (output_directory + "restart.mesh.new.info",
+                 output_directory + "restart.mesh.info");
+      move_file (output_directory + "restart.resume.z.new",
+                 output_directory + "restart.resume.z");
+
+      move_file (output_directory + "restart.mesh.new_fixed.data",
+                 output_directory + "restart.mesh_fixed.data");
+
+      if (Utilities::fexists(output_directory + "restart.mesh.new_variable.data"))
+        {
+          move_file (output_directory + "restart.mesh.new_variable.data",
+                     output_directory + "restart.mesh_variable.data");
+        }
+
+      // from now on, we know that if we get into this
+      // function again that a snapshot has previously
+      // been written
+      previous_snapshot_exists = true;
+    }
+  }
+
+
   namespace
   {
     /**
@@ -264,6 +595,10 @@ namespace aspect
     TimerOutput::Scope timer (computing_timer, "Create snapshot");
     const unsigned int my_id = Utilities::MPI::this_mpi_process (mpi_communicator);
 
+    // If the previous snapshot is still being written in the background,
+    // wait for it to finish before we overwrite its temporary files.
+    checkpoint_thread.join();
+
     // save Triangulation and Solution vectors:
     {
       std::vector<const LinearAlgebra::BlockVector *> x_system (3);
@@ -307,52 +642,36 @@ namespace aspect
     // save general information This calls the serialization functions on all
     // processes (so that they can take additional action, if necessary, see
     // the manual) but only writes to the restart file on process 0
+    std::function<void ()> write_resume_file;
     {
-      std::ostringstream oss;
-
-      // serialize into a stringstream
-      aspect::oarchive oa (oss);
-      save_critical_parameters (this->parameters, oa);
-      oa << (*this);
-
-      // compress with zlib and write to file on the root processor
 #ifdef DEAL_II_WITH_ZLIB
-      if (my_id == 0)
-        {
-          uLongf compressed_data_length = compressBound (oss.str().length());
-          std::vector<char *> compressed_data (compressed_data_length);
-          int err = compress2 ((Bytef *) &compressed_data[0],
-                               &compressed_data_length,
-                               (const Bytef *) oss.str().data(),
-                               oss.str().length(),
-                               Z_BEST_COMPRESSION);
-          (void)err;
-          Assert (err == Z_OK, ExcInternalError());
-
-          // build compression header
-          const uint32_t compression_header[4]
-            = { 1,                                   /* number of blocks */
-                (uint32_t)oss.str().length(), /* size of block */
-                (uint32_t)oss.str().length(), /* size of last block */
-                (uint32_t)compressed_data_length
-              }; /* list of compressed sizes of blocks */
-
-          std::ofstream f ((parameters.output_directory + "restart.resume.z.new").c_str());
-          f.write((const char *)compression_header, 4 * sizeof(compression_header[0]));
-          f.write((char *)&compressed_data[0], compressed_data_length);
-          f.close();
-
-          // We check the fail state of the stream _after_ closing the file to
-          // make sure the writes were completed correctly. This also catches
-          // the cases where the file could not be opened in the first place
-          // or one of the write() commands fails, as the fail state is
-          // "sticky".
-          if (!f)
-            AssertThrow(false, ExcMessage ("Writing of the checkpoint file '" + parameters.output_directory
-                                           + "restart.resume.z.new' with size "
-                                           + Utilities::to_string(4 * sizeof(compression_header[0])+compressed_data_length)
-                                           + " failed on processor 0."));
-        }
+      // Serialize into a stream that compresses the data in chunks while
+      // the serialization is still going on. The compressed chunks are
+      // written to file on the root processor further down.
+      auto buffer = std::make_shared<CompressingStreamBuffer> (my_id != 0);
+      {
+        std::ostream os (buffer.get());
+        aspect::oarchive oa (os);
+        save_critical_parameters (this->parameters, oa);
+        oa << (*this);
+      }
+
+      const std::string filename = parameters.output_directory + "restart.resume.z.new";
+      write_resume_file = [buffer, filename] ()
+      {
+        std::ofstream f (filename.c_str(), std::ios::binary);
+        buffer->write (f);
+        f.close();
+
+        // We check the fail state of the stream _after_ closing the file to
+        // make sure the writes were completed correctly. This also catches
+        // the cases where the file could not be opened in the first place
+        // or one of the write() commands fails, as the fail state is
+        // "sticky".
+        if (!f)
+          AssertThrow(false, ExcMessage ("Writing of the checkpoint file '" + filename
+                                         + "' failed on processor 0."));
+      };
 #else
       AssertThrow (false,
                    ExcMessage ("You need to have deal.II configured with the `libz' "
@@ -366,62 +685,34 @@ namespace aspect
     const int ierr = MPI_Barrier(mpi_communicator);
     AssertThrowMPI(ierr);
 
-    // Now rename the snapshots to put the new one in place of the old one.
-    // Do this after writing the new one, because writing large checkpoints
-    // can be slow, and the model might be cancelled during writing.
-    // This way restart remains usable even if restart.new is not completely
-    // written.
+    // Now write the general information on the root processor and rename
+    // the snapshots to put the new one in place of the old one. Do this
+    // after writing the new one, because writing large checkpoints can be
+    // slow, and the model might be cancelled during writing. This way
+    // restart remains usable even if restart.new is not completely written.
+    // All data written here has already been copied into memory above, so
+    // this can happen in the background while the computation continues.
     if (my_id == 0)
       {
-        // if we have previously written a snapshot, then keep the last
-        // snapshot in case this one fails to save. Note: static variables
-        // will only be initialized once per model run.
-        static bool previous_snapshot_exists = (parameters.resume_computation == true);
-
-        if (previous_snapshot_exists == true)
-          {
-            move_file (parameters.output_directory + "restart.mesh",
-                       parameters.output_directory + "restart.mesh.old");
-            move_file (parameters.output_directory + "restart.mesh.info",
-                       parameters.output_directory + "restart.mesh.info.old");
-            move_file (parameters.output_directory + "restart.resume.z",
-                       parameters.output_directory + "restart.resume.z.old");
-
-            move_file (parameters.output_directory + "restart.mesh_fixed.data",
-                       parameters.output_directory + "restart.mesh_fixed.data.old");
-
-            if (Utilities::fexists(parameters.output_directory + "restart.mesh_variable.data"))
-              {
-                move_file (parameters.output_directory + "restart.mesh_variable.data",
-                           parameters.output_directory + "restart.mesh_variable.data.old");
-              }
-
-          }
-
-        move_file (parameters.output_directory + "restart.mesh.new",
-                   parameters.output_directory + "restart.mesh");
-        move_file (parameters.output_directory + "restart.mesh.new.info",
-                   parameters.output_directory + "restart.mesh.info");
-        move_file (parameters.output_directory + "restart.resume.z.new",
-                   parameters.output_directory + "restart.resume.z");
-
-        move_file (parameters.output_directory + "restart.mesh.new_fixed.data",
-                   parameters.output_directory + "restart.mesh_fixed.data");
-
-        if (Utilities::fexists(parameters.output_directory + "restart.mesh.new_variable.data"))
-          {
-            move_file (parameters.output_directory + "restart.mesh.new_variable.data",
-                       parameters.output_directory + "restart.mesh_variable.data");
-          }
-
-
-        // from now on, we know that if we get into this
-        // function again that a snapshot has previously
-        // been written
-        previous_snapshot_exists = true;
+        const std::string output_directory = parameters.output_directory;
+        const bool resume_computation = parameters.resume_computation;
+        const std::function<void ()> write_snapshot
+          = [write_resume_file, output_directory, resume_computation] ()
+        {
+          write_resume_file();
+          install_new_snapshot (output_directory, resume_computation);
+        };
+
+        if (parameters.write_checkpoint_in_background_thread)
+          checkpoint_thread = Threads::new_thread (write_snapshot);
+        else
+          write_snapshot();
       }
 
-    pcout << "*** Snapshot created!" << std::endl << std::endl;
+    if (parameters.write_checkpoint_in_background_thread)
+      pcout << "*** Snapshot created, writing it to disk in the background!" << std::endl << std::endl;
+    else
+      pcout << "*** Snapshot created!" << std::endl << std::endl;
   }
 
 
@@ -505,37 +796,32 @@ namespace aspect
         mesh_deformation_trans.deserialize (fs_system);
         mesh_deformation->mesh_displacements = distributed_mesh_displacements;
         mesh_deformation->initial_topography = distributed_initial_topography;
+
+        // The matrix-free Stokes operators need to know about the
+        // deformed mesh we just read back in.
+        if (stokes_matrix_free)
+          {
+            mesh_deformation->update_multilevel_deformation();
+            stokes_matrix_free->setup_operators();
+          }
       }
 
-    // read zlib compressed resume.z
+    // read zlib compressed resume.z, one chunk at a time
     try
       {
 #ifdef DEAL_II_WITH_ZLIB
-        std::ifstream ifs ((parameters.output_directory + "restart.resume.z").c_str());
+        std::ifstream ifs ((parameters.output_directory + "restart.resume.z").c_str(),
+                           std::ios::binary);
         AssertThrow(ifs.is_open(),
                     ExcMessage("Cannot open snapshot resume file."));
 
-        uint32_t compression_header[4];
-        ifs.read((char *)compression_header, 4 * sizeof(compression_header[0]));
-        Assert(compression_header[0]==1, ExcInternalError());
-
-        std::vector<char> compressed(compression_header[3]);
-        std::vector<char> uncompressed(compression_header[1]);
-        ifs.read(&compressed[0],compression_header[3]);
-        uLongf uncompressed_size = compression_header[1];
-
-        const int err = uncompress((Bytef *)&uncompressed[0], &uncompressed_size,
-                                   (Bytef *)&compressed[0], compression_header[3]);
-        AssertThrow (err == Z_OK,
-                     ExcMessage (std::string("Uncompressing the data buffer resulted in an error with code <")
-                                 +
-                                 Utilities::int_to_string(err)));
-
+        // Files written by previous versions consist of a single chunk,
+        // and can be read in the same way.
         {
-          std::istringstream ss;
-          ss.str(std::string (&uncompressed[0], uncompressed_size));
+          DecompressingStreamBuffer buffer (ifs);
+          std::istream is (&buffer);
 
-          aspect::iarchive ia (ss);
+          aspect::iarchive ia (is);
           load_and_check_critical_parameters(this->parameters, ia);
           ia >> (*this);
         }
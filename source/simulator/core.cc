@@ -26,6 +26,7 @@
 #include <aspect/volume_of_fluid/handler.h>
 #include <aspect/newton.h>
 #include <aspect/stokes_matrix_free.h>
+#include <aspect/advection_matrix_free.h>
 #include <aspect/mesh_deformation/interface.h>
 #include <aspect/citation_info.h>
 #include <aspect/postprocess/particles.h>
@@ -416,6 +417,25 @@ namespace aspect
 
       }
 
+    if (parameters.advection_solver_type == Parameters<dim>::AdvectionSolverType::matrix_free)
+      {
+        switch (parameters.temperature_degree)
+          {
+            case 1:
+              advection_matrix_free = std_cxx14::make_unique<AdvectionMatrixFreeHandlerImplementation<dim,1>>(*this);
+              break;
+            case 2:
+              advection_matrix_free = std_cxx14::make_unique<AdvectionMatrixFreeHandlerImplementation<dim,2>>(*this);
+              break;
+            case 3:
+              advection_matrix_free = std_cxx14::make_unique<AdvectionMatrixFreeHandlerImplementation<dim,3>>(*this);
+              break;
+            default:
+              AssertThrow(false, ExcMessage("The finite element degree for the temperature and composition "
+                                            "systems you selected is not supported by the matrix-free advection solver."));
+          }
+      }
+
     postprocess_manager.initialize_simulator (*this);
     postprocess_manager.parse_parameters (prm);
 
@@ -482,6 +502,9 @@ namespace aspect
     // object in each time step.
     statistics.set_auto_fill_mode(true);
 
+    material_model_output_cache.set_memory_limit(static_cast<std::size_t>(parameters.material_model_output_cache_size
+                                                                          * 1024 * 1024));
+
     // finally produce a record of the run-time parameters by writing
     // the currently used values into a file
     // Only write the parameter files on the root node to avoid file system conflicts
@@ -532,6 +555,9 @@ namespace aspect
     // object (set from the output_statistics() function)
     output_statistics_thread.join();
 
+    // also wait for a checkpoint that may still be written in the background
+    checkpoint_thread.join();
+
     // If an exception is being thrown (for example due to AssertThrow()), we
     // might end up here with currently active timing sections. The destructor
     // of TimerOutput does MPI communication, which can lead to deadlocks,
@@ -548,6 +574,10 @@ namespace aspect
   Simulator<dim>::
   start_timestep ()
   {
+    // the solution will change in this time step, so forget about the
+    // material model outputs of the previous one
+    material_model_output_cache.clear();
+
     // first produce some output for the screen to show where we are
     {
       const char *unit = (parameters.convert_to_years ? "years" : "seconds");
@@ -837,16 +867,21 @@ namespace aspect
 
 
     template <int dim>
-    bool compositional_fields_need_matrix_block(const Introspection<dim> &introspection)
+    bool compositional_fields_need_matrix_block(const Introspection<dim> &introspection,
+                                                const bool fem_fields_are_matrix_free)
     {
       // Check if any compositional field method actually requires a matrix block
-      // (as opposed to all are advected by other means or prescribed fields)
+      // (as opposed to all are advected by other means, prescribed fields, or
+      // solved by the matrix-free advection solver)
       for (unsigned int c=0; c<introspection.n_compositional_fields; ++c)
         {
           const typename Simulator<dim>::AdvectionField adv_field (Simulator<dim>::AdvectionField::composition(c));
           switch (adv_field.advection_method(introspection))
             {
               case Parameters<dim>::AdvectionFieldMethod::fem_field:
+                if (!fem_fields_are_matrix_free)
+                  return true;
+                break;
               case Parameters<dim>::AdvectionFieldMethod::fem_melt_field:
               case Parameters<dim>::AdvectionFieldMethod::prescribed_field_with_diffusion:
                 return true;
@@ -952,16 +987,19 @@ namespace aspect
           }
       }
 
-    // Only enable temperature coupling if temperature block is needed
+    // Only enable temperature coupling if temperature block is needed. The
+    // matrix-free advection solver does not need a matrix block.
     if (solver_scheme_solves_advection_equations(parameters)
         &&
-        parameters.temperature_method != Parameters<dim>::AdvectionFieldMethod::prescribed_field)
+        parameters.temperature_method != Parameters<dim>::AdvectionFieldMethod::prescribed_field
+        &&
+        !advection_matrix_free)
       coupling[x.temperature][x.temperature] = DoFTools::always;
 
     // Only enable composition coupling if a composition block is needed
     if (solver_scheme_solves_advection_equations(parameters)
         &&
-        compositional_fields_need_matrix_block(introspection))
+        compositional_fields_need_matrix_block(introspection, advection_matrix_free != nullptr))
       {
         // If we need at least one compositional field block, we
         // create a matrix block in the first compositional block. Its sparsity
@@ -1019,7 +1057,7 @@ namespace aspect
 
         if (parameters.use_discontinuous_composition_discretization &&
             solver_scheme_solves_advection_equations(parameters) &&
-            compositional_fields_need_matrix_block(introspection))
+            compositional_fields_need_matrix_block(introspection, advection_matrix_free != nullptr))
           face_coupling[x.compositional_fields[0]][x.compositional_fields[0]] = DoFTools::always;
 
         if (parameters.volume_of_fluid_tracking_enabled)
@@ -1323,6 +1361,10 @@ namespace aspect
 
     TimerOutput::Scope timer (computing_timer, "Setup dof systems");
 
+    // the mesh has changed, so the outputs of the material model
+    // stored for the old cells are no longer valid
+    material_model_output_cache.clear();
+
     dof_handler.distribute_dofs(finite_element);
 
     // Renumber the DoFs hierarchical so that we get the
@@ -1439,6 +1481,9 @@ namespace aspect
     // Setup matrix-free dofs
     if (stokes_matrix_free)
       stokes_matrix_free->setup_dofs();
+
+    if (advection_matrix_free)
+      advection_matrix_free->setup_dofs();
   }
 
 
@@ -1508,6 +1553,12 @@ namespace aspect
     TimerOutput::Scope timer (computing_timer, "Postprocessing");
     pcout << "   Postprocessing:" << std::endl;
 
+    // The solution may have changed since the material model output cache
+    // was last used (for example in the previous nonlinear iteration), so
+    // start over. The cached outputs are then shared between all
+    // postprocessors and the mesh refinement criteria that run afterwards.
+    material_model_output_cache.clear();
+
     // run all the postprocessing routines and then write
     // the current state of the statistics table to a file
     std::list<std::pair<std::string,std::string> >
@@ -1730,6 +1781,14 @@ namespace aspect
           mesh_deformation->mesh_displacements = distributed_mesh_displacements;
           mesh_deformation->mesh_vertex_constraints.distribute (distributed_initial_topography);
           mesh_deformation->initial_topography = distributed_initial_topography;
+
+          // The matrix-free Stokes operators were set up in setup_dofs()
+          // before the displacements were transferred to the new mesh.
+          if (stokes_matrix_free)
+            {
+              mesh_deformation->update_multilevel_deformation();
+              stokes_matrix_free->setup_operators();
+            }
         }
 
       // Possibly load data of plugins associated with cells
@@ -2038,6 +2097,7 @@ namespace aspect
     CitationInfo::print_info_block (pcout);
 
     stokes_matrix_free.reset();
+    advection_matrix_free.reset();
   }
 }
 
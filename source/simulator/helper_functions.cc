@@ -39,6 +39,7 @@
 #include <deal.II/base/conditional_ostream.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/signaling_nan.h>
+#include <deal.II/base/work_stream.h>
 #include <deal.II/lac/block_sparsity_pattern.h>
 #include <deal.II/grid/grid_tools.h>
 
@@ -60,6 +61,7 @@
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include <locale>
 #include <string>
 
@@ -1477,6 +1479,189 @@ namespace aspect
 
 
 
+  namespace
+  {
+    /**
+     * The objects needed to evaluate the material and heating models for
+     * the reactions on one finite element (the one used for the
+     * compositional fields, or the one used for the temperature) on a batch
+     * of cells. If a batch only contains a single cell, the material model
+     * inputs of that cell are used directly. Otherwise, the inputs of all
+     * cells are copied into one set of inputs, so that the material model
+     * can evaluate all points of the batch at once.
+     */
+    template <int dim>
+    struct ReactionElementData
+    {
+      ReactionElementData (const Mapping<dim>                  &mapping,
+                           const FiniteElement<dim>            &finite_element,
+                           const Quadrature<dim>               &quadrature,
+                           const unsigned int                   n_compositional_fields,
+                           const unsigned int                   n_cells_per_batch,
+                           const MaterialModel::Interface<dim> &material_model,
+                           const HeatingModel::Manager<dim>    &heating_model_manager);
+
+      ReactionElementData (const ReactionElementData &data);
+
+      /**
+       * Compute the material model inputs on @p cell, and copy them into
+       * the batched inputs at the position of the @p index_in_batch th cell
+       * if necessary.
+       */
+      void reinit (const typename DoFHandler<dim>::active_cell_iterator &cell,
+                   const unsigned int index_in_batch,
+                   const Introspection<dim> &introspection,
+                   const LinearAlgebra::BlockVector &solution);
+
+      /**
+       * Return the inputs that contain all points of the batch.
+       */
+      MaterialModel::MaterialModelInputs<dim> &inputs ();
+
+      const unsigned int n_cells_per_batch;
+      const MaterialModel::Interface<dim> &material_model;
+      const HeatingModel::Manager<dim> &heating_model_manager;
+
+      FEValues<dim> fe_values;
+      MaterialModel::MaterialModelInputs<dim> cell_inputs;
+      MaterialModel::MaterialModelInputs<dim> batch_inputs;
+      MaterialModel::MaterialModelOutputs<dim> outputs;
+      HeatingModel::HeatingModelOutputs heating_model_outputs;
+    };
+
+
+
+    template <int dim>
+    ReactionElementData<dim>::
+    ReactionElementData (const Mapping<dim>                  &mapping,
+                         const FiniteElement<dim>            &finite_element,
+                         const Quadrature<dim>               &quadrature,
+                         const unsigned int                   n_compositional_fields,
+                         const unsigned int                   n_cells_per_batch,
+                         const MaterialModel::Interface<dim> &material_model,
+                         const HeatingModel::Manager<dim>    &heating_model_manager)
+      :
+      n_cells_per_batch (n_cells_per_batch),
+      material_model (material_model),
+      heating_model_manager (heating_model_manager),
+      fe_values (mapping,
+                 finite_element,
+                 quadrature,
+                 update_quadrature_points | update_values | update_gradients),
+      cell_inputs (quadrature.size(), n_compositional_fields),
+      batch_inputs ((n_cells_per_batch > 1 ? n_cells_per_batch * quadrature.size() : 0),
+                    n_compositional_fields),
+      outputs (n_cells_per_batch * quadrature.size(), n_compositional_fields),
+      heating_model_outputs (n_cells_per_batch * quadrature.size(), n_compositional_fields)
+    {
+      // add reaction rate outputs, and the additional outputs some heating
+      // models require
+      material_model.create_additional_named_outputs(outputs);
+      heating_model_manager.create_additional_material_model_inputs_and_outputs(inputs(), outputs);
+    }
+
+
+
+    template <int dim>
+    ReactionElementData<dim>::
+    ReactionElementData (const ReactionElementData &data)
+      :
+      ReactionElementData (data.fe_values.get_mapping(),
+                           data.fe_values.get_fe(),
+                           data.fe_values.get_quadrature(),
+                           data.cell_inputs.composition[0].size(),
+                           data.n_cells_per_batch,
+                           data.material_model,
+                           data.heating_model_manager)
+    {}
+
+
+
+    template <int dim>
+    MaterialModel::MaterialModelInputs<dim> &
+    ReactionElementData<dim>::inputs ()
+    {
+      return (n_cells_per_batch > 1 ? batch_inputs : cell_inputs);
+    }
+
+
+
+    template <int dim>
+    void
+    ReactionElementData<dim>::reinit (const typename DoFHandler<dim>::active_cell_iterator &cell,
+                                      const unsigned int index_in_batch,
+                                      const Introspection<dim> &introspection,
+                                      const LinearAlgebra::BlockVector &solution)
+    {
+      fe_values.reinit (cell);
+      cell_inputs.reinit (fe_values, cell, introspection, solution);
+
+      if (n_cells_per_batch == 1)
+        return;
+
+      const unsigned int n_points = cell_inputs.n_evaluation_points();
+      for (unsigned int q=0; q<n_points; ++q)
+        {
+          const unsigned int i = index_in_batch * n_points + q;
+          batch_inputs.position[i] = cell_inputs.position[q];
+          batch_inputs.temperature[i] = cell_inputs.temperature[q];
+          batch_inputs.pressure[i] = cell_inputs.pressure[q];
+          batch_inputs.pressure_gradient[i] = cell_inputs.pressure_gradient[q];
+          batch_inputs.velocity[i] = cell_inputs.velocity[q];
+          batch_inputs.composition[i] = cell_inputs.composition[q];
+          batch_inputs.strain_rate[i] = cell_inputs.strain_rate[q];
+        }
+    }
+
+
+
+    /**
+     * Scratch data for computing the reactions on a batch of cells.
+     */
+    template <int dim>
+    struct ReactionScratchData
+    {
+      ReactionScratchData (const Mapping<dim>                  &mapping,
+                           const FiniteElement<dim>            &finite_element,
+                           const Quadrature<dim>               &quadrature_C,
+                           const Quadrature<dim>               &quadrature_T,
+                           const unsigned int                   n_compositional_fields,
+                           const unsigned int                   n_cells_per_batch,
+                           const MaterialModel::Interface<dim> &material_model,
+                           const HeatingModel::Manager<dim>    &heating_model_manager)
+        :
+        composition (mapping, finite_element, quadrature_C, n_compositional_fields,
+                     n_cells_per_batch, material_model, heating_model_manager),
+        temperature (mapping, finite_element, quadrature_T, n_compositional_fields,
+                     n_cells_per_batch, material_model, heating_model_manager)
+      {}
+
+      ReactionElementData<dim> composition;
+      ReactionElementData<dim> temperature;
+    };
+
+
+
+    /**
+     * The results of the reactions on a batch of cells: for every cell, its
+     * degree of freedom indices, and the new values and the accumulated
+     * reactions of the compositional fields and the temperature at the
+     * support points of the respective element.
+     */
+    template <int dim>
+    struct ReactionCopyData
+    {
+      std::vector<std::vector<types::global_dof_index> > local_dof_indices;
+      std::vector<std::vector<std::vector<double> > > composition_values;
+      std::vector<std::vector<std::vector<double> > > composition_reactions;
+      std::vector<std::vector<double> > temperature_values;
+      std::vector<std::vector<double> > temperature_reactions;
+      unsigned int n_reaction_steps;
+    };
+  }
+
+
+
   template <int dim>
   void Simulator<dim>::compute_reactions ()
   {
@@ -1506,145 +1691,350 @@ namespace aspect
 
     pcout << "   Solving composition reactions... " << std::flush;
 
-    // make one fevalues for the composition, and one for the temperature (they might use different finite elements)
-    const Quadrature<dim> quadrature_C(dof_handler.get_fe().base_element(introspection.base_elements.compositional_fields).get_unit_support_points());
+    const unsigned int n_fields = introspection.n_compositional_fields;
 
-    FEValues<dim> fe_values_C (*mapping,
-                               dof_handler.get_fe(),
-                               quadrature_C,
-                               update_quadrature_points | update_values | update_gradients);
-
-    std::vector<types::global_dof_index> local_dof_indices (dof_handler.get_fe().dofs_per_cell);
-    MaterialModel::MaterialModelInputs<dim> in_C(quadrature_C.size(), introspection.n_compositional_fields);
-    MaterialModel::MaterialModelOutputs<dim> out_C(quadrature_C.size(), introspection.n_compositional_fields);
-    HeatingModel::HeatingModelOutputs heating_model_outputs_C(quadrature_C.size(), introspection.n_compositional_fields);
+    // we evaluate the reactions at the support points of the composition and of the
+    // temperature element (they might use different finite elements)
+    const Quadrature<dim> quadrature_C(dof_handler.get_fe().base_element(introspection.base_elements.compositional_fields).get_unit_support_points());
+    const Quadrature<dim> quadrature_T(dof_handler.get_fe().base_element(introspection.base_elements.temperature).get_unit_support_points());
 
     const bool temperature_and_composition_use_same_fe =
       (parameters.use_discontinuous_composition_discretization == parameters.use_discontinuous_temperature_discretization)
       &&
       (parameters.temperature_degree == parameters.composition_degree);
 
-    // temperature element
-    const Quadrature<dim> quadrature_T(dof_handler.get_fe().base_element(introspection.base_elements.temperature).get_unit_support_points());
+    const bool use_adaptive_reaction_solver
+      = (parameters.reaction_solver_type == Parameters<dim>::ReactionSolverType::adaptive);
 
-    FEValues<dim> fe_values_T (*mapping,
-                               dof_handler.get_fe(),
-                               quadrature_T,
-                               update_quadrature_points | update_values | update_gradients);
+    // Check that the material model supports operator splitting, and whether we can
+    // evaluate several cells at once: this is not possible if any of the heating
+    // models requires additional material model inputs, because these are computed
+    // from the finite element solution on one cell.
+    unsigned int n_cells_per_batch = parameters.reaction_solver_cells_per_batch;
+    {
+      MaterialModel::MaterialModelInputs<dim> in(1, n_fields);
+      MaterialModel::MaterialModelOutputs<dim> out(1, n_fields);
+      material_model->create_additional_named_outputs(out);
+      heating_model_manager.create_additional_material_model_inputs_and_outputs(in, out);
+
+      AssertThrow(out.template get_additional_output<MaterialModel::ReactionRateOutputs<dim> >() != nullptr,
+                  ExcMessage("You are trying to use the operator splitting solver scheme, "
+                             "but the material model you use does not support operator splitting "
+                             "(it does not create ReactionRateOutputs, which are required for this "
+                             "solver scheme)."));
+
+      if (in.additional_inputs.size() > 0)
+        n_cells_per_batch = 1;
+    }
 
-    MaterialModel::MaterialModelInputs<dim> in_T(quadrature_T.size(), introspection.n_compositional_fields);
-    MaterialModel::MaterialModelOutputs<dim> out_T(quadrature_T.size(), introspection.n_compositional_fields);
-    HeatingModel::HeatingModelOutputs heating_model_outputs_T(quadrature_T.size(), introspection.n_compositional_fields);
+    // Integrate the reactions over the time step for all points of one element on a
+    // batch of cells, and return the number of reaction time steps that were necessary.
+    // The new values of the compositional fields and the temperature are stored in the
+    // material model inputs, and the changes due to the reactions are added up in
+    // @p accumulated_reactions, where the temperature is stored as the last component.
+    //
+    // The fixed step scheme uses the forward Euler method with the same step size for
+    // all points. The adaptive scheme uses an embedded Runge-Kutta scheme of second
+    // order (Heun's method), using the difference to the forward Euler step as the
+    // error estimate. Every point has its own time and step size, so that points with
+    // slow reactions take large steps. The material model is still evaluated for all
+    // points of the batch at once; points that have already reached the end of the
+    // time step simply keep their values.
+    const auto integrate_reactions
+      = [&](ReactionElementData<dim> &data,
+            std::vector<std::vector<double> > &accumulated_reactions) -> unsigned int
+    {
+      MaterialModel::MaterialModelInputs<dim> &in = data.inputs();
+      const unsigned int n_points = in.n_evaluation_points();
+      const double relative_tolerance = parameters.reaction_solver_relative_tolerance;
+      const double absolute_tolerance = parameters.reaction_solver_absolute_tolerance;
 
-    // add reaction rate outputs
-    material_model->create_additional_named_outputs(out_C);
-    material_model->create_additional_named_outputs(out_T);
+      const MaterialModel::ReactionRateOutputs<dim> &reaction_rate_outputs
+        = *data.outputs.template get_additional_output<MaterialModel::ReactionRateOutputs<dim> >();
 
-    MaterialModel::ReactionRateOutputs<dim> *reaction_rate_outputs_C
-      = out_C.template get_additional_output<MaterialModel::ReactionRateOutputs<dim> >();
+      // the rates of change of all compositional fields and of the temperature
+      // (stored as the last component) at the current inputs
+      const auto compute_rates = [&](std::vector<std::vector<double> > &rates)
+      {
+        material_model->fill_additional_material_model_inputs(in, solution, data.fe_values, introspection);
+        material_model->evaluate(in, data.outputs);
+        heating_model_manager.evaluate(in, data.outputs, data.heating_model_outputs);
 
-    MaterialModel::ReactionRateOutputs<dim> *reaction_rate_outputs_T
-      = out_T.template get_additional_output<MaterialModel::ReactionRateOutputs<dim> >();
+        for (unsigned int j=0; j<n_points; ++j)
+          {
+            for (unsigned int c=0; c<n_fields; ++c)
+              rates[j][c] = reaction_rate_outputs.reaction_rates[j][c];
+            rates[j][n_fields] = data.heating_model_outputs.rates_of_temperature_change[j];
+          }
+      };
 
-    AssertThrow(reaction_rate_outputs_C != nullptr && reaction_rate_outputs_T != nullptr,
-                ExcMessage("You are trying to use the operator splitting solver scheme, "
-                           "but the material model you use does not support operator splitting "
-                           "(it does not create ReactionRateOutputs, which are required for this "
-                           "solver scheme)."));
+      const auto set_inputs = [&](const std::vector<std::vector<double> > &values)
+      {
+        for (unsigned int j=0; j<n_points; ++j)
+          {
+            for (unsigned int c=0; c<n_fields; ++c)
+              in.composition[j][c] = values[j][c];
+            in.temperature[j] = values[j][n_fields];
+          }
+      };
 
-    // some heating models require the additional outputs
-    heating_model_manager.create_additional_material_model_inputs_and_outputs(in_C, out_C);
-    heating_model_manager.create_additional_material_model_inputs_and_outputs(in_T, out_T);
+      std::vector<std::vector<double> > values (n_points, std::vector<double>(n_fields+1));
+      for (unsigned int j=0; j<n_points; ++j)
+        {
+          for (unsigned int c=0; c<n_fields; ++c)
+            values[j][c] = in.composition[j][c];
+          values[j][n_fields] = in.temperature[j];
+        }
 
-    // Make a loop first over all cells, than over all reaction time steps, and then over
-    // all degrees of freedom in each element to compute the reactions. This is possible
-    // because the reactions only depend on the temperature and composition values at a given
-    // degree of freedom (and are independent of the solution in other points).
+      accumulated_reactions.assign (n_points, std::vector<double>(n_fields+1, 0.));
 
-    // Note that the values for some degrees of freedom are set more than once in the loop
-    // below where we assign the new values to distributed_vector (if they are located on the
-    // interface between cells), as we loop over all cells, and then over all degrees of freedom
-    // on each cell. Although this means we do some additional work, the results are still
-    // correct, as we never read from distributed_vector inside the loop over all cells.
-    // We initialize the material model inputs objects in_T and in_C using the solution vector
-    // on every cell, compute the update, and then on every cell put the result into the
-    // distributed_vector vector. Only after the loop over all cells do we copy distributed_vector
-    // back onto the solution vector.
-    // So even though we touch some DoF more than once, we always start from the same value, compute the
-    // same value, and then overwrite the same value in distributed_vector.
-    // TODO: make this more efficient.
-    for (const auto &cell : dof_handler.active_cell_iterators())
-      if (cell->is_locally_owned())
+      std::vector<std::vector<double> > rates_1 (n_points, std::vector<double>(n_fields+1));
+
+      if (use_adaptive_reaction_solver == false)
         {
-          fe_values_C.reinit (cell);
-          in_C.reinit(fe_values_C, cell, introspection, solution);
+          for (unsigned int i=0; i<number_of_reaction_steps; ++i)
+            {
+              compute_rates(rates_1);
 
-          if (temperature_and_composition_use_same_fe == false)
+              // simple forward euler
+              for (unsigned int j=0; j<n_points; ++j)
+                for (unsigned int c=0; c<=n_fields; ++c)
+                  {
+                    values[j][c] = values[j][c] + reaction_time_step_size * rates_1[j][c];
+                    accumulated_reactions[j][c] += reaction_time_step_size * rates_1[j][c];
+                  }
+              set_inputs(values);
+            }
+
+          return number_of_reaction_steps;
+        }
+
+      std::vector<std::vector<double> > rates_2 (n_points, std::vector<double>(n_fields+1));
+      std::vector<std::vector<double> > euler_values = values;
+
+      // If no reaction changes any value by more than the absolute tolerance
+      // within the whole time step, a single forward Euler step is accurate
+      // enough and we do not need to do anything else for these cells.
+      compute_rates(rates_1);
+      bool reactions_are_negligible = true;
+      for (unsigned int j=0; j<n_points && reactions_are_negligible; ++j)
+        for (unsigned int c=0; c<=n_fields; ++c)
+          if (time_step * std::abs(rates_1[j][c]) > absolute_tolerance)
             {
-              fe_values_T.reinit (cell);
-              in_T.reinit(fe_values_T, cell, introspection, solution);
+              reactions_are_negligible = false;
+              break;
             }
 
-          std::vector<std::vector<double> > accumulated_reactions_C (quadrature_C.size(),std::vector<double> (introspection.n_compositional_fields));
-          std::vector<double> accumulated_reactions_T (quadrature_T.size());
+      if (reactions_are_negligible)
+        {
+          for (unsigned int j=0; j<n_points; ++j)
+            for (unsigned int c=0; c<=n_fields; ++c)
+              {
+                values[j][c] += time_step * rates_1[j][c];
+                accumulated_reactions[j][c] = time_step * rates_1[j][c];
+              }
+          set_inputs(values);
+          return 1;
+        }
 
-          // Make the reaction time steps: We have to update the values of compositional fields and the temperature.
-          // Because temperature and composition might use different finite elements, we loop through their elements
-          // separately, and update the temperature and the compositions for both.
-          // We can reuse the same material model inputs and outputs structure for each reaction time step.
-          // We store the computed updates to temperature and composition in a separate (accumulated_reactions) vector,
-          // so that we can later copy it over to the solution vector.
-          for (unsigned int i=0; i<number_of_reaction_steps; ++i)
+      std::vector<double> time (n_points, 0.);
+      std::vector<double> step_size (n_points, time_step);
+      std::vector<unsigned int> n_steps (n_points, 0);
+
+      const auto is_finished = [&](const unsigned int j)
+      {
+        return time[j] >= time_step * (1. - 1e-12);
+      };
+
+      bool first_iteration = true;
+      while (true)
+        {
+          bool all_finished = true;
+          for (unsigned int j=0; j<n_points; ++j)
+            if (!is_finished(j))
+              all_finished = false;
+          if (all_finished)
+            break;
+
+          // the rates at the beginning of the step, which we have
+          // already computed in the first iteration
+          if (first_iteration == false)
             {
-              // Loop over composition element
-              material_model->fill_additional_material_model_inputs(in_C, solution, fe_values_C, introspection);
+              set_inputs(values);
+              compute_rates(rates_1);
+            }
+          first_iteration = false;
+
+          // forward Euler predictor
+          for (unsigned int j=0; j<n_points; ++j)
+            for (unsigned int c=0; c<=n_fields; ++c)
+              euler_values[j][c] = values[j][c] + (is_finished(j) ? 0. : step_size[j] * rates_1[j][c]);
+          set_inputs(euler_values);
+          compute_rates(rates_2);
+
+          // Heun corrector and error control
+          for (unsigned int j=0; j<n_points; ++j)
+            if (!is_finished(j))
+              {
+                double error = 0;
+                for (unsigned int c=0; c<=n_fields; ++c)
+                  {
+                    const double new_value = values[j][c] + 0.5 * step_size[j] * (rates_1[j][c] + rates_2[j][c]);
+                    const double scale = absolute_tolerance
+                                         + relative_tolerance * std::max(std::abs(values[j][c]), std::abs(new_value));
+                    const double component_error = std::abs(new_value - euler_values[j][c]) / scale;
+
+                    // std::max() would silently drop a NaN, so treat a non-finite
+                    // error as infinitely large. This rejects the step and reduces
+                    // the step size as much as possible.
+                    if (!std::isfinite(component_error))
+                      {
+                        error = std::numeric_limits<double>::infinity();
+                        break;
+                      }
+                    error = std::max(error, component_error);
+                  }
 
-              material_model->evaluate(in_C, out_C);
-              heating_model_manager.evaluate(in_C, out_C, heating_model_outputs_C);
+                if (error <= 1.)
+                  {
+                    for (unsigned int c=0; c<=n_fields; ++c)
+                      {
+                        const double reaction = 0.5 * step_size[j] * (rates_1[j][c] + rates_2[j][c]);
+                        values[j][c] += reaction;
+                        accumulated_reactions[j][c] += reaction;
+                      }
+                    time[j] += step_size[j];
+                    ++n_steps[j];
+                  }
 
-              for (unsigned int j=0; j<dof_handler.get_fe().base_element(introspection.base_elements.compositional_fields).dofs_per_cell; ++j)
-                {
-                  for (unsigned int c=0; c<introspection.n_compositional_fields; ++c)
-                    {
-                      // simple forward euler
-                      in_C.composition[j][c] = in_C.composition[j][c]
-                                               + reaction_time_step_size * reaction_rate_outputs_C->reaction_rates[j][c];
-                      accumulated_reactions_C[j][c] += reaction_time_step_size * reaction_rate_outputs_C->reaction_rates[j][c];
-                    }
-                  in_C.temperature[j] = in_C.temperature[j]
-                                        + reaction_time_step_size * heating_model_outputs_C.rates_of_temperature_change[j];
+                // The error estimate is of first order, so the optimal step
+                // size scales with the inverse square root of the error.
+                // Limit the change of the step size to make the step size
+                // control more robust.
+                const double factor = (error > 0
+                                       ?
+                                       std::min(5., std::max(0.2, 0.9 / std::sqrt(error)))
+                                       :
+                                       5.);
+                step_size[j] = std::min(factor * step_size[j], time_step - time[j]);
+
+                AssertThrow (is_finished(j) || step_size[j] > 1e-12 * time_step,
+                             ExcMessage("The adaptive reaction solver could not find a time step size "
+                                        "that satisfies the prescribed tolerances, or the reaction "
+                                        "rates are not finite. Consider increasing the reaction "
+                                        "solver tolerances."));
+              }
+        }
 
-                  if (temperature_and_composition_use_same_fe)
-                    accumulated_reactions_T[j] += reaction_time_step_size * heating_model_outputs_C.rates_of_temperature_change[j];
-                }
+      set_inputs(values);
 
-              if (!temperature_and_composition_use_same_fe)
-                {
-                  // loop over temperature element
-                  material_model->fill_additional_material_model_inputs(in_T, solution, fe_values_T, introspection);
+      unsigned int max_n_steps = 0;
+      for (const unsigned int steps : n_steps)
+        max_n_steps = std::max(max_n_steps, steps);
+      return max_n_steps;
+    };
 
-                  material_model->evaluate(in_T, out_T);
-                  heating_model_manager.evaluate(in_T, out_T, heating_model_outputs_T);
+    // Group the locally owned cells into batches whose points are evaluated together.
+    using active_cell_iterator = typename DoFHandler<dim>::active_cell_iterator;
+    std::vector<std::vector<active_cell_iterator> > cell_batches;
+    for (const auto &cell : dof_handler.active_cell_iterators())
+      if (cell->is_locally_owned())
+        {
+          if (cell_batches.empty() || cell_batches.back().size() == n_cells_per_batch)
+            cell_batches.emplace_back();
+          cell_batches.back().push_back(cell);
+        }
 
-                  for (unsigned int j=0; j<dof_handler.get_fe().base_element(introspection.base_elements.temperature).dofs_per_cell; ++j)
-                    {
-                      // simple forward euler
-                      in_T.temperature[j] = in_T.temperature[j]
-                                            + reaction_time_step_size * heating_model_outputs_T.rates_of_temperature_change[j];
-                      accumulated_reactions_T[j] += reaction_time_step_size * heating_model_outputs_T.rates_of_temperature_change[j];
-
-                      for (unsigned int c=0; c<introspection.n_compositional_fields; ++c)
-                        in_T.composition[j][c] = in_T.composition[j][c]
-                                                 + reaction_time_step_size * reaction_rate_outputs_T->reaction_rates[j][c];
-                    }
-                }
+    // Loop over all batches of cells in parallel, and for each batch over all reaction
+    // time steps and all degrees of freedom on each cell to compute the reactions. This
+    // is possible because the reactions only depend on the temperature and composition
+    // values at a given degree of freedom (and are independent of the solution in other
+    // points). Because temperature and composition might use different finite elements,
+    // we integrate the reactions on their elements separately, and update the temperature
+    // and the compositions for both.
+    const auto worker = [&](const typename std::vector<std::vector<active_cell_iterator> >::const_iterator &batch,
+                            ReactionScratchData<dim> &scratch,
+                            ReactionCopyData<dim> &data)
+    {
+      const std::vector<active_cell_iterator> &cells = *batch;
+
+      // Compute the inputs on all cells of the batch. If the batch is not full, the
+      // remaining slots are filled with the last cell, and their results are ignored.
+      for (unsigned int b=0; b<n_cells_per_batch; ++b)
+        {
+          const active_cell_iterator &cell = cells[std::min<std::size_t>(b, cells.size()-1)];
+          scratch.composition.reinit(cell, b, introspection, solution);
+          if (temperature_and_composition_use_same_fe == false)
+            scratch.temperature.reinit(cell, b, introspection, solution);
+        }
+
+      std::vector<std::vector<double> > accumulated_reactions_C;
+      std::vector<std::vector<double> > accumulated_reactions_T;
+
+      data.n_reaction_steps = integrate_reactions(scratch.composition, accumulated_reactions_C);
+      if (temperature_and_composition_use_same_fe == false)
+        data.n_reaction_steps = std::max(data.n_reaction_steps,
+                                         integrate_reactions(scratch.temperature, accumulated_reactions_T));
+
+      const MaterialModel::MaterialModelInputs<dim> &in_C = scratch.composition.inputs();
+      const MaterialModel::MaterialModelInputs<dim> &in_T = (temperature_and_composition_use_same_fe
+                                                             ?
+                                                             scratch.composition.inputs()
+                                                             :
+                                                             scratch.temperature.inputs());
+      const std::vector<std::vector<double> > &reactions_T = (temperature_and_composition_use_same_fe
+                                                              ?
+                                                              accumulated_reactions_C
+                                                              :
+                                                              accumulated_reactions_T);
+
+      const unsigned int n_points_C = quadrature_C.size();
+      const unsigned int n_points_T = quadrature_T.size();
+
+      data.local_dof_indices.resize(cells.size(), std::vector<types::global_dof_index>(dof_handler.get_fe().dofs_per_cell));
+      data.composition_values.resize(cells.size(), std::vector<std::vector<double> >(n_points_C, std::vector<double>(n_fields)));
+      data.composition_reactions.resize(cells.size(), std::vector<std::vector<double> >(n_points_C, std::vector<double>(n_fields)));
+      data.temperature_values.resize(cells.size(), std::vector<double>(n_points_T));
+      data.temperature_reactions.resize(cells.size(), std::vector<double>(n_points_T));
+
+      for (unsigned int b=0; b<cells.size(); ++b)
+        {
+          cells[b]->get_dof_indices (data.local_dof_indices[b]);
+
+          for (unsigned int j=0; j<n_points_C; ++j)
+            for (unsigned int c=0; c<n_fields; ++c)
+              {
+                data.composition_values[b][j][c] = in_C.composition[b*n_points_C + j][c];
+                data.composition_reactions[b][j][c] = accumulated_reactions_C[b*n_points_C + j][c];
+              }
+
+          for (unsigned int j=0; j<n_points_T; ++j)
+            {
+              data.temperature_values[b][j] = in_T.temperature[b*n_points_T + j];
+              data.temperature_reactions[b][j] = reactions_T[b*n_points_T + j][n_fields];
             }
+        }
+    };
 
-          cell->get_dof_indices (local_dof_indices);
+    // Note that the values for some degrees of freedom are set more than once in the copier
+    // below (if they are located on the interface between cells). Although this means we do
+    // some additional work, the results are still correct, as we never read from
+    // distributed_vector while computing the reactions: every cell starts from the values in
+    // the solution vector, so even though we touch some DoF more than once, we always compute
+    // the same value, and then overwrite the same value in distributed_vector. Only after the
+    // loop over all cells do we copy distributed_vector back onto the solution vector.
+    unsigned int max_reaction_steps = 0;
+    const auto copier = [&](const ReactionCopyData<dim> &data)
+    {
+      max_reaction_steps = std::max(max_reaction_steps, data.n_reaction_steps);
+
+      for (unsigned int b=0; b<data.local_dof_indices.size(); ++b)
+        {
+          const std::vector<types::global_dof_index> &local_dof_indices = data.local_dof_indices[b];
 
           // copy reaction rates and new values for the compositional fields
           for (unsigned int j=0; j<dof_handler.get_fe().base_element(introspection.base_elements.compositional_fields).dofs_per_cell; ++j)
-            for (unsigned int c=0; c<introspection.n_compositional_fields; ++c)
+            for (unsigned int c=0; c<n_fields; ++c)
               {
                 const unsigned int composition_idx
                   = dof_handler.get_fe().component_to_system_index(introspection.component_indices.compositional_fields[c],
@@ -1653,8 +2043,8 @@ namespace aspect
                 // skip entries that are not locally owned:
                 if (dof_handler.locally_owned_dofs().is_element(local_dof_indices[composition_idx]))
                   {
-                    distributed_vector(local_dof_indices[composition_idx]) = in_C.composition[j][c];
-                    distributed_reaction_vector(local_dof_indices[composition_idx]) = accumulated_reactions_C[j][c];
+                    distributed_vector(local_dof_indices[composition_idx]) = data.composition_values[b][j][c];
+                    distributed_reaction_vector(local_dof_indices[composition_idx]) = data.composition_reactions[b][j][c];
                   }
               }
 
@@ -1668,15 +2058,27 @@ namespace aspect
               // skip entries that are not locally owned:
               if (dof_handler.locally_owned_dofs().is_element(local_dof_indices[temperature_idx]))
                 {
-                  if (temperature_and_composition_use_same_fe)
-                    distributed_vector(local_dof_indices[temperature_idx]) = in_C.temperature[j];
-                  else
-                    distributed_vector(local_dof_indices[temperature_idx]) = in_T.temperature[j];
-
-                  distributed_reaction_vector(local_dof_indices[temperature_idx]) = accumulated_reactions_T[j];
+                  distributed_vector(local_dof_indices[temperature_idx]) = data.temperature_values[b][j];
+                  distributed_reaction_vector(local_dof_indices[temperature_idx]) = data.temperature_reactions[b][j];
                 }
             }
         }
+    };
+
+    WorkStream::
+    run (cell_batches.cbegin(),
+         cell_batches.cend(),
+         worker,
+         copier,
+         ReactionScratchData<dim> (*mapping,
+                                   dof_handler.get_fe(),
+                                   quadrature_C,
+                                   quadrature_T,
+                                   n_fields,
+                                   n_cells_per_batch,
+                                   *material_model,
+                                   heating_model_manager),
+         ReactionCopyData<dim> ());
 
     distributed_vector.compress(VectorOperation::insert);
     distributed_reaction_vector.compress(VectorOperation::insert);
@@ -1693,10 +2095,16 @@ namespace aspect
 
     initialize_current_linearization_point();
 
-    pcout << "in "
-          << number_of_reaction_steps
-          << " substep(s)."
-          << std::endl;
+    if (use_adaptive_reaction_solver)
+      pcout << "in at most "
+            << Utilities::MPI::max(max_reaction_steps, mpi_communicator)
+            << " substep(s)."
+            << std::endl;
+    else
+      pcout << "in "
+            << number_of_reaction_steps
+            << " substep(s)."
+            << std::endl;
   }
 
 
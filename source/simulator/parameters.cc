@@ -339,6 +339,37 @@ namespace aspect
                            "increasing this number increases the memory usage "
                            "of the advection solver, and makes individual "
                            "iterations more expensive.");
+
+        prm.declare_entry ("Advection solver type", "matrix-based",
+                           Patterns::Selection(AdvectionSolverType::pattern()),
+                           "This is the type of solver used on the temperature and composition "
+                           "systems. The 'matrix-based' solver assembles a sparse matrix "
+                           "for every field and uses GMRES preconditioned with ILU. The "
+                           "'matrix-free' solver never builds a matrix and instead applies "
+                           "the operator cell by cell using deal.II's MatrixFree framework, "
+                           "with a Jacobi preconditioner. All compositional fields share one "
+                           "MatrixFree object. The matrix-free solver currently requires "
+                           "continuous elements of the same degree for temperature and "
+                           "composition, entropy viscosity stabilization, a Stokes velocity "
+                           "degree of at most 2, and it does not support melt transport or "
+                           "fixed heat flux boundaries. Compositional fields that are not "
+                           "advected with the `field' method still use the matrix-based solver.");
+
+        prm.declare_entry ("Group compatible compositional fields", "false",
+                           Patterns::Bool (),
+                           "Whether to reuse the matrix and preconditioner of one compositional "
+                           "field for all other compositional fields whose advection systems "
+                           "have the same matrix. Since the matrix of a compositional field only "
+                           "depends on the velocity, the time step, and the artificial viscosity, "
+                           "this is the case for all fields advected with the `field' method that "
+                           "have the same artificial viscosity on every cell (for example, because "
+                           "the stabilization parameter beta is zero, or in the first time step). "
+                           "For these fields, only the right-hand side is assembled and the "
+                           "linear systems are solved with the matrix and ILU preconditioner of "
+                           "the first field of the group. This saves a significant amount of "
+                           "time in models with many compositional fields. The option is ignored "
+                           "if melt transport or the matrix-free advection solver is used, or if "
+                           "additional advection assemblers are attached to the simulator.");
       }
       prm.leave_subsection();
 
@@ -516,6 +547,19 @@ namespace aspect
         prm.declare_entry ("AMG output details", "false",
                            Patterns::Bool(),
                            "Turns on extra information on the AMG solver. Note that this will generate much more output.");
+
+        prm.declare_entry ("AMG use unsmoothed aggregation", "false",
+                           Patterns::Bool(),
+                           "Whether the AMG preconditioner for the velocity block of the Stokes "
+                           "system should use the tentative, unsmoothed prolongation between "
+                           "levels instead of the smoothed one that is used by default. "
+                           "This leads to much sparser matrices on the coarser levels, and "
+                           "consequently reduces both the memory required to store the AMG "
+                           "hierarchy and the memory traffic of each application of the "
+                           "preconditioner. On the other hand, the preconditioner is somewhat "
+                           "less effective, so the Stokes solver may need more iterations. "
+                           "This parameter is only used for the 'block AMG' Stokes solver "
+                           "if ASPECT was configured with Trilinos.");
       }
       prm.leave_subsection ();
       prm.enter_subsection ("Operator splitting parameters");
@@ -543,6 +587,53 @@ namespace aspect
                            "this criterion and the ``Reaction time step'', whichever yields the "
                            "smaller time step. "
                            "Units: none.");
+
+        prm.declare_entry ("Reaction solver type", "fixed step",
+                           Patterns::Selection(ReactionSolverType::pattern()),
+                           "The time stepping scheme used to compute the reactions of compositional "
+                           "fields and the temperature in case operator splitting is used. "
+                           "``fixed step'' uses the forward Euler scheme with the number of "
+                           "reaction time steps that follows from the ``Reaction time step'' and "
+                           "``Reaction time steps per advection step'' parameters, for every point "
+                           "in the model. ``adaptive'' uses an embedded Runge-Kutta scheme of "
+                           "second order (Heun's method with a forward Euler error estimate), and "
+                           "chooses the reaction time step size separately for every support point "
+                           "so that the estimated error stays below the ``Reaction solver relative "
+                           "tolerance'' and ``Reaction solver absolute tolerance''. Cells in which "
+                           "the reactions do not change the solution by more than the absolute "
+                           "tolerance within one advection time step are updated in a single step. "
+                           "This means that the computational cost follows the reaction rates in "
+                           "each cell, rather than the fastest reaction in the whole model. If "
+                           "``adaptive'' is selected, the parameters ``Reaction time step'' and "
+                           "``Reaction time steps per advection step'' are ignored.");
+
+        prm.declare_entry ("Reaction solver relative tolerance", "1e-4",
+                           Patterns::Double (0.),
+                           "The relative tolerance for the local error of one reaction time step "
+                           "if the ``adaptive'' reaction solver type is selected. "
+                           "Units: none.");
+
+        prm.declare_entry ("Reaction solver absolute tolerance", "1e-6",
+                           Patterns::Double (0.),
+                           "The absolute tolerance for the local error of one reaction time step "
+                           "if the ``adaptive'' reaction solver type is selected. The same value "
+                           "is used for the temperature and all compositional fields. "
+                           "Units: none.");
+
+        prm.declare_entry ("Reaction solver cells per batch", "1",
+                           Patterns::Integer (1),
+                           "The number of cells whose support points are passed to the material "
+                           "model together when computing the reactions in case operator splitting "
+                           "is used. Cells are always processed in parallel on all available threads; "
+                           "batching several cells into one evaluation in addition gives the material "
+                           "model larger inputs that are cheaper to evaluate per point. However, if "
+                           "more than one cell is used, the material model inputs no longer refer to "
+                           "a single cell, so material models that use the current cell (for example "
+                           "to compute cell-wise averages) fall back to their behavior for inputs "
+                           "without a cell. If any of the heating models requires additional material "
+                           "model inputs, this parameter is ignored and every cell is evaluated "
+                           "separately. "
+                           "Units: none.");
       }
       prm.leave_subsection ();
       prm.enter_subsection ("Diffusion solver parameters");
@@ -849,6 +940,20 @@ namespace aspect
                          "If 0 and time between checkpoint is not specified, "
                          "checkpointing will not be performed. "
                          "Units: None.");
+      prm.declare_entry ("Write in background thread", "false",
+                         Patterns::Bool (),
+                         "Whether the checkpoint files should be written to disk "
+                         "in a background thread. If this is set to `true', the "
+                         "mesh and solution vectors are still written by all processes "
+                         "when the checkpoint is created, but the general simulator "
+                         "state is only copied into memory and then written and "
+                         "moved into place on a separate thread while the next time "
+                         "steps are computed. The previous checkpoint is only "
+                         "replaced once the new one has been written completely. "
+                         "This can save a significant amount of time for models "
+                         "with a large state, for example many postprocessors with "
+                         "history, at the cost of keeping a compressed copy of this "
+                         "state in memory until it is written.");
     }
     prm.leave_subsection ();
 
@@ -1265,6 +1370,18 @@ namespace aspect
                          "More averaging schemes are available in the averaging material "
                          "model. This material model is a ``compositing material model'' "
                          "which can be used in combination with other material models.");
+      prm.declare_entry ("Material model output cache size", "0",
+                         Patterns::Double (0.),
+                         "The maximal amount of memory each process may use to store "
+                         "the outputs of the material model that are computed by "
+                         "postprocessors and mesh refinement criteria. If the material "
+                         "model is evaluated again for the same inputs on the same cell "
+                         "and for the same solution, for example by another "
+                         "postprocessor or by a mesh refinement criterion, the stored "
+                         "outputs are used instead of evaluating the material model "
+                         "again. This can save a significant amount of time for "
+                         "expensive material models. A value of zero disables the cache. "
+                         "Units: MB.");
     }
     prm.leave_subsection ();
 
@@ -1354,6 +1471,8 @@ namespace aspect
       prm.enter_subsection ("Advection solver parameters");
       {
         advection_gmres_restart_length     = prm.get_integer("GMRES solver restart length");
+        advection_solver_type = AdvectionSolverType::parse(prm.get("Advection solver type"));
+        group_compatible_compositional_fields = prm.get_bool("Group compatible compositional fields");
       }
       prm.leave_subsection ();
 
@@ -1382,6 +1501,7 @@ namespace aspect
         AMG_smoother_sweeps                    = prm.get_integer ("AMG smoother sweeps");
         AMG_aggregation_threshold              = prm.get_double ("AMG aggregation threshold");
         AMG_output_details                     = prm.get_bool ("AMG output details");
+        AMG_use_unsmoothed_aggregation         = prm.get_bool ("AMG use unsmoothed aggregation");
       }
       prm.leave_subsection ();
       prm.enter_subsection ("Operator splitting parameters");
@@ -1392,6 +1512,15 @@ namespace aspect
         if (convert_to_years == true)
           reaction_time_step *= year_in_seconds;
         reaction_steps_per_advection_step = prm.get_integer ("Reaction time steps per advection step");
+        reaction_solver_type = ReactionSolverType::parse(prm.get("Reaction solver type"));
+        reaction_solver_relative_tolerance = prm.get_double ("Reaction solver relative tolerance");
+        reaction_solver_absolute_tolerance = prm.get_double ("Reaction solver absolute tolerance");
+        reaction_solver_cells_per_batch = prm.get_integer ("Reaction solver cells per batch");
+        AssertThrow (reaction_solver_type != ReactionSolverType::adaptive
+                     || reaction_solver_relative_tolerance > 0
+                     || reaction_solver_absolute_tolerance > 0,
+                     ExcMessage("At least one of the reaction solver tolerances must be "
+                                "greater than 0 if the adaptive reaction solver is used."));
       }
       prm.leave_subsection ();
       prm.enter_subsection ("Diffusion solver parameters");
@@ -1595,6 +1724,7 @@ namespace aspect
     {
       checkpoint_time_secs = prm.get_integer ("Time between checkpoint");
       checkpoint_steps     = prm.get_integer ("Steps between checkpoint");
+      write_checkpoint_in_background_thread = prm.get_bool ("Write in background thread");
 
 #ifndef DEAL_II_WITH_ZLIB
       AssertThrow ((checkpoint_time_secs == 0)
@@ -1933,6 +2063,7 @@ namespace aspect
       material_averaging
         = MaterialModel::MaterialAveraging::parse_averaging_operation_name
           (prm.get ("Material averaging"));
+      material_model_output_cache_size = prm.get_double ("Material model output cache size");
     }
     prm.leave_subsection ();
 
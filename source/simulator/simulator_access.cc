@@ -363,6 +363,16 @@ namespace aspect
   }
 
 
+
+  template <int dim>
+  void
+  SimulatorAccess<dim>::evaluate_material_model (const MaterialModel::MaterialModelInputs<dim> &in,
+                                                 MaterialModel::MaterialModelOutputs<dim> &out) const
+  {
+    simulator->material_model_output_cache.evaluate(get_material_model(), in, out);
+  }
+
+
   template <int dim>
   void
   SimulatorAccess<dim>::compute_material_model_input_values (const LinearAlgebra::BlockVector                            &input_solution,
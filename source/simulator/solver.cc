@@ -23,6 +23,7 @@
 #include <aspect/global.h>
 #include <aspect/melt.h>
 #include <aspect/stokes_matrix_free.h>
+#include <aspect/advection_matrix_free.h>
 
 #include <deal.II/base/signaling_nan.h>
 #include <deal.II/lac/solver_gmres.h>
@@ -408,9 +409,21 @@ namespace aspect
 
   template <int dim>
   double Simulator<dim>::solve_advection (const AdvectionField &advection_field)
+  {
+    std::unique_ptr<LinearAlgebra::PreconditionILU> preconditioner;
+    return solve_advection (advection_field, advection_field, preconditioner);
+  }
+
+
+
+  template <int dim>
+  double Simulator<dim>::solve_advection (const AdvectionField &advection_field,
+                                          const AdvectionField &matrix_field,
+                                          std::unique_ptr<LinearAlgebra::PreconditionILU> &preconditioner)
   {
     double advection_solver_tolerance = -1;
     unsigned int block_idx = advection_field.block_index(introspection);
+    const unsigned int matrix_block_idx = matrix_field.block_index(introspection);
 
     std::string field_name = (advection_field.is_temperature()
                               ?
@@ -433,6 +446,9 @@ namespace aspect
     SolverGMRES<LinearAlgebra::Vector>   solver (solver_control,
                                                  SolverGMRES<LinearAlgebra::Vector>::AdditionalData(parameters.advection_gmres_restart_length,true));
 
+    const bool use_matrix_free_solver = (advection_matrix_free
+                                         && advection_matrix_free->is_applicable(advection_field));
+
     // check if matrix and/or RHS are zero
     // note: to avoid a warning, we compare against numeric_limits<double>::min() instead of 0 here
     if (system_rhs.block(block_idx).l2_norm() <= std::numeric_limits<double>::min())
@@ -440,6 +456,16 @@ namespace aspect
         pcout << "   Skipping " + field_name + " solve because RHS is zero." << std::endl;
         solution.block(block_idx) = 0;
 
+        // The right-hand side of the matrix-free solver does not contain the
+        // boundary values, so the solution is not necessarily zero there.
+        if (use_matrix_free_solver)
+          {
+            LinearAlgebra::BlockVector distributed_solution (introspection.index_sets.system_partitioning,
+                                                             mpi_communicator);
+            current_constraints.distribute (distributed_solution);
+            solution.block(block_idx) = distributed_solution.block(block_idx);
+          }
+
         // signal successful solver and signal residual of zero
         solver_control.check(0, 0.0);
         signals.post_advection_solver(*this,
@@ -450,14 +476,22 @@ namespace aspect
         return 0;
       }
 
-    AssertThrow(system_matrix.block(block_idx,
-                                    block_idx).linfty_norm() > std::numeric_limits<double>::min(),
-                ExcMessage ("The " + field_name + " equation can not be solved, because the matrix is zero, "
-                            "but the right-hand side is nonzero."));
+    Assert (!use_matrix_free_solver || matrix_block_idx == block_idx,
+            ExcInternalError());
 
-    LinearAlgebra::PreconditionILU preconditioner;
-    // first build without diagonal strengthening:
-    build_advection_preconditioner(advection_field, preconditioner, 0.);
+    if (!use_matrix_free_solver)
+      AssertThrow(system_matrix.block(matrix_block_idx,
+                                      matrix_block_idx).linfty_norm() > std::numeric_limits<double>::min(),
+                  ExcMessage ("The " + field_name + " equation can not be solved, because the matrix is zero, "
+                              "but the right-hand side is nonzero."));
+
+    // first build without diagonal strengthening, unless we can reuse
+    // the preconditioner of a field that shares the same matrix:
+    if (!use_matrix_free_solver && !preconditioner)
+      {
+        preconditioner = std_cxx14::make_unique<LinearAlgebra::PreconditionILU>();
+        build_advection_preconditioner(matrix_field, *preconditioner, 0.);
+      }
 
     TimerOutput::Scope timer (computing_timer, (advection_field.is_temperature() ?
                                                 "Solve temperature system" :
@@ -489,36 +523,48 @@ namespace aspect
 
     current_constraints.set_zero(distributed_solution);
 
+    double initial_residual = numbers::signaling_nan<double>();
+
     // Compute the residual before we solve and return this at the end.
-    // This is used in the nonlinear solver.
-    const double initial_residual = system_matrix.block(block_idx,block_idx).residual
-                                    (temp,
-                                     distributed_solution.block(block_idx),
-                                     system_rhs.block(block_idx));
+    // This is used in the nonlinear solver. The matrix-free solver
+    // computes it itself.
+    if (!use_matrix_free_solver)
+      initial_residual = system_matrix.block(matrix_block_idx,matrix_block_idx).residual
+                         (temp,
+                          distributed_solution.block(block_idx),
+                          system_rhs.block(block_idx));
 
     // solve the linear system:
     try
       {
-        try
+        if (use_matrix_free_solver)
           {
-            solver.solve (system_matrix.block(block_idx,block_idx),
-                          distributed_solution.block(block_idx),
-                          system_rhs.block(block_idx),
-                          preconditioner);
+            initial_residual = advection_matrix_free->solve(advection_field,
+                                                            solver_control,
+                                                            distributed_solution.block(block_idx));
           }
-        catch (const std::exception &exc)
+        else
           {
-            // Try rebuilding the preconditioner with diagonal strengthening. In general,
-            // this increases the number of iterations needed, but helps in rare situations,
-            // especially when SUPG is used.
-            pcout << "retrying linear solve with different preconditioner..." << std::endl;
-            build_advection_preconditioner(advection_field, preconditioner, 1e-5);
-            solver.solve (system_matrix.block(block_idx,block_idx),
-                          distributed_solution.block(block_idx),
-                          system_rhs.block(block_idx),
-                          preconditioner);
+            try
+              {
+                solver.solve (system_matrix.block(matrix_block_idx,matrix_block_idx),
+                              distributed_solution.block(block_idx),
+                              system_rhs.block(block_idx),
+                              *preconditioner);
+              }
+            catch (const std::exception &exc)
+              {
+                // Try rebuilding the preconditioner with diagonal strengthening. In general,
+                // this increases the number of iterations needed, but helps in rare situations,
+                // especially when SUPG is used.
+                pcout << "retrying linear solve with different preconditioner..." << std::endl;
+                build_advection_preconditioner(matrix_field, *preconditioner, 1e-5);
+                solver.solve (system_matrix.block(matrix_block_idx,matrix_block_idx),
+                              distributed_solution.block(block_idx),
+                              system_rhs.block(block_idx),
+                              *preconditioner);
+              }
           }
-
       }
     // if the solver fails, report the error from processor 0 with some additional
     // information about its location, and throw a quiet exception on all other
@@ -968,6 +1014,9 @@ namespace aspect
 {
 #define INSTANTIATE(dim) \
   template double Simulator<dim>::solve_advection (const AdvectionField &); \
+  template double Simulator<dim>::solve_advection (const AdvectionField &, \
+                                                   const AdvectionField &, \
+                                                   std::unique_ptr<LinearAlgebra::PreconditionILU> &); \
   template std::pair<double,double> Simulator<dim>::solve_stokes ();
 
   ASPECT_INSTANTIATE(INSTANTIATE)
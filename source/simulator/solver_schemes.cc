@@ -29,6 +29,7 @@
 #include <deal.II/numerics/vector_tools.h>
 
 #include <aspect/stokes_matrix_free.h>
+#include <aspect/simulator/assemblers/advection.h>
 
 
 namespace aspect
@@ -200,6 +201,73 @@ namespace aspect
         Assert(initial_residual->size() == introspection.n_compositional_fields, ExcInternalError());
       }
 
+    // For every compositional field, store the field whose matrix block and
+    // preconditioner we use to solve it. This is the field itself, unless
+    // grouping of compatible fields is enabled and the matrix of an earlier
+    // field is identical.
+    std::vector<unsigned int> matrix_field (introspection.n_compositional_fields);
+    for (unsigned int c=0; c < introspection.n_compositional_fields; ++c)
+      matrix_field[c] = c;
+
+    std::vector<Vector<double> > viscosity_per_cell (introspection.n_compositional_fields);
+    std::vector<std::unique_ptr<LinearAlgebra::PreconditionILU> > preconditioners (introspection.n_compositional_fields);
+
+    if (parameters.group_compatible_compositional_fields
+        && !parameters.include_melt_transport
+        && !advection_matrix_free)
+      {
+        // The matrix of a compositional field only depends on the velocity,
+        // the time step, and the artificial viscosity for the assemblers
+        // we create ourselves. We can not make any statement about other
+        // assemblers, so do not group fields if there are any.
+        bool fields_can_share_matrix = true;
+        for (const auto &assembler : assemblers->advection_system)
+          if (dynamic_cast<const Assemblers::AdvectionSystem<dim>*>(assembler.get()) == nullptr
+              &&
+              dynamic_cast<const Assemblers::DiffusionSystem<dim>*>(assembler.get()) == nullptr)
+            fields_can_share_matrix = false;
+        for (const auto &assembler : assemblers->advection_system_on_boundary_face)
+          if (dynamic_cast<const Assemblers::AdvectionSystemBoundaryFace<dim>*>(assembler.get()) == nullptr
+              &&
+              dynamic_cast<const Assemblers::AdvectionSystemBoundaryHeatFlux<dim>*>(assembler.get()) == nullptr)
+            fields_can_share_matrix = false;
+        for (const auto &assembler : assemblers->advection_system_on_interior_face)
+          if (dynamic_cast<const Assemblers::AdvectionSystemInteriorFace<dim>*>(assembler.get()) == nullptr)
+            fields_can_share_matrix = false;
+
+        if (fields_can_share_matrix)
+          {
+            TimerOutput::Scope timer (computing_timer, "Assemble composition system");
+
+            // The artificial viscosity only depends on the old solutions and
+            // the current velocity, so we can compute it for all fields
+            // before we solve any of them.
+            for (unsigned int c=0; c < introspection.n_compositional_fields; ++c)
+              {
+                const AdvectionField adv_field (AdvectionField::composition(c));
+                if (adv_field.advection_method(introspection) != Parameters<dim>::AdvectionFieldMethod::fem_field)
+                  continue;
+
+                viscosity_per_cell[c].reinit(triangulation.n_active_cells());
+                get_artificial_viscosity(viscosity_per_cell[c], adv_field);
+
+                // Compare with all earlier fields that own their matrix. The
+                // viscosity is only computed on locally owned cells, so all
+                // processes need to agree that it is the same everywhere.
+                for (unsigned int d=0; d<c; ++d)
+                  if (matrix_field[d] == d && viscosity_per_cell[d].size() != 0)
+                    {
+                      const unsigned int locally_identical = (viscosity_per_cell[c] == viscosity_per_cell[d]) ? 1 : 0;
+                      if (Utilities::MPI::min(locally_identical, mpi_communicator) == 1)
+                        {
+                          matrix_field[c] = d;
+                          break;
+                        }
+                    }
+              }
+          }
+      }
+
     for (unsigned int c=0; c < introspection.n_compositional_fields; ++c)
       {
         const AdvectionField adv_field (AdvectionField::composition(c));
@@ -224,17 +292,30 @@ namespace aspect
                   old_solution.block(adv_field.block_index(introspection)) = solution.block(adv_field.block_index(introspection));
                 }
 
-              assemble_advection_system (adv_field);
+              // If the viscosity has already been computed, only assemble the
+              // matrix if it is not shared with an earlier field
+              if (viscosity_per_cell[c].size() != 0)
+                assemble_advection_system (adv_field, viscosity_per_cell[c], matrix_field[c] == c);
+              else
+                assemble_advection_system (adv_field);
 
               if (compute_initial_residual)
                 (*initial_residual)[c] = system_rhs.block(introspection.block_indices.compositional_fields[c]).l2_norm();
 
-              current_residual[c] = solve_advection(adv_field);
+              current_residual[c] = solve_advection(adv_field,
+                                                    AdvectionField::composition(matrix_field[c]),
+                                                    preconditioners[matrix_field[c]]);
 
-              // Release the contents of the matrix block we used again:
-              const unsigned int block_idx = adv_field.block_index(introspection);
-              if (adv_field.compositional_variable!=0)
-                system_matrix.block(block_idx, block_idx).clear();
+              // Release the contents of the matrix block we used again, unless
+              // a later field still needs it:
+              if (std::find(matrix_field.begin()+c+1, matrix_field.end(), matrix_field[c]) == matrix_field.end())
+                {
+                  preconditioners[matrix_field[c]].reset();
+
+                  const unsigned int block_idx = AdvectionField::composition(matrix_field[c]).block_index(introspection);
+                  if (matrix_field[c] != 0)
+                    system_matrix.block(block_idx, block_idx).clear();
+                }
 
               // No need to call the post_advection_solver signal here: It is
               // automatically called from solve_advection() above.
@@ -22,6 +22,8 @@
 #include <aspect/stokes_matrix_free.h>
 #include <aspect/citation_info.h>
 #include <aspect/melt.h>
+#include <aspect/mesh_deformation/interface.h>
+#include <aspect/mesh_deformation/free_surface.h>
 
 #include <deal.II/dofs/dof_renumbering.h>
 #include <deal.II/dofs/dof_accessor.h>
@@ -667,7 +669,8 @@ namespace aspect
   template <int dim, int degree_v, typename number>
   MatrixFreeStokesOperators::StokesOperator<dim,degree_v,number>::StokesOperator ()
     :
-    MatrixFreeOperators::Base<dim, dealii::LinearAlgebra::distributed::BlockVector<number> >()
+    MatrixFreeOperators::Base<dim, dealii::LinearAlgebra::distributed::BlockVector<number> >(),
+    free_surface_stabilization(nullptr)
   {}
 
   template <int dim, int degree_v, typename number>
@@ -675,6 +678,8 @@ namespace aspect
   MatrixFreeStokesOperators::StokesOperator<dim,degree_v,number>::clear ()
   {
     viscosity = nullptr;
+    free_surface_stabilization = nullptr;
+    free_surface_boundary_indicators.clear();
     MatrixFreeOperators::Base<dim,dealii::LinearAlgebra::distributed::BlockVector<number> >::clear();
   }
 
@@ -690,6 +695,16 @@ namespace aspect
     this->is_compressible = is_compressible;
   }
 
+  template <int dim, int degree_v, typename number>
+  void
+  MatrixFreeStokesOperators::StokesOperator<dim,degree_v,number>::
+  set_free_surface_stabilization (const Table<2, Tensor<1, dim, VectorizedArray<number>>> &stabilization_table,
+                                  const std::set<types::boundary_id> &boundary_indicators)
+  {
+    free_surface_stabilization = &stabilization_table;
+    free_surface_boundary_indicators = boundary_indicators;
+  }
+
   template <int dim, int degree_v, typename number>
   void
   MatrixFreeStokesOperators::StokesOperator<dim,degree_v,number>
@@ -757,14 +772,67 @@ namespace aspect
       }
   }
 
+  template <int dim, int degree_v, typename number>
+  void
+  MatrixFreeStokesOperators::StokesOperator<dim,degree_v,number>
+  ::local_apply_face (const dealii::MatrixFree<dim, number> &,
+                      dealii::LinearAlgebra::distributed::BlockVector<number> &,
+                      const dealii::LinearAlgebra::distributed::BlockVector<number> &,
+                      const std::pair<unsigned int, unsigned int> &) const
+  {}
+
+  template <int dim, int degree_v, typename number>
+  void
+  MatrixFreeStokesOperators::StokesOperator<dim,degree_v,number>
+  ::local_apply_boundary_face (const dealii::MatrixFree<dim, number>                 &data,
+                               dealii::LinearAlgebra::distributed::BlockVector<number>       &dst,
+                               const dealii::LinearAlgebra::distributed::BlockVector<number> &src,
+                               const std::pair<unsigned int, unsigned int>           &face_range) const
+  {
+    FEFaceEvaluation<dim,degree_v,degree_v+1,dim,number> velocity_boundary (data, true, 0);
+
+    for (unsigned int face=face_range.first; face<face_range.second; ++face)
+      {
+        if (free_surface_boundary_indicators.find(data.get_boundary_id(face))
+            == free_surface_boundary_indicators.end())
+          continue;
+
+        const unsigned int boundary_face = face - data.n_inner_face_batches();
+
+        velocity_boundary.reinit (face);
+        velocity_boundary.read_dof_values (src.block(0));
+        velocity_boundary.evaluate (true,false);
+
+        // See Kaus et al 2010 and the matrix-based assembler
+        // Assemblers::ApplyStabilization for details of this term.
+        for (unsigned int q=0; q<velocity_boundary.n_q_points; ++q)
+          {
+            const VectorizedArray<number> normal_velocity
+              = velocity_boundary.get_value(q) * velocity_boundary.get_normal_vector(q);
+
+            velocity_boundary.submit_value ((*free_surface_stabilization)(boundary_face, q) * (-normal_velocity), q);
+          }
+
+        velocity_boundary.integrate (true,false);
+        velocity_boundary.distribute_local_to_global (dst.block(0));
+      }
+  }
+
   template <int dim, int degree_v, typename number>
   void
   MatrixFreeStokesOperators::StokesOperator<dim,degree_v,number>
   ::apply_add (dealii::LinearAlgebra::distributed::BlockVector<number> &dst,
                const dealii::LinearAlgebra::distributed::BlockVector<number> &src) const
   {
-    MatrixFreeOperators::Base<dim, dealii::LinearAlgebra::distributed::BlockVector<number> >::
-    data->cell_loop(&StokesOperator::local_apply, this, dst, src);
+    if (free_surface_stabilization != nullptr)
+      MatrixFreeOperators::Base<dim, dealii::LinearAlgebra::distributed::BlockVector<number> >::
+      data->loop(&StokesOperator::local_apply,
+                 &StokesOperator::local_apply_face,
+                 &StokesOperator::local_apply_boundary_face,
+                 this, dst, src);
+    else
+      MatrixFreeOperators::Base<dim, dealii::LinearAlgebra::distributed::BlockVector<number> >::
+      data->cell_loop(&StokesOperator::local_apply, this, dst, src);
   }
 
   /**
@@ -1183,30 +1251,34 @@ namespace aspect
                                 sim.parameters.material_averaging
                                 ==
                                 MaterialModel::MaterialAveraging::AveragingOperation::project_to_Q1_only_viscosity
-                                ? 1 : 0), 1)
+                                ? 1 : 0), 1),
+
+      previous_viscosity_limits(0., 0.),
+      previous_pressure_scaling(0.),
+      level_viscosity_changed(true)
   {
     parse_parameters(prm);
     CitationInfo::add("mf");
 
-    // This requires: porting the additional stabilization terms and using a
-    // different mapping in the MatrixFree operators:
-    AssertThrow(!sim.parameters.mesh_deformation_enabled, ExcNotImplemented());
     // Sorry, not any time soon:
     AssertThrow(!sim.parameters.include_melt_transport, ExcNotImplemented());
     // Not very difficult to do, but will require a different mass matrix
     // operator:
     AssertThrow(!sim.parameters.use_locally_conservative_discretization, ExcNotImplemented());
 
+#if !DEAL_II_VERSION_GTE(9,3,0)
+    // The deformed mesh on the multigrid levels is described by a
+    // MappingQEulerian on the level DoFs, which requires deal.II 9.3:
+    AssertThrow(!sim.parameters.mesh_deformation_enabled,
+                ExcMessage("Mesh deformation with the matrix-free GMG Stokes solver "
+                           "requires deal.II 9.3 or newer."));
+#endif
+
 
     // sanity check:
     Assert(sim.introspection.variable("velocity").block_index==0, ExcNotImplemented());
     Assert(sim.introspection.variable("pressure").block_index==1, ExcNotImplemented());
 
-    // This is not terribly complicated, but we need to check that constraints
-    // are set correctly, that the preconditioner converges, and requires
-    // testing.
-    AssertThrow(sim.geometry_model->get_periodic_boundary_pairs().size()==0, ExcNotImplemented());
-
     // We currently only support averaging that gives a constant value:
     using avg = MaterialModel::MaterialAveraging::AveragingOperation;
     AssertThrow((sim.parameters.material_averaging &
@@ -1244,12 +1316,27 @@ namespace aspect
                                                                                sim.triangulation.get_communicator());
 
     const QGauss<dim> quadrature_formula (sim.parameters.stokes_velocity_degree+1);
+    const unsigned int n_q_points = quadrature_formula.size();
+    const unsigned int projection_degree = dof_handler_projection.get_fe().degree;
+    Assert(projection_degree == 0 || projection_degree == 1, ExcInternalError());
 
     double min_el = std::numeric_limits<double>::max();
     double max_el = -std::numeric_limits<double>::max();
 
-    // Fill the DGQ0 or DGQ1 vector of viscosity values on the active mesh
+    // Evaluate the material model for all cells of a cell batch of the active
+    // level matrix-free object at once, and compute the cellwise projection of
+    // the viscosity to the DGQ0 or DGQ1 space directly from the quadrature point
+    // values. The projected values are written both into the DoF vector that
+    // is transferred to the multigrid levels below, and into the active level
+    // viscosity table.
     {
+      const unsigned int n_cells = stokes_matrix.get_matrix_free()->n_macro_cells();
+      const unsigned int n_lanes = VectorizedArray<double>::size();
+
+      // One value per cell is required for DGQ0 projection and n_q_points
+      // values per cell for DGQ1.
+      active_viscosity_table.reinit(TableIndices<2>(n_cells, projection_degree == 0 ? 1 : n_q_points));
+
       FEValues<dim> fe_values (*sim.mapping,
                                sim.finite_element,
                                quadrature_formula,
@@ -1258,116 +1345,150 @@ namespace aspect
                                update_quadrature_points |
                                update_JxW_values);
 
-      MaterialModel::MaterialModelInputs<dim> in(fe_values.n_quadrature_points, sim.introspection.n_compositional_fields);
-      MaterialModel::MaterialModelOutputs<dim> out(fe_values.n_quadrature_points, sim.introspection.n_compositional_fields);
-
-      // This function call computes a cellwise projection of data defined at quadrature points to
-      // a vector defined by the projection DoFHandler. As an input, we must define a lambda which returns
-      // a viscosity value for each quadrature point of the given cell. The projection is then stored in
-      // the active level viscosity vector provided.
-      Utilities::project_cellwise<dim, dealii::LinearAlgebra::distributed::Vector<double>>(*(sim.mapping),
-          dof_handler_projection,
-          0,
-          quadrature_formula,
-          [&](const typename DoFHandler<dim>::active_cell_iterator & cell,
-              const std::vector<Point<dim>> & /*q_points*/,
-              std::vector<double> &values) -> void
-      {
-        typename DoFHandler<dim>::active_cell_iterator FEQ_cell(&sim.triangulation,
-        cell->level(),
-        cell->index(),
-        &(sim.dof_handler));
+      FEValues<dim> fe_values_projection (*sim.mapping,
+                                          fe_projection,
+                                          quadrature_formula,
+                                          update_values);
 
-        fe_values.reinit (FEQ_cell);
-        in.reinit(fe_values, FEQ_cell, sim.introspection, sim.current_linearization_point);
+      std::vector<MaterialModel::MaterialModelInputs<dim>> lane_in;
+      std::vector<MaterialModel::MaterialModelOutputs<dim>> lane_out;
+      lane_in.reserve(n_lanes);
+      lane_out.reserve(n_lanes);
+      for (unsigned int lane=0; lane<n_lanes; ++lane)
+        {
+          lane_in.emplace_back(n_q_points, sim.introspection.n_compositional_fields);
+          lane_out.emplace_back(n_q_points, sim.introspection.n_compositional_fields);
 
-        // Query the material model for the active level viscosities
-        sim.material_model->fill_additional_material_model_inputs(in, sim.current_linearization_point, fe_values, sim.introspection);
-        sim.material_model->evaluate(in, out);
+          // Only the viscosity enters the matrix-free operators. In
+          // particular, not requesting reaction terms allows material models
+          // to evaluate all cells of the batch in a single call.
+          lane_in.back().requested_properties = MaterialModel::MaterialProperties::viscosity;
+        }
 
-        // If using a cellwise average for viscosity, average the values here.
-        // When the projection is computed, this will set the viscosity exactly
-        // to this averaged value.
-        if (dof_handler_projection.get_fe().degree == 0)
-          MaterialModel::MaterialAveraging::average (sim.parameters.material_averaging,
-          FEQ_cell,
-          quadrature_formula,
-          *sim.mapping,
-          out);
+      std::vector<typename DoFHandler<dim>::active_cell_iterator> lane_cells (n_lanes);
+      std::vector<std::vector<double>> lane_JxW (n_lanes, std::vector<double>(n_q_points));
 
-        for (unsigned int i=0; i<values.size(); ++i)
-          {
-            // Find the max/min of the evaluated viscosities.
-            min_el = std::min(min_el, out.viscosities[i]);
-            max_el = std::max(max_el, out.viscosities[i]);
+      const unsigned int dofs_per_cell = fe_projection.dofs_per_cell;
+      std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
+      Vector<double> cell_vector (dofs_per_cell);
+      Vector<double> local_projection (dofs_per_cell);
+      FullMatrix<double> local_mass_matrix (dofs_per_cell, dofs_per_cell);
 
-            values[i] = out.viscosities[i];
-          }
-        return;
-      },
-      active_viscosity_vector);
+      for (unsigned int cell=0; cell<n_cells; ++cell)
+        {
+          const unsigned int n_components_filled = stokes_matrix.get_matrix_free()->n_components_filled(cell);
 
-      active_viscosity_vector.compress(VectorOperation::insert);
-    }
+          std::vector<const MaterialModel::MaterialModelInputs<dim> *> batch_in (n_components_filled);
+          std::vector<MaterialModel::MaterialModelOutputs<dim> *> batch_out (n_components_filled);
 
-    FEValues<dim> fe_values_projection (*(sim.mapping),
-                                        fe_projection,
-                                        quadrature_formula,
-                                        update_values);
+          for (unsigned int i=0; i<n_components_filled; ++i)
+            {
+              const typename DoFHandler<dim>::active_cell_iterator matrix_free_cell =
+                stokes_matrix.get_matrix_free()->get_cell_iterator(cell,i);
+              lane_cells[i] = typename DoFHandler<dim>::active_cell_iterator(&sim.triangulation,
+                                                                             matrix_free_cell->level(),
+                                                                             matrix_free_cell->index(),
+                                                                             &(sim.dof_handler));
 
-    // Create active mesh viscosity table.
-    {
-      const unsigned int n_cells = stokes_matrix.get_matrix_free()->n_macro_cells();
-      const unsigned int n_q_points = quadrature_formula.size();
+              fe_values.reinit (lane_cells[i]);
+              lane_in[i].reinit(fe_values, lane_cells[i], sim.introspection, sim.current_linearization_point);
+              sim.material_model->fill_additional_material_model_inputs(lane_in[i], sim.current_linearization_point, fe_values, sim.introspection);
 
-      std::vector<double> values_on_quad;
+              for (unsigned int q=0; q<n_q_points; ++q)
+                lane_JxW[i][q] = fe_values.JxW(q);
 
-      // One value per cell is required for DGQ0 projection and n_q_points
-      // values per cell for DGQ1.
-      if (dof_handler_projection.get_fe().degree == 0)
-        active_viscosity_table.reinit(TableIndices<2>(n_cells, 1));
-      else if (dof_handler_projection.get_fe().degree == 1)
-        {
-          values_on_quad.resize(n_q_points);
-          active_viscosity_table.reinit(TableIndices<2>(n_cells, n_q_points));
-        }
-      else
-        Assert(false, ExcInternalError());
+              batch_in[i] = &lane_in[i];
+              batch_out[i] = &lane_out[i];
+            }
+
+          // Query the material model for the active level viscosities
+          sim.material_model->evaluate_batch(batch_in, batch_out);
 
-      std::vector<types::global_dof_index> local_dof_indices(fe_projection.dofs_per_cell);
-      for (unsigned int cell=0; cell<n_cells; ++cell)
-        {
-          const unsigned int n_components_filled = stokes_matrix.get_matrix_free()->n_components_filled(cell);
           for (unsigned int i=0; i<n_components_filled; ++i)
             {
-              typename DoFHandler<dim>::active_cell_iterator FEQ_cell =
-                stokes_matrix.get_matrix_free()->get_cell_iterator(cell,i);
+              // If using a cellwise average for viscosity, average the values here.
+              // The projection onto a constant is then the JxW-weighted mean
+              // of the averaged values, i.e., exactly the averaged value.
+              if (projection_degree == 0)
+                MaterialModel::MaterialAveraging::average (sim.parameters.material_averaging,
+                                                           lane_cells[i],
+                                                           quadrature_formula,
+                                                           *sim.mapping,
+                                                           lane_out[i]);
+
+              const std::vector<double> &viscosities = lane_out[i].viscosities;
+
+              // Find the max/min of the evaluated viscosities.
+              for (unsigned int q=0; q<n_q_points; ++q)
+                {
+                  min_el = std::min(min_el, viscosities[q]);
+                  max_el = std::max(max_el, viscosities[q]);
+                }
+
               typename DoFHandler<dim>::active_cell_iterator DG_cell(&(sim.triangulation),
-                                                                     FEQ_cell->level(),
-                                                                     FEQ_cell->index(),
+                                                                     lane_cells[i]->level(),
+                                                                     lane_cells[i]->index(),
                                                                      &dof_handler_projection);
               DG_cell->get_active_or_mg_dof_indices(local_dof_indices);
 
-              // For DGQ0, we simply use the viscosity at the single
-              // support point of the element. For DGQ1, we must project
-              // back to quadrature point values.
-              if (dof_handler_projection.get_fe().degree == 0)
-                active_viscosity_table(cell, 0)[i] = active_viscosity_vector(local_dof_indices[0]);
+              if (projection_degree == 0)
+                {
+                  double integral = 0.;
+                  double volume = 0.;
+                  for (unsigned int q=0; q<n_q_points; ++q)
+                    {
+                      integral += viscosities[q] * lane_JxW[i][q];
+                      volume += lane_JxW[i][q];
+                    }
+
+                  active_viscosity_vector(local_dof_indices[0]) = integral / volume;
+                  active_viscosity_table(cell, 0)[i] = integral / volume;
+                }
               else
                 {
+                  // Compute the local L2 projection onto DGQ1 and evaluate it
+                  // back at the quadrature points.
                   fe_values_projection.reinit(DG_cell);
-                  fe_values_projection.get_function_values(active_viscosity_vector,
-                                                           local_dof_indices,
-                                                           values_on_quad);
 
-                  // Do not allow viscosity to be greater than or less than the limits
-                  // of the evaluated viscosity on the active level.
+                  cell_vector = 0;
+                  local_mass_matrix = 0;
                   for (unsigned int q=0; q<n_q_points; ++q)
-                    active_viscosity_table(cell, q)[i]
-                      = std::min(std::max(values_on_quad[q], min_el), max_el);
+                    for (unsigned int k=0; k<dofs_per_cell; ++k)
+                      {
+                        const double phi_k_JxW = fe_values_projection.shape_value(k,q) * lane_JxW[i][q];
+                        cell_vector(k) += viscosities[q] * phi_k_JxW;
+                        for (unsigned int l=0; l<dofs_per_cell; ++l)
+                          local_mass_matrix(k,l) += fe_values_projection.shape_value(l,q) * phi_k_JxW;
+                      }
+
+                  local_mass_matrix.gauss_jordan();
+                  local_mass_matrix.vmult (local_projection, cell_vector);
+
+                  for (unsigned int k=0; k<dofs_per_cell; ++k)
+                    active_viscosity_vector(local_dof_indices[k]) = local_projection(k);
+
+                  for (unsigned int q=0; q<n_q_points; ++q)
+                    {
+                      double value_on_quad = 0.;
+                      for (unsigned int k=0; k<dofs_per_cell; ++k)
+                        value_on_quad += local_projection(k) * fe_values_projection.shape_value(k,q);
+
+                      active_viscosity_table(cell, q)[i] = value_on_quad;
+                    }
                 }
             }
         }
+
+      // Do not allow viscosity to be greater than or less than the limits
+      // of the evaluated viscosity on the active level.
+      if (projection_degree == 1)
+        for (unsigned int cell=0; cell<n_cells; ++cell)
+          for (unsigned int q=0; q<n_q_points; ++q)
+            for (unsigned int i=0; i<stokes_matrix.get_matrix_free()->n_components_filled(cell); ++i)
+              active_viscosity_table(cell, q)[i]
+                = std::min(std::max(active_viscosity_table(cell, q)[i], min_el), max_el);
+
+      active_viscosity_vector.compress(VectorOperation::insert);
     }
 
     const bool is_compressible = sim.material_model->is_compressible();
@@ -1385,29 +1506,63 @@ namespace aspect
                                                      sim.pressure_scaling);
       }
 
+    // The level viscosities only depend on the active level viscosity vector
+    // and the limits of the evaluated viscosities. If none of them changed
+    // since the last call, e.g., because the viscosity does not depend on the
+    // solution, the level matrices still hold the correct data and we can
+    // skip their (comparably expensive) update. This is not possible if the
+    // mesh deforms, because the level matrices also depend on the geometry.
+    bool level_viscosity_unchanged = (!sim.parameters.mesh_deformation_enabled
+                                      && previous_active_viscosity_vector.size() == active_viscosity_vector.size()
+                                      && previous_viscosity_limits.first == min_el
+                                      && previous_viscosity_limits.second == max_el
+                                      && previous_pressure_scaling == sim.pressure_scaling);
+    if (level_viscosity_unchanged)
+      for (unsigned int i=0; i<active_viscosity_vector.local_size(); ++i)
+        if (active_viscosity_vector.local_element(i) != previous_active_viscosity_vector.local_element(i))
+          {
+            level_viscosity_unchanged = false;
+            break;
+          }
+    level_viscosity_unchanged = (Utilities::MPI::min (level_viscosity_unchanged ? 1 : 0,
+                                                      sim.triangulation.get_communicator()) == 1);
+
+    if (level_viscosity_unchanged)
+      {
+        compute_free_surface_stabilization();
+        return;
+      }
+
+    previous_active_viscosity_vector = active_viscosity_vector;
+    previous_viscosity_limits = std::make_pair(min_el, max_el);
+    previous_pressure_scaling = sim.pressure_scaling;
+    level_viscosity_changed = true;
+
     const unsigned int n_levels = sim.triangulation.n_global_levels();
     level_viscosity_vector = 0.;
     level_viscosity_vector.resize(0,n_levels-1);
 
     // Project the active level viscosity vector to multilevel vector representations
     // using MG transfer objects. This transfer is based on the same linear operator used to
-    // transfer data inside a v-cycle.
-    MGTransferMatrixFree<dim,GMGNumberType> transfer;
-    transfer.build(dof_handler_projection);
-
-    // Explicitly pick the version with template argument double to convert
-    // double-valued active_viscosity_vector to GMGNumberType-valued
+    // transfer data inside a v-cycle. Explicitly pick the version with template argument
+    // double to convert double-valued active_viscosity_vector to GMGNumberType-valued
     // level_viscosity_vector:
-    transfer.template interpolate_to_mg<double>(dof_handler_projection,
-                                                level_viscosity_vector,
-                                                active_viscosity_vector);
+    mg_transfer_projection.template interpolate_to_mg<double>(dof_handler_projection,
+                                                              level_viscosity_vector,
+                                                              active_viscosity_vector);
+
+    // Level cells are not active, so we need to use the level mapping here
+    // (which makes no difference for the shape function values we need).
+    FEValues<dim> fe_values_projection_level (get_level_mapping(),
+                                              fe_projection,
+                                              quadrature_formula,
+                                              update_values);
 
     level_viscosity_tables.resize(0,n_levels-1);
     for (unsigned int level=0; level<n_levels; ++level)
       {
         // Create viscosity tables on each level.
         const unsigned int n_cells = mg_matrices_A_block[level].get_matrix_free()->n_macro_cells();
-        const unsigned int n_q_points = quadrature_formula.size();
 
         std::vector<GMGNumberType> values_on_quad;
 
@@ -1442,10 +1597,10 @@ namespace aspect
                   level_viscosity_tables[level](cell, 0)[i] = level_viscosity_vector[level](local_dof_indices[0]);
                 else
                   {
-                    fe_values_projection.reinit(DG_cell);
-                    fe_values_projection.get_function_values(level_viscosity_vector[level],
-                                                             local_dof_indices,
-                                                             values_on_quad);
+                    fe_values_projection_level.reinit(DG_cell);
+                    fe_values_projection_level.get_function_values(level_viscosity_vector[level],
+                                                                   local_dof_indices,
+                                                                   values_on_quad);
 
                     // Do not allow viscosity to be greater than or less than the limits
                     // of the evaluated viscosity on the active level.
@@ -1463,6 +1618,96 @@ namespace aspect
         mg_matrices_Schur_complement[level].fill_cell_data (level_viscosity_tables[level],
                                                             sim.pressure_scaling);
       }
+
+    compute_free_surface_stabilization();
+  }
+
+
+
+  template <int dim, int velocity_degree>
+  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::compute_free_surface_stabilization ()
+  {
+    if (!sim.parameters.mesh_deformation_enabled
+        || sim.mesh_deformation->get_free_surface_boundary_indicators().empty())
+      return;
+
+    const std::set<types::boundary_id> &free_surface_boundary_indicators
+      = sim.mesh_deformation->get_free_surface_boundary_indicators();
+    const double free_surface_theta
+      = sim.mesh_deformation->template get_matching_mesh_deformation_object<MeshDeformation::FreeSurface<dim>>().get_free_surface_theta();
+
+    const MatrixFree<dim,double> &matrix_free = *stokes_matrix.get_matrix_free();
+    const unsigned int n_inner_faces = matrix_free.n_inner_face_batches();
+    const unsigned int n_boundary_faces = matrix_free.n_boundary_face_batches();
+
+    FEFaceEvaluation<dim,velocity_degree,velocity_degree+1,dim,double>
+    velocity_boundary (matrix_free, true, 0);
+
+    free_surface_stabilization_table.reinit(TableIndices<2>(n_boundary_faces, velocity_boundary.n_q_points));
+
+    // As in the matrix-based assembler, the density is computed from the
+    // current solution. We use one averaged value per face, consistent with
+    // the averaged viscosity used by the matrix-free operators.
+    const QGauss<dim-1> face_quadrature_formula (sim.parameters.stokes_velocity_degree+1);
+    FEFaceValues<dim> fe_face_values (*sim.mapping,
+                                      sim.finite_element,
+                                      face_quadrature_formula,
+                                      update_values |
+                                      update_gradients |
+                                      update_quadrature_points |
+                                      update_JxW_values);
+
+    MaterialModel::MaterialModelInputs<dim> in(fe_face_values.n_quadrature_points, sim.introspection.n_compositional_fields);
+    MaterialModel::MaterialModelOutputs<dim> out(fe_face_values.n_quadrature_points, sim.introspection.n_compositional_fields);
+
+    for (unsigned int face=n_inner_faces; face<n_inner_faces+n_boundary_faces; ++face)
+      {
+        if (free_surface_boundary_indicators.find(matrix_free.get_boundary_id(face))
+            == free_surface_boundary_indicators.end())
+          continue;
+
+        velocity_boundary.reinit(face);
+
+        for (unsigned int v=0; v<matrix_free.n_active_entries_per_face_batch(face); ++v)
+          {
+            const auto cell_and_face = matrix_free.get_face_iterator(face, v);
+            const typename DoFHandler<dim>::active_cell_iterator cell(&sim.triangulation,
+                                                                      cell_and_face.first->level(),
+                                                                      cell_and_face.first->index(),
+                                                                      &sim.dof_handler);
+
+            fe_face_values.reinit(cell, cell_and_face.second);
+            in.reinit(fe_face_values, cell, sim.introspection, sim.solution);
+            sim.material_model->evaluate(in, out);
+
+            double density = 0.;
+            double face_area = 0.;
+            for (unsigned int q=0; q<fe_face_values.n_quadrature_points; ++q)
+              {
+                density += out.densities[q] * fe_face_values.JxW(q);
+                face_area += fe_face_values.JxW(q);
+              }
+            density /= face_area;
+
+            for (unsigned int q=0; q<velocity_boundary.n_q_points; ++q)
+              {
+                Point<dim> position;
+                for (unsigned int d=0; d<dim; ++d)
+                  position[d] = velocity_boundary.quadrature_point(q)[d][v];
+
+                const Tensor<1,dim> gravity = sim.gravity_model->gravity_vector(position);
+
+                for (unsigned int d=0; d<dim; ++d)
+                  free_surface_stabilization_table(face-n_inner_faces, q)[d][v]
+                    = density * sim.time_step * free_surface_theta * gravity[d];
+              }
+          }
+      }
+
+    // Note that the level operators of the GMG preconditioner do not include
+    // this term, see the documentation of this function.
+    stokes_matrix.set_free_surface_stabilization(free_surface_stabilization_table,
+                                                 free_surface_boundary_indicators);
   }
 
 
@@ -1537,6 +1782,43 @@ namespace aspect
         pressure.integrate (true,false);
         pressure.distribute_local_to_global (rhs_correction.block(1));
       }
+
+    // The free surface stabilization term is part of the Stokes operator
+    // and therefore also needs to be applied to the boundary values.
+    if (sim.parameters.mesh_deformation_enabled
+        && !sim.mesh_deformation->get_free_surface_boundary_indicators().empty())
+      {
+        const std::set<types::boundary_id> &free_surface_boundary_indicators
+          = sim.mesh_deformation->get_free_surface_boundary_indicators();
+        const MatrixFree<dim,double> &matrix_free = *stokes_matrix.get_matrix_free();
+        const unsigned int n_inner_faces = matrix_free.n_inner_face_batches();
+
+        FEFaceEvaluation<dim,velocity_degree,velocity_degree+1,dim,double>
+        velocity_boundary (matrix_free, true, 0);
+
+        for (unsigned int face=n_inner_faces; face<n_inner_faces+matrix_free.n_boundary_face_batches(); ++face)
+          {
+            if (free_surface_boundary_indicators.find(matrix_free.get_boundary_id(face))
+                == free_surface_boundary_indicators.end())
+              continue;
+
+            velocity_boundary.reinit (face);
+            velocity_boundary.read_dof_values_plain (u0.block(0));
+            velocity_boundary.evaluate (true,false);
+
+            for (unsigned int q=0; q<velocity_boundary.n_q_points; ++q)
+              {
+                const VectorizedArray<double> normal_velocity
+                  = velocity_boundary.get_value(q) * velocity_boundary.get_normal_vector(q);
+
+                velocity_boundary.submit_value (free_surface_stabilization_table(face-n_inner_faces, q) * normal_velocity, q);
+              }
+
+            velocity_boundary.integrate (true,false);
+            velocity_boundary.distribute_local_to_global (rhs_correction.block(0));
+          }
+      }
+
     rhs_correction.compress(VectorOperation::add);
 
     // Copy to the correct vector type and add the correction to the system rhs.
@@ -2038,6 +2320,16 @@ namespace aspect
       DoFTools::extract_locally_relevant_dofs (dof_handler_v,
                                                locally_relevant_dofs);
       constraints_v.reinit(locally_relevant_dofs);
+
+      // Periodic constraints have to be set up before the hanging node
+      // constraints, see Simulator::setup_dofs().
+      for (const auto &p : sim.geometry_model->get_periodic_boundary_pairs())
+        DoFTools::make_periodicity_constraints(dof_handler_v,
+                                               p.first.first,  // first boundary id
+                                               p.first.second, // second boundary id
+                                               p.second,       // cartesian direction for translational symmetry
+                                               constraints_v);
+
       DoFTools::make_hanging_node_constraints (dof_handler_v, constraints_v);
       sim.compute_initial_velocity_boundary_constraints(constraints_v);
       sim.compute_current_velocity_boundary_constraints(constraints_v);
@@ -2064,6 +2356,14 @@ namespace aspect
       DoFTools::extract_locally_relevant_dofs (dof_handler_p,
                                                locally_relevant_dofs);
       constraints_p.reinit(locally_relevant_dofs);
+
+      for (const auto &p : sim.geometry_model->get_periodic_boundary_pairs())
+        DoFTools::make_periodicity_constraints(dof_handler_p,
+                                               p.first.first,
+                                               p.first.second,
+                                               p.second,
+                                               constraints_p);
+
       DoFTools::make_hanging_node_constraints (dof_handler_p, constraints_p);
       constraints_p.close();
     }
@@ -2115,7 +2415,30 @@ namespace aspect
       dof_handler_projection.distribute_mg_dofs();
     }
 
-    // Setup the matrix-free operators
+    setup_operators();
+
+    // Build MG transfer
+    mg_transfer_A_block.clear();
+    mg_transfer_A_block.initialize_constraints(mg_constrained_dofs_A_block);
+    mg_transfer_A_block.build(dof_handler_v);
+
+    mg_transfer_Schur_complement.clear();
+    mg_transfer_Schur_complement.initialize_constraints(mg_constrained_dofs_Schur_complement);
+    mg_transfer_Schur_complement.build(dof_handler_p);
+
+    mg_transfer_projection.clear();
+    mg_transfer_projection.build(dof_handler_projection);
+  }
+
+
+
+  template <int dim, int velocity_degree>
+  void StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::setup_operators()
+  {
+    // The level matrices are recreated below, so the level viscosities have
+    // to be recomputed in the next call to evaluate_material_model().
+    previous_active_viscosity_vector.reinit(0);
+    level_viscosity_changed = true;
 
     // Stokes matrix
     {
@@ -2125,6 +2448,12 @@ namespace aspect
       additional_data.mapping_update_flags = (update_values | update_gradients |
                                               update_JxW_values | update_quadrature_points);
 
+      // The free surface stabilization term requires data on boundary faces.
+      if (sim.parameters.mesh_deformation_enabled
+          && !sim.mesh_deformation->get_free_surface_boundary_indicators().empty())
+        additional_data.mapping_update_flags_boundary_faces = (update_values | update_JxW_values |
+                                                               update_normal_vectors | update_quadrature_points);
+
       std::vector<const DoFHandler<dim>*> stokes_dofs;
       stokes_dofs.push_back(&dof_handler_v);
       stokes_dofs.push_back(&dof_handler_p);
@@ -2176,6 +2505,7 @@ namespace aspect
     // GMG matrices
     {
       const unsigned int n_levels = sim.triangulation.n_global_levels();
+      const Mapping<dim> &level_mapping = get_level_mapping();
 
       // ABlock GMG
       mg_matrices_A_block.clear_elements();
@@ -2188,6 +2518,10 @@ namespace aspect
           AffineConstraints<double> level_constraints;
           level_constraints.reinit(relevant_dofs);
           level_constraints.add_lines(mg_constrained_dofs_A_block.get_boundary_indices(level));
+          // MGConstrainedDoFs::initialize() already computed the periodicity
+          // constraints on this level:
+          level_constraints.merge(mg_constrained_dofs_A_block.get_level_constraints(level),
+                                  AffineConstraints<double>::left_object_wins);
           level_constraints.close();
 
           std::set<types::boundary_id> no_flux_boundary
@@ -2199,7 +2533,7 @@ namespace aspect
 
               internal::TangentialBoundaryFunctions::compute_no_normal_flux_constraints_shell(dof_handler_v,
                                                                                               mg_constrained_dofs_A_block,
-                                                                                              *sim.mapping,
+                                                                                              level_mapping,
                                                                                               level,
                                                                                               0,
                                                                                               no_flux_boundary,
@@ -2221,7 +2555,7 @@ namespace aspect
             additional_data.mg_level = level;
             std::shared_ptr<MatrixFree<dim,GMGNumberType> >
             mg_mf_storage_level(new MatrixFree<dim,GMGNumberType>());
-            mg_mf_storage_level->reinit(*sim.mapping, dof_handler_v, level_constraints,
+            mg_mf_storage_level->reinit(level_mapping, dof_handler_v, level_constraints,
                                         QGauss<1>(sim.parameters.stokes_velocity_degree+1),
                                         additional_data);
 
@@ -2241,6 +2575,7 @@ namespace aspect
           DoFTools::extract_locally_relevant_level_dofs(dof_handler_p, level, relevant_dofs);
           AffineConstraints<double> level_constraints;
           level_constraints.reinit(relevant_dofs);
+          level_constraints.merge(mg_constrained_dofs_Schur_complement.get_level_constraints(level));
           level_constraints.close();
 
           {
@@ -2252,7 +2587,7 @@ namespace aspect
             additional_data.mg_level = level;
             std::shared_ptr<MatrixFree<dim,GMGNumberType> >
             mg_mf_storage_level(new MatrixFree<dim,GMGNumberType>());
-            mg_mf_storage_level->reinit(*sim.mapping, dof_handler_p, level_constraints,
+            mg_mf_storage_level->reinit(level_mapping, dof_handler_p, level_constraints,
                                         QGauss<1>(sim.parameters.stokes_velocity_degree+1),
                                         additional_data);
 
@@ -2261,15 +2596,18 @@ namespace aspect
           }
         }
     }
+  }
 
-    // Build MG transfer
-    mg_transfer_A_block.clear();
-    mg_transfer_A_block.initialize_constraints(mg_constrained_dofs_A_block);
-    mg_transfer_A_block.build(dof_handler_v);
 
-    mg_transfer_Schur_complement.clear();
-    mg_transfer_Schur_complement.initialize_constraints(mg_constrained_dofs_Schur_complement);
-    mg_transfer_Schur_complement.build(dof_handler_p);
+
+  template <int dim, int velocity_degree>
+  const Mapping<dim> &
+  StokesMatrixFreeHandlerImplementation<dim, velocity_degree>::get_level_mapping () const
+  {
+    if (sim.parameters.mesh_deformation_enabled)
+      return sim.mesh_deformation->get_level_mapping();
+    else
+      return *sim.mapping;
   }
 
 
@@ -2279,6 +2617,11 @@ namespace aspect
   {
     TimerOutput::Scope timer (this->sim.computing_timer, "Build Stokes preconditioner");
 
+    // The diagonals of the level matrices are still valid if the level
+    // viscosities did not change since the last time they were computed.
+    if (!level_viscosity_changed)
+      return;
+
     const bool is_compressible = sim.material_model->is_compressible();
 
     // Assemble and store the diagonal of the GMG level matrices derived from:
@@ -2308,7 +2651,7 @@ namespace aspect
             FEValues<dim> fe_values (fe_v, quadrature_formula,
                                      update_values   | update_gradients |
                                      update_quadrature_points | update_JxW_values);
-            FEValues<dim> fe_values_projection (*(sim.mapping),
+            FEValues<dim> fe_values_projection (get_level_mapping(),
                                                 fe_projection,
                                                 quadrature_formula,
                                                 update_values);
@@ -2409,6 +2752,8 @@ namespace aspect
         // This vector is no longer needed. Resize to 0.
         level_viscosity_vector[level].reinit(0);
       }
+
+    level_viscosity_changed = false;
   }
 
 
@@ -47,6 +47,7 @@
 #include <aspect/geometry_model/chunk.h>
 #include <aspect/geometry_model/initial_topography_model/ascii_data.h>
 
+#include <exception>
 #include <fstream>
 #include <string>
 #include <locale>
@@ -934,6 +935,58 @@ namespace aspect
     }
 
 
+    void real_spherical_harmonics (const unsigned int max_degree,
+                                   const double theta,
+                                   const double phi,
+                                   std::vector<std::vector<double> > &cosine_components,
+                                   std::vector<std::vector<double> > &sine_components)
+    {
+      const double cos_theta = std::cos(theta);
+      const double sin_theta = std::sin(theta);
+
+      cosine_components.resize(max_degree+1);
+      sine_components.resize(max_degree+1);
+      for (unsigned int l=0; l<=max_degree; ++l)
+        {
+          cosine_components[l].resize(l+1);
+          sine_components[l].resize(l+1);
+        }
+
+      // First compute the fully normalized associated Legendre functions
+      //   P_lm = sqrt((2l+1)/(4 pi) (l-m)!/(l+m)!) P_l^m(cos theta),
+      // including the Condon-Shortley phase as boost does, and store them in
+      // cosine_components. For every order m, start from P_mm and P_(m+1)m
+      // and use the recurrence in l for the higher degrees.
+      double p_mm = std::sqrt(1./(4.*numbers::PI));
+      for (unsigned int m=0; m<=max_degree; ++m)
+        {
+          if (m > 0)
+            p_mm *= -std::sqrt((2.*m+1.)/(2.*m)) * sin_theta;
+
+          cosine_components[m][m] = p_mm;
+          if (m < max_degree)
+            cosine_components[m+1][m] = std::sqrt(2.*m+3.) * cos_theta * p_mm;
+
+          for (unsigned int l=m+2; l<=max_degree; ++l)
+            {
+              const double a_lm = std::sqrt((4.*l*l-1.)/(1.*l*l-1.*m*m));
+              const double b_lm = std::sqrt(((l-1.)*(l-1.)-1.*m*m)/(4.*(l-1.)*(l-1.)-1.));
+              cosine_components[l][m] = a_lm * (cos_theta * cosine_components[l-1][m]
+                                                - b_lm * cosine_components[l-2][m]);
+            }
+
+          // then multiply by the longitudinal part
+          const double cos_factor = (m == 0 ? 1. : numbers::SQRT2 * std::cos(m*phi));
+          const double sin_factor = (m == 0 ? 0. : numbers::SQRT2 * std::sin(m*phi));
+          for (unsigned int l=m; l<=max_degree; ++l)
+            {
+              sine_components[l][m] = sin_factor * cosine_components[l][m];
+              cosine_components[l][m] *= cos_factor;
+            }
+        }
+    }
+
+
     bool
     fexists(const std::string &filename)
     {
@@ -1655,7 +1708,10 @@ namespace aspect
       data(components),
       maximum_component_value(components),
       scale_factor(scale_factor),
-      coordinate_values_are_equidistant(false)
+      coordinate_values_are_equidistant(false),
+      shared_data(nullptr),
+      shared_data_window(MPI_WIN_NULL),
+      shared_data_communicator(MPI_COMM_NULL)
     {}
 
 
@@ -1667,11 +1723,33 @@ namespace aspect
       data(),
       maximum_component_value(),
       scale_factor(scale_factor),
-      coordinate_values_are_equidistant(false)
+      coordinate_values_are_equidistant(false),
+      shared_data(nullptr),
+      shared_data_window(MPI_WIN_NULL),
+      shared_data_communicator(MPI_COMM_NULL)
     {}
 
 
 
+    template <int dim>
+    AsciiDataLookup<dim>::~AsciiDataLookup()
+    {
+      // This is the same as free_shared_data(), but destructors must not
+      // throw exceptions, so only report errors.
+      if (shared_data_window != MPI_WIN_NULL)
+        {
+          const int ierr = MPI_Win_free(&shared_data_window);
+          AssertNothrow(ierr == MPI_SUCCESS, ExcMPI(ierr));
+        }
+      if (shared_data_communicator != MPI_COMM_NULL)
+        {
+          const int ierr = MPI_Comm_free(&shared_data_communicator);
+          AssertNothrow(ierr == MPI_SUCCESS, ExcMPI(ierr));
+        }
+    }
+
+
+
     template <int dim>
     std::vector<std::string>
     AsciiDataLookup<dim>::get_column_names() const
@@ -1728,9 +1806,7 @@ namespace aspect
 
     template <int dim>
     void
-    AsciiDataLookup<dim>::reinit(const std::vector<std::string> &column_names,
-                                 const std::vector<std::vector<double>> &coordinate_values_,
-                                 const std::vector<Table<dim,double> > &raw_data)
+    AsciiDataLookup<dim>::setup_coordinates(const std::vector<std::vector<double>> &coordinate_values_)
     {
       Assert(coordinate_values_.size()==dim, ExcMessage("Invalid size of coordinate_values."));
       for (unsigned int d=0; d<dim; ++d)
@@ -1741,37 +1817,15 @@ namespace aspect
           table_points[d] = coordinate_values_[d].size();
         }
 
-      components = column_names.size();
-      data_component_names = column_names;
-      Assert(raw_data.size() == components,
-             ExcMessage("Error: Incorrect number of columns specified."));
-
-      // compute maximum_component_value for each component:
-      maximum_component_value = std::vector<double>(components,-std::numeric_limits<double>::max());
-      for (unsigned int c=0; c<components; ++c)
-        {
-          Assert(raw_data[c].size() == table_points,
-                 ExcMessage("Error: One of the data tables has an incorrect size."));
-
-          const unsigned int n_elements = raw_data[c].n_elements();
-          for (unsigned int idx=0; idx<n_elements; ++idx)
-            maximum_component_value[c] = std::max(maximum_component_value[c], raw_data[c](
-                                                    compute_table_indices(table_points, idx)));
-        }
-
       // In case the data is specified on a grid that is equidistant
       // in each coordinate direction, we only need to store
       // (besides the data) the number of intervals in each direction and
       // the begin- and endpoints of the coordinates.
       // In case the grid is not equidistant, we need to keep
       // all the coordinates in each direction, which is more costly.
-      std::array<unsigned int,dim> table_intervals;
-
       coordinate_values_are_equidistant = true;
       for (unsigned int d=0; d<dim; ++d)
         {
-          table_intervals[d] = table_points[d]-1;
-
           // The minimum and maximum coordinate values:
           grid_extent[d].first = coordinate_values[d][0];
           grid_extent[d].second = coordinate_values[d][table_points[d]-1];
@@ -1796,6 +1850,40 @@ namespace aspect
                 coordinate_values_are_equidistant = false;
             }
         }
+    }
+
+
+
+    template <int dim>
+    void
+    AsciiDataLookup<dim>::reinit(const std::vector<std::string> &column_names,
+                                 const std::vector<std::vector<double>> &coordinate_values_,
+                                 const std::vector<Table<dim,double> > &raw_data)
+    {
+      free_shared_data();
+      setup_coordinates(coordinate_values_);
+
+      components = column_names.size();
+      data_component_names = column_names;
+      Assert(raw_data.size() == components,
+             ExcMessage("Error: Incorrect number of columns specified."));
+
+      // compute maximum_component_value for each component:
+      maximum_component_value = std::vector<double>(components,-std::numeric_limits<double>::max());
+      for (unsigned int c=0; c<components; ++c)
+        {
+          Assert(raw_data[c].size() == table_points,
+                 ExcMessage("Error: One of the data tables has an incorrect size."));
+
+          const unsigned int n_elements = raw_data[c].n_elements();
+          for (unsigned int idx=0; idx<n_elements; ++idx)
+            maximum_component_value[c] = std::max(maximum_component_value[c], raw_data[c](
+                                                    compute_table_indices(table_points, idx)));
+        }
+
+      std::array<unsigned int,dim> table_intervals;
+      for (unsigned int d=0; d<dim; ++d)
+        table_intervals[d] = table_points[d]-1;
 
       // For each data component, set up a GridData,
       // its type depending on the read-in grid.
@@ -1817,18 +1905,12 @@ namespace aspect
 
 
     template <int dim>
-    void
-    AsciiDataLookup<dim>::load_file(const std::string &filename,
-                                    const MPI_Comm &comm)
+    double
+    AsciiDataLookup<dim>::read_file_header(std::istream &in,
+                                           const std::string &filename,
+                                           TableIndices<dim> &new_table_points,
+                                           std::vector<std::string> &column_names)
     {
-      // Grab the values already stored in this class (if they exist), this way we can
-      // check if somebody changes the size of the table over time and error out (see below)
-      TableIndices<dim> new_table_points = this->table_points;
-      std::vector<std::string> column_names;
-
-      // Read data from disk and distribute among processes
-      std::stringstream in(read_and_distribute_file_content(filename, comm));
-
       // Read header lines and table size
       while (in.peek() == '#')
         {
@@ -1867,7 +1949,7 @@ namespace aspect
 
       // Read column lines if present
       unsigned int name_column_index = 0;
-      double temp_data;
+      double temp_data = 0.;
 
       while (true)
         {
@@ -1921,17 +2003,6 @@ namespace aspect
             }
         }
 
-      // Create table for the data. This peculiar reinit is necessary, because
-      // there is no constructor for Table, which takes TableIndices as
-      // argument.
-      Table<dim,double> data_table;
-      data_table.TableBase<dim,double>::reinit(new_table_points);
-      std::vector<Table<dim,double> > data_tables(components, data_table);
-
-      std::vector<std::vector<double>> coordinate_values(dim);
-      for (unsigned int d=0; d<dim; ++d)
-        coordinate_values[d].resize(new_table_points[d]);
-
       if (column_names.size()==0)
         {
           // set default column names:
@@ -1939,14 +2010,29 @@ namespace aspect
             column_names.push_back("column " + Utilities::int_to_string(c,2));
         }
 
+      return temp_data;
+    }
+
+
+
+    template <int dim>
+    void
+    AsciiDataLookup<dim>::read_file_data(std::istream &in,
+                                         const std::string &filename,
+                                         const double first_value,
+                                         const TableIndices<dim> &new_table_points,
+                                         std::vector<std::vector<double>> &coordinate_values,
+                                         const std::function<void (const unsigned int, const std::size_t, const double)> &store_data_value) const
+    {
       // Finally read data lines:
+      double temp_data = first_value;
       unsigned int read_data_entries = 0;
       do
         {
           // what row and column of the file are we in?
           const unsigned int column_num = read_data_entries%(components+dim);
           const unsigned int row_num = read_data_entries/(components+dim);
-          TableIndices<dim> idx = compute_table_indices(new_table_points, row_num);
+          const TableIndices<dim> idx = compute_table_indices(new_table_points, row_num);
 
           if (column_num < dim)
             {
@@ -1969,7 +2055,7 @@ namespace aspect
             {
               // This is a data value, so scale and store:
               const unsigned int component = column_num - dim;
-              data_tables[component](idx) = temp_data * scale_factor;
+              store_data_value (component, row_num, temp_data * scale_factor);
             }
 
           ++read_data_entries;
@@ -1982,7 +2068,11 @@ namespace aspect
                               "Please check for malformed data values (e.g. NaN) or superfluous "
                               "lines at the end of the data file."));
 
-      const unsigned int n_expected_data_entries = (components + dim) * data_table.n_elements();
+      std::size_t n_data_points = 1;
+      for (unsigned int d=0; d<dim; ++d)
+        n_data_points *= new_table_points[d];
+
+      const unsigned int n_expected_data_entries = (components + dim) * n_data_points;
       AssertThrow(read_data_entries == n_expected_data_entries,
                   ExcMessage ("While reading the data file '" + filename + "' the ascii data "
                               "plugin has reached the end of the file, but has not found the "
@@ -1990,18 +2080,350 @@ namespace aspect
                               "data columns, and number of lines prescribed by the POINTS header "
                               "of the file. Please check the number of data "
                               "lines against the POINTS header in the file."));
+    }
+
+
+
+    template <int dim>
+    void
+    AsciiDataLookup<dim>::load_file(const std::string &filename,
+                                    const MPI_Comm &comm,
+                                    const bool store_in_shared_memory)
+    {
+      if (store_in_shared_memory)
+        {
+          load_file_into_shared_memory(filename, comm);
+          return;
+        }
+
+      // Grab the values already stored in this class (if they exist), this way we can
+      // check if somebody changes the size of the table over time and error out (see below)
+      TableIndices<dim> new_table_points = this->table_points;
+      std::vector<std::string> column_names;
+
+      // Read data from disk and distribute among processes
+      std::stringstream in(read_and_distribute_file_content(filename, comm));
+
+      const double first_value = read_file_header(in, filename, new_table_points, column_names);
+
+      // Create table for the data. This peculiar reinit is necessary, because
+      // there is no constructor for Table, which takes TableIndices as
+      // argument.
+      Table<dim,double> data_table;
+      data_table.TableBase<dim,double>::reinit(new_table_points);
+      std::vector<Table<dim,double> > data_tables(components, data_table);
+
+      std::vector<std::vector<double>> coordinate_values(dim);
+      for (unsigned int d=0; d<dim; ++d)
+        coordinate_values[d].resize(new_table_points[d]);
+
+      read_file_data(in, filename, first_value, new_table_points, coordinate_values,
+                     [&](const unsigned int component, const std::size_t point_index, const double value)
+      {
+        data_tables[component](compute_table_indices(new_table_points, point_index)) = value;
+      });
 
       // finally create the data:
       this->reinit(column_names, coordinate_values, data_tables);
     }
 
 
+
+    template <int dim>
+    void
+    AsciiDataLookup<dim>::load_file_into_shared_memory(const std::string &filename,
+                                                       const MPI_Comm &comm)
+    {
+#if DEAL_II_MPI_VERSION_GTE(3,0)
+      free_shared_data();
+      data.clear();
+
+      // Group all processes that can share memory, i.e., those on the same node.
+      const unsigned int my_id = Utilities::MPI::this_mpi_process(comm);
+      int ierr = MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, my_id,
+                                     MPI_INFO_NULL, &shared_data_communicator);
+      AssertThrowMPI(ierr);
+      const bool is_node_root = (Utilities::MPI::this_mpi_process(shared_data_communicator) == 0);
+
+      // Only one process per node reads and parses the file, so first
+      // distribute the file content among these processes.
+      MPI_Comm node_root_communicator;
+      ierr = MPI_Comm_split(comm, (is_node_root ? 0 : MPI_UNDEFINED), my_id,
+                            &node_root_communicator);
+      AssertThrowMPI(ierr);
+
+      // Only the root process of each node reads the file, while all other
+      // processes of the node wait for it in the collective calls below.
+      // If reading fails on the root, we therefore have to tell the other
+      // processes before they enter the next collective call, and throw an
+      // exception on all of them together (the root throws the original
+      // exception, all others a QuietException, as in create_directory()).
+      const auto check_for_errors_on_node_root = [&](const std::exception_ptr &root_exception)
+      {
+        int error = (root_exception != nullptr ? 1 : 0);
+        ierr = MPI_Bcast(&error, 1, MPI_INT, 0, shared_data_communicator);
+        AssertThrowMPI(ierr);
+
+        if (error != 0)
+          {
+            free_shared_data();
+            if (root_exception != nullptr)
+              std::rethrow_exception(root_exception);
+            else
+              throw aspect::QuietException();
+          }
+      };
+
+      TableIndices<dim> new_table_points = this->table_points;
+      std::vector<std::string> column_names;
+      std::stringstream in;
+      double first_value = 0.;
+
+      std::exception_ptr root_exception;
+      if (is_node_root)
+        {
+          try
+            {
+              in.str(read_and_distribute_file_content(filename, node_root_communicator));
+              first_value = read_file_header(in, filename, new_table_points, column_names);
+            }
+          catch (...)
+            {
+              root_exception = std::current_exception();
+            }
+
+          ierr = MPI_Comm_free(&node_root_communicator);
+          AssertThrowMPI(ierr);
+        }
+      check_for_errors_on_node_root(root_exception);
+
+      // Then tell all other processes on the node about the size of the data.
+      ierr = MPI_Bcast(&components, 1, MPI_UNSIGNED, 0, shared_data_communicator);
+      AssertThrowMPI(ierr);
+
+      std::array<unsigned int,dim> n_points_per_direction;
+      for (unsigned int d=0; d<dim; ++d)
+        n_points_per_direction[d] = new_table_points[d];
+      ierr = MPI_Bcast(n_points_per_direction.data(), dim, MPI_UNSIGNED, 0, shared_data_communicator);
+      AssertThrowMPI(ierr);
+
+      std::size_t n_points = 1;
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          new_table_points[d] = n_points_per_direction[d];
+          n_points *= n_points_per_direction[d];
+        }
+
+      {
+        std::vector<char> packed_column_names;
+        if (is_node_root)
+          packed_column_names = Utilities::pack(column_names, false);
+
+        unsigned int size = packed_column_names.size();
+        ierr = MPI_Bcast(&size, 1, MPI_UNSIGNED, 0, shared_data_communicator);
+        AssertThrowMPI(ierr);
+        packed_column_names.resize(size);
+        ierr = MPI_Bcast(packed_column_names.data(), size, MPI_CHAR, 0, shared_data_communicator);
+        AssertThrowMPI(ierr);
+
+        if (!is_node_root)
+          column_names = Utilities::unpack<std::vector<std::string>>(packed_column_names, false);
+      }
+
+      // Allocate the shared memory on the root process of the node, and let
+      // all other processes query where it is located in their address space.
+      double *data_pointer = nullptr;
+      const MPI_Aint window_size = (is_node_root
+                                    ?
+                                    components * n_points * sizeof(double)
+                                    :
+                                    0);
+      ierr = MPI_Win_allocate_shared(window_size, sizeof(double), MPI_INFO_NULL,
+                                     shared_data_communicator, &data_pointer, &shared_data_window);
+      AssertThrowMPI(ierr);
+
+      if (!is_node_root)
+        {
+          MPI_Aint root_window_size;
+          int displacement_unit;
+          ierr = MPI_Win_shared_query(shared_data_window, 0, &root_window_size,
+                                      &displacement_unit, &data_pointer);
+          AssertThrowMPI(ierr);
+        }
+
+      ierr = MPI_Win_fence(0, shared_data_window);
+      AssertThrowMPI(ierr);
+
+      std::vector<std::vector<double>> coordinate_values(dim);
+      for (unsigned int d=0; d<dim; ++d)
+        coordinate_values[d].resize(new_table_points[d]);
+
+      maximum_component_value = std::vector<double>(components,-std::numeric_limits<double>::max());
+
+      if (is_node_root)
+        {
+          try
+            {
+              read_file_data(in, filename, first_value, new_table_points, coordinate_values,
+                             [&](const unsigned int component, const std::size_t point_index, const double value)
+              {
+                data_pointer[component * n_points + point_index] = value;
+                maximum_component_value[component] = std::max(maximum_component_value[component], value);
+              });
+            }
+          catch (...)
+            {
+              root_exception = std::current_exception();
+            }
+        }
+
+      ierr = MPI_Win_fence(0, shared_data_window);
+      AssertThrowMPI(ierr);
+      check_for_errors_on_node_root(root_exception);
+
+      // Finally distribute the (small) coordinate values and maximal
+      // values, which every process stores itself.
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          ierr = MPI_Bcast(coordinate_values[d].data(), coordinate_values[d].size(), MPI_DOUBLE,
+                           0, shared_data_communicator);
+          AssertThrowMPI(ierr);
+        }
+      ierr = MPI_Bcast(maximum_component_value.data(), components, MPI_DOUBLE,
+                       0, shared_data_communicator);
+      AssertThrowMPI(ierr);
+
+      data_component_names = column_names;
+      setup_coordinates(coordinate_values);
+      shared_data = data_pointer;
+#else
+      (void)filename;
+      (void)comm;
+      AssertThrow(false,
+                  ExcMessage("Storing ascii data in shared memory requires an MPI library "
+                             "that supports the MPI 3.0 standard."));
+#endif
+    }
+
+
+
+    template <int dim>
+    void
+    AsciiDataLookup<dim>::free_shared_data()
+    {
+      if (shared_data_window != MPI_WIN_NULL)
+        {
+          const int ierr = MPI_Win_free(&shared_data_window);
+          AssertThrowMPI(ierr);
+        }
+      if (shared_data_communicator != MPI_COMM_NULL)
+        {
+          const int ierr = MPI_Comm_free(&shared_data_communicator);
+          AssertThrowMPI(ierr);
+        }
+      shared_data = nullptr;
+    }
+
+
+
+    template <int dim>
+    double
+    AsciiDataLookup<dim>::interpolate_shared_data(const Point<dim> &position,
+                                                  const unsigned int component,
+                                                  Tensor<1,dim> *gradient) const
+    {
+      Assert(shared_data != nullptr, ExcInternalError());
+
+      // Find the interval the point lies in, and its relative position within
+      // this interval. Points outside the grid are projected onto its
+      // boundary.
+      TableIndices<dim> ix;
+      std::array<double,dim> dx;
+      std::array<double,dim> p_unit;
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          const unsigned int n_intervals = table_points[d] - 1;
+          double x_left;
+
+          if (coordinate_values_are_equidistant)
+            {
+              dx[d] = (grid_extent[d].second - grid_extent[d].first) / n_intervals;
+              if (position[d] <= grid_extent[d].first)
+                ix[d] = 0;
+              else if (position[d] >= grid_extent[d].second - dx[d])
+                ix[d] = n_intervals - 1;
+              else
+                ix[d] = static_cast<unsigned int>((position[d] - grid_extent[d].first) / dx[d]);
+              x_left = grid_extent[d].first + ix[d] * dx[d];
+            }
+          else
+            {
+              const std::vector<double> &x = coordinate_values[d];
+              if (position[d] <= x.front())
+                ix[d] = 0;
+              else if (position[d] >= x.back())
+                ix[d] = n_intervals - 1;
+              else
+                ix[d] = std::upper_bound(x.begin(), x.end(), position[d]) - x.begin() - 1;
+              dx[d] = x[ix[d]+1] - x[ix[d]];
+              x_left = x[ix[d]];
+            }
+
+          p_unit[d] = std::max(std::min((position[d] - x_left) / dx[d], 1.), 0.);
+        }
+
+      std::size_t n_points = 1;
+      for (unsigned int d=0; d<dim; ++d)
+        n_points *= table_points[d];
+      const double *values = shared_data + component * n_points;
+
+      // Sum up the contributions of the 2^dim corners of the box
+      double value = 0;
+      if (gradient != nullptr)
+        *gradient = Tensor<1,dim>();
+
+      for (unsigned int corner=0; corner<(1u<<dim); ++corner)
+        {
+          std::size_t index = 0;
+          std::size_t stride = 1;
+          std::array<double,dim> weights;
+          for (unsigned int d=0; d<dim; ++d)
+            {
+              const bool upper = (corner & (1u<<d)) != 0;
+              index += (ix[d] + (upper ? 1 : 0)) * stride;
+              stride *= table_points[d];
+              weights[d] = (upper ? p_unit[d] : 1. - p_unit[d]);
+            }
+
+          double weight = 1.;
+          for (unsigned int d=0; d<dim; ++d)
+            weight *= weights[d];
+          value += weight * values[index];
+
+          if (gradient != nullptr)
+            for (unsigned int d=0; d<dim; ++d)
+              {
+                double derivative = ((corner & (1u<<d)) != 0 ? 1. : -1.) / dx[d];
+                for (unsigned int e=0; e<dim; ++e)
+                  if (e != d)
+                    derivative *= weights[e];
+                (*gradient)[d] += derivative * values[index];
+              }
+        }
+
+      return value;
+    }
+
+
     template <int dim>
     double
     AsciiDataLookup<dim>::get_data(const Point<dim> &position,
                                    const unsigned int component) const
     {
       Assert(component<components, ExcMessage("Invalid component index"));
+      if (shared_data != nullptr)
+        return interpolate_shared_data(position, component, nullptr);
+
       return data[component]->value(position);
     }
 
@@ -2010,6 +2432,13 @@ namespace aspect
     AsciiDataLookup<dim>::get_gradients(const Point<dim> &position,
                                         const unsigned int component)
     {
+      if (shared_data != nullptr)
+        {
+          Tensor<1,dim> gradient;
+          interpolate_shared_data(position, component, &gradient);
+          return gradient;
+        }
+
       return data[component]->gradient(position,0);
     }
 
@@ -2032,6 +2461,8 @@ namespace aspect
 
     template <int dim>
     AsciiDataBase<dim>::AsciiDataBase ()
+      :
+      store_data_in_shared_memory (false)
     {}
 
 
@@ -2065,6 +2496,15 @@ namespace aspect
                            "reference model. Another way to use this factor is to "
                            "convert units of the input files. For instance, if you "
                            "provide velocities in cm/yr set this factor to 0.01.");
+        prm.declare_entry ("Store data in shared memory", "false",
+                           Patterns::Bool (),
+                           "Whether the data should only be read by one process per "
+                           "node and stored in memory that is shared by all processes "
+                           "on the same node, instead of every process storing a copy "
+                           "of the whole data file. This reduces the memory "
+                           "requirements considerably for large data files and many "
+                           "processes per node, but requires an MPI library that "
+                           "supports the MPI 3.0 standard.");
       }
       prm.leave_subsection();
     }
@@ -2083,6 +2523,7 @@ namespace aspect
         data_directory = Utilities::expand_ASPECT_SOURCE_DIR(prm.get ("Data directory"));
         data_file_name    = prm.get ("Data file name");
         scale_factor      = prm.get_double ("Scale factor");
+        store_data_in_shared_memory = prm.get_bool ("Store data in shared memory");
       }
       prm.leave_subsection();
     }
@@ -2152,7 +2593,7 @@ namespace aspect
                                   filename
                                   +
                                   "> not found!"));
-          lookups.find(boundary_id)->second->load_file(filename,this->get_mpi_communicator());
+          lookups.find(boundary_id)->second->load_file(filename,this->get_mpi_communicator(),this->store_data_in_shared_memory);
 
           // If the boundary condition is constant, switch off time_dependence
           // immediately. If not, also load the second file for interpolation.
@@ -2170,7 +2611,7 @@ namespace aspect
               if (Utilities::fexists(filename))
                 {
                   lookups.find(boundary_id)->second.swap(old_lookups.find(boundary_id)->second);
-                  lookups.find(boundary_id)->second->load_file(filename, this->get_mpi_communicator());
+                  lookups.find(boundary_id)->second->load_file(filename, this->get_mpi_communicator(), this->store_data_in_shared_memory);
                 }
               else
                 end_time_dependence ();
@@ -2375,7 +2816,7 @@ namespace aspect
           if (Utilities::fexists(filename))
             {
               lookups.find(boundary_id)->second.swap(old_lookups.find(boundary_id)->second);
-              lookups.find(boundary_id)->second->load_file(filename,this->get_mpi_communicator());
+              lookups.find(boundary_id)->second->load_file(filename,this->get_mpi_communicator(),this->store_data_in_shared_memory);
             }
 
           // If loading current_time_step failed, end time dependent part with old_file_number.
@@ -2396,7 +2837,7 @@ namespace aspect
       if (Utilities::fexists(filename))
         {
           lookups.find(boundary_id)->second.swap(old_lookups.find(boundary_id)->second);
-          lookups.find(boundary_id)->second->load_file(filename,this->get_mpi_communicator());
+          lookups.find(boundary_id)->second->load_file(filename,this->get_mpi_communicator(),this->store_data_in_shared_memory);
         }
 
       // If next file does not exist, end time dependent part with current_time_step.
@@ -2632,7 +3073,7 @@ namespace aspect
 
           lookups.push_back(std_cxx14::make_unique<Utilities::AsciiDataLookup<dim-1>> (components,
                                                                                        this->scale_factor));
-          lookups[i]->load_file(filename,this->get_mpi_communicator());
+          lookups[i]->load_file(filename,this->get_mpi_communicator(),this->store_data_in_shared_memory);
         }
     }
 
@@ -2802,7 +3243,7 @@ namespace aspect
                               filename
                               +
                               "> not found!"));
-      lookup->load_file(filename, this->get_mpi_communicator());
+      lookup->load_file(filename, this->get_mpi_communicator(), this->store_data_in_shared_memory);
     }
 
 
@@ -2849,7 +3290,7 @@ namespace aspect
                               filename
                               +
                               "> not found!"));
-      lookup->load_file(filename,communicator);
+      lookup->load_file(filename,communicator,this->store_data_in_shared_memory);
     }
 
 
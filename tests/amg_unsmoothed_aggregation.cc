@@ -0,0 +1,115 @@
+#include <aspect/simulator.h>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  /**
+   * Read all rows of a statistics file.
+   */
+  std::vector<std::vector<double> >
+  read_statistics_file (const std::string &filename)
+  {
+    std::ifstream in (filename.c_str());
+    std::vector<std::vector<double> > rows;
+
+    std::string line;
+    while (std::getline(in, line))
+      {
+        if (line.size() == 0 || line[0] == '#')
+          continue;
+
+        std::istringstream line_stream (line);
+        std::vector<double> row;
+        double value;
+        while (line_stream >> value)
+          row.push_back (value);
+        rows.push_back (row);
+      }
+
+    return rows;
+  }
+
+
+  /**
+   * Run the model of this test with or without unsmoothed aggregation and
+   * write its output into the given directory.
+   */
+  void
+  run_aspect (const std::string &output_directory,
+              const std::string &unsmoothed_aggregation)
+  {
+    const std::string command
+      = "cd output-amg_unsmoothed_aggregation ; "
+        "(cat " ASPECT_SOURCE_DIR "/tests/amg_unsmoothed_aggregation.prm "
+        " ; "
+        " echo 'set Output directory = " + output_directory + "' "
+        " ; "
+        " echo 'subsection Solver parameters' ; "
+        " echo 'subsection AMG parameters' ; "
+        " echo 'set AMG use unsmoothed aggregation = " + unsmoothed_aggregation + "' ; "
+        " echo 'end' ; echo 'end' "
+        " ; "
+        " rm -rf " + output_directory + " ; mkdir " + output_directory + " "
+        ") "
+        "| ../../aspect -- >/dev/null ";
+
+    const int ret = system (command.c_str());
+    if (ret!=0)
+      std::cout << "system() returned error " << ret << std::endl;
+  }
+}
+
+/*
+ * Launch the following function when this plugin is created. Launch ASPECT
+ * with smoothed and unsmoothed aggregation, compare the results and then
+ * terminate the outer ASPECT run.
+ */
+int f()
+{
+  std::cout << "* running with smoothed aggregation:" << std::endl;
+  run_aspect ("output1.tmp", "false");
+
+  std::cout << "* running with unsmoothed aggregation:" << std::endl;
+  run_aspect ("output2.tmp", "true");
+
+  std::cout << "* now comparing:" << std::endl;
+
+  const std::vector<std::vector<double> > smoothed
+    = read_statistics_file ("output-amg_unsmoothed_aggregation/output1.tmp/statistics");
+  const std::vector<std::vector<double> > unsmoothed
+    = read_statistics_file ("output-amg_unsmoothed_aggregation/output2.tmp/statistics");
+
+  // column 8 is the number of Stokes solver iterations, columns 11 and 12
+  // the RMS and maximum velocity
+  const bool complete = (smoothed.size() == 1 && unsmoothed.size() == 1
+                         && smoothed[0].size() >= 12 && unsmoothed[0].size() >= 12);
+
+  bool same_velocity = complete;
+  for (unsigned int j=10; same_velocity && j<12; ++j)
+    if (std::fabs(unsmoothed[0][j] - smoothed[0][j]) > 1e-4 * std::fabs(smoothed[0][j]))
+      same_velocity = false;
+  std::cout << "Same velocity with smoothed and unsmoothed aggregation: "
+            << (same_velocity ? "yes" : "no") << std::endl;
+
+  // Unsmoothed aggregation gives a weaker preconditioner, but the number of
+  // iterations should not grow by more than a small factor
+  const bool few_iterations = (complete
+                               && smoothed[0][7] > 0
+                               && unsmoothed[0][7] <= 3 * smoothed[0][7]);
+  std::cout << "At most three times as many Stokes iterations with unsmoothed aggregation: "
+            << (few_iterations ? "yes" : "no") << std::endl;
+
+  // terminate current process:
+  exit (0);
+  return 42;
+}
+
+
+// run this function by initializing a global variable by it
+int i = f();
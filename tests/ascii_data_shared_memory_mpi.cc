@@ -0,0 +1,115 @@
+#include <aspect/simulator.h>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  /**
+   * Read all rows of a statistics file.
+   */
+  std::vector<std::vector<double> >
+  read_statistics_file (const std::string &filename)
+  {
+    std::ifstream in (filename.c_str());
+    std::vector<std::vector<double> > rows;
+
+    std::string line;
+    while (std::getline(in, line))
+      {
+        if (line.size() == 0 || line[0] == '#')
+          continue;
+
+        std::istringstream line_stream (line);
+        std::vector<double> row;
+        double value;
+        while (line_stream >> value)
+          row.push_back (value);
+        rows.push_back (row);
+      }
+
+    return rows;
+  }
+
+
+  /**
+   * Run the model of this test on two processes with or without storing
+   * the ascii data in shared memory and write its output into the given
+   * directory.
+   */
+  void
+  run_aspect (const std::string &output_directory,
+              const std::string &shared_memory)
+  {
+    const std::string command
+      = "cd output-ascii_data_shared_memory_mpi ; "
+        "(cat " ASPECT_SOURCE_DIR "/tests/ascii_data_shared_memory_mpi.prm "
+        " ; "
+        " echo 'set Output directory = " + output_directory + "' "
+        " ; "
+        " echo 'subsection Initial composition model' ; "
+        " echo 'subsection Ascii data model' ; "
+        " echo 'set Store data in shared memory = " + shared_memory + "' ; "
+        " echo 'end' ; echo 'end' "
+        " ; "
+        " rm -rf " + output_directory + " ; mkdir " + output_directory + " "
+        ") "
+        "| mpirun -np 2 ../../aspect -- > /dev/null";
+
+    const int ret = system (command.c_str());
+    if (ret!=0)
+      std::cout << "system() returned error " << ret << std::endl;
+  }
+}
+
+/*
+ * Launch the following function when this plugin is created. Launch ASPECT
+ * in parallel with and without shared memory, compare the results and then
+ * terminate the outer ASPECT run.
+ */
+int f()
+{
+  if (dealii::Utilities::MPI::this_mpi_process (MPI_COMM_WORLD) != 0)
+    return 0;
+
+  std::cout << "* running without shared memory:" << std::endl;
+  run_aspect ("output1.tmp", "false");
+
+  std::cout << "* running with shared memory:" << std::endl;
+  run_aspect ("output2.tmp", "true");
+
+  std::cout << "* now comparing:" << std::endl;
+
+  const std::vector<std::vector<double> > reference
+    = read_statistics_file ("output-ascii_data_shared_memory_mpi/output1.tmp/statistics");
+  const std::vector<std::vector<double> > shared
+    = read_statistics_file ("output-ascii_data_shared_memory_mpi/output2.tmp/statistics");
+
+  // the statistics contain the minimum, maximum and mass of the
+  // compositional field that is initialized from the data file
+  bool same_statistics = (shared.size() == reference.size() && shared.size() > 0);
+  for (unsigned int i=0; same_statistics && i<shared.size(); ++i)
+    {
+      if (shared[i].size() != reference[i].size())
+        same_statistics = false;
+      else
+        for (unsigned int j=0; j<shared[i].size(); ++j)
+          if (std::fabs(shared[i][j] - reference[i][j])
+              > 1e-8 * std::max(1., std::fabs(reference[i][j])))
+            same_statistics = false;
+    }
+  std::cout << "Same statistics with and without shared memory: "
+            << (same_statistics ? "yes" : "no") << std::endl;
+
+  // terminate current process:
+  exit (0);
+  return 42;
+}
+
+
+// run this function by initializing a global variable by it
+int i = f();
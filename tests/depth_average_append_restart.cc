@@ -0,0 +1,121 @@
+#include <aspect/simulator.h>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  /**
+   * Read a depth_average.txt file. Return the number of header lines and
+   * the list of distinct output times in the order in which they appear.
+   */
+  std::pair<unsigned int, std::vector<double> >
+  read_depth_average_file (const std::string &filename)
+  {
+    std::ifstream in (filename.c_str());
+    unsigned int n_header_lines = 0;
+    std::vector<double> times;
+
+    std::string line;
+    while (std::getline(in, line))
+      {
+        if (line.size() > 0 && line[0] == '#')
+          {
+            ++n_header_lines;
+            continue;
+          }
+
+        std::istringstream line_stream (line);
+        double time;
+        if (line_stream >> time)
+          if (times.size() == 0 || times.back() != time)
+            times.push_back (time);
+      }
+
+    return std::make_pair (n_header_lines, times);
+  }
+}
+
+/*
+ * Launch the following function when this plugin is created. Launch ASPECT
+ * twice to test checkpoint/resume and then terminate the outer ASPECT run.
+ */
+int f()
+{
+  std::cout << "* starting from beginning:" << std::endl;
+
+  // call ASPECT with "--" and pipe an existing input file into it.
+  int ret;
+
+  ret = system ("cd output-depth_average_append_restart ; "
+                "(cat " ASPECT_SOURCE_DIR "/tests/depth_average_append_restart.prm "
+                " ; "
+                " echo 'set Output directory = output1.tmp' "
+                " ; "
+                " rm -rf output1.tmp ; mkdir output1.tmp "
+                ") "
+                "| ../../aspect -- >/dev/null ");
+
+  if (ret!=0)
+    std::cout << "system() returned error " << ret << std::endl;
+
+  // keep the output of the uninterrupted run, and restore the first
+  // checkpoint. depth_average.txt is not restored, so it still contains
+  // the output of all times.
+  ret = system ("cd output-depth_average_append_restart ; "
+                " rm -rf output2.tmp ; cp -r output1.tmp output2.tmp ;"
+                " for f in output1.tmp/restart.*.old ; do cp $f ${f%.old} ; done");
+  if (ret!=0)
+    std::cout << "system() returned error " << ret << std::endl;
+
+
+  std::cout << "* now resuming:" << std::endl;
+  ret = system ("cd output-depth_average_append_restart ; "
+                "(cat " ASPECT_SOURCE_DIR "/tests/depth_average_append_restart.prm "
+                " ; "
+                " echo 'set Output directory = output1.tmp' "
+                " ; "
+                " echo 'set Resume computation = true' "
+                ") "
+                "| ../../aspect -- >/dev/null");
+  if (ret!=0)
+    std::cout << "system() returned error " << ret << std::endl;
+
+  std::cout << "* now comparing:" << std::endl;
+
+  const std::pair<unsigned int, std::vector<double> > resumed
+    = read_depth_average_file ("output-depth_average_append_restart/output1.tmp/depth_average.txt");
+  const std::pair<unsigned int, std::vector<double> > uninterrupted
+    = read_depth_average_file ("output-depth_average_append_restart/output2.tmp/depth_average.txt");
+
+  std::cout << "Header lines after resuming: " << resumed.first << std::endl;
+
+  bool increasing = true;
+  for (unsigned int i=1; i<resumed.second.size(); ++i)
+    if (resumed.second[i] <= resumed.second[i-1])
+      increasing = false;
+  std::cout << "Output times strictly increasing after resuming: "
+            << (increasing ? "yes" : "no") << std::endl;
+
+  bool same_times = (resumed.second.size() == uninterrupted.second.size()
+                     && resumed.second.size() > 0);
+  if (same_times)
+    for (unsigned int i=0; i<resumed.second.size(); ++i)
+      if (std::fabs(resumed.second[i] - uninterrupted.second[i])
+          > 1e-6 * std::fabs(uninterrupted.second[i]))
+        same_times = false;
+  std::cout << "Same output times as the uninterrupted run: "
+            << (same_times ? "yes" : "no") << std::endl;
+
+  // terminate current process:
+  exit (0);
+  return 42;
+}
+
+
+// run this function by initializing a global variable by it
+int i = f();
@@ -0,0 +1,124 @@
+#include <aspect/simulator.h>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  /**
+   * Read all rows of a statistics file.
+   */
+  std::vector<std::vector<double> >
+  read_statistics_file (const std::string &filename)
+  {
+    std::ifstream in (filename.c_str());
+    std::vector<std::vector<double> > rows;
+
+    std::string line;
+    while (std::getline(in, line))
+      {
+        if (line.size() == 0 || line[0] == '#')
+          continue;
+
+        std::istringstream line_stream (line);
+        std::vector<double> row;
+        double value;
+        while (line_stream >> value)
+          row.push_back (value);
+        rows.push_back (row);
+      }
+
+    return rows;
+  }
+
+
+  /**
+   * Run the model of this test with the given grain size evolution time
+   * stepping scheme and write its output into the given directory.
+   */
+  void
+  run_aspect (const std::string &output_directory,
+              const std::string &time_stepping)
+  {
+    const std::string command
+      = "cd output-grain_size_growth_adaptive ; "
+        "(cat " ASPECT_SOURCE_DIR "/tests/grain_size_growth_adaptive.prm "
+        " ; "
+        " echo 'set Output directory = " + output_directory + "' "
+        " ; "
+        " echo 'subsection Material model' ; "
+        " echo 'subsection Grain size model' ; "
+        " echo 'set Grain size evolution time stepping = " + time_stepping + "' ; "
+        " echo 'end' ; echo 'end' "
+        " ; "
+        " rm -rf " + output_directory + " ; mkdir " + output_directory + " "
+        ") "
+        "| ../../aspect -- >/dev/null ";
+
+    const int ret = system (command.c_str());
+    if (ret!=0)
+      std::cout << "system() returned error " << ret << std::endl;
+  }
+}
+
+/*
+ * Launch the following function when this plugin is created. Launch ASPECT
+ * with both grain size evolution schemes, compare the results and then
+ * terminate the outer ASPECT run.
+ */
+int f()
+{
+  std::cout << "* running with step doubling:" << std::endl;
+  run_aspect ("output1.tmp", "step doubling");
+
+  std::cout << "* running with adaptive time stepping:" << std::endl;
+  run_aspect ("output2.tmp", "adaptive");
+
+  std::cout << "* now comparing:" << std::endl;
+
+  const std::vector<std::vector<double> > step_doubling
+    = read_statistics_file ("output-grain_size_growth_adaptive/output1.tmp/statistics");
+  const std::vector<std::vector<double> > adaptive
+    = read_statistics_file ("output-grain_size_growth_adaptive/output2.tmp/statistics");
+
+  // columns 13-15 are the minimum, maximum and mass of the grain size.
+  // The relative tolerance of the adaptive scheme is 1e-3 by default.
+  bool same_grain_size = (adaptive.size() == step_doubling.size() && adaptive.size() > 1);
+  for (unsigned int i=0; same_grain_size && i<adaptive.size(); ++i)
+    {
+      if (adaptive[i].size() < 15 || step_doubling[i].size() < 15)
+        same_grain_size = false;
+      else
+        for (unsigned int j=12; j<15; ++j)
+          if (std::fabs(adaptive[i][j] - step_doubling[i][j]) > 1e-3 * std::fabs(step_doubling[i][j]))
+            same_grain_size = false;
+    }
+  std::cout << "Grain size statistics within the relative tolerance: "
+            << (same_grain_size ? "yes" : "no") << std::endl;
+
+  // The grain size only grows by about one percent in this model, so
+  // also compare the growth of the maximum grain size since the start
+  bool same_growth = same_grain_size;
+  if (same_growth)
+    {
+      const double initial_grain_size = step_doubling[0][13];
+      const double step_doubling_growth = step_doubling.back()[13] - initial_grain_size;
+      const double adaptive_growth = adaptive.back()[13] - initial_grain_size;
+      same_growth = (step_doubling_growth > 0
+                     && std::fabs(adaptive_growth - step_doubling_growth) <= 1e-2 * step_doubling_growth);
+    }
+  std::cout << "Growth of the maximum grain size within one percent: "
+            << (same_growth ? "yes" : "no") << std::endl;
+
+  // terminate current process:
+  exit (0);
+  return 42;
+}
+
+
+// run this function by initializing a global variable by it
+int i = f();
@@ -0,0 +1,146 @@
+#include <aspect/simulator.h>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  /**
+   * Read the gravity vector (columns 7-9) and the gravity potential
+   * (column 12) of every satellite from a gravity output file.
+   */
+  std::vector<std::vector<double> >
+  read_gravity_file (const std::string &filename)
+  {
+    std::ifstream in (filename.c_str());
+    std::vector<std::vector<double> > values;
+
+    std::string line;
+    while (std::getline(in, line))
+      {
+        if (line.size() == 0 || line[0] == '#')
+          continue;
+
+        std::istringstream line_stream (line);
+        std::vector<double> columns;
+        double value;
+        while (line_stream >> value)
+          columns.push_back (value);
+
+        if (columns.size() >= 12)
+          values.push_back (std::vector<double> {columns[6], columns[7], columns[8], columns[11]});
+      }
+
+    return values;
+  }
+
+
+  /**
+   * Return whether the gravity vectors and potentials in the two files
+   * agree up to the given relative tolerance.
+   */
+  bool
+  compare_gravity_files (const std::string &filename,
+                         const std::string &reference_filename,
+                         const double tolerance)
+  {
+    const std::vector<std::vector<double> > values = read_gravity_file (filename);
+    const std::vector<std::vector<double> > reference = read_gravity_file (reference_filename);
+
+    if (values.size() != reference.size() || values.size() == 0)
+      return false;
+
+    for (unsigned int i=0; i<values.size(); ++i)
+      {
+        double difference = 0, norm = 0;
+        for (unsigned int d=0; d<3; ++d)
+          {
+            difference += std::pow(values[i][d] - reference[i][d], 2);
+            norm += std::pow(reference[i][d], 2);
+          }
+        if (std::sqrt(difference) > tolerance * std::sqrt(norm))
+          return false;
+
+        if (std::fabs(values[i][3] - reference[i][3]) > tolerance * std::fabs(reference[i][3]))
+          return false;
+      }
+
+    return true;
+  }
+
+
+  /**
+   * Run the model of this test with the given gravity evaluation
+   * settings and write its output into the given directory.
+   */
+  void
+  run_aspect (const std::string &output_directory,
+              const std::string &evaluation_method,
+              const std::string &tree_opening_angle)
+  {
+    const std::string command
+      = "cd output-gravity_tree ; "
+        "(cat " ASPECT_SOURCE_DIR "/tests/gravity_tree.prm "
+        " ; "
+        " echo 'set Output directory = " + output_directory + "' "
+        " ; "
+        " echo 'subsection Postprocess' ; "
+        " echo 'subsection Gravity calculation' ; "
+        " echo 'set Evaluation method = " + evaluation_method + "' ; "
+        " echo 'set Tree opening angle = " + tree_opening_angle + "' ; "
+        " echo 'end' ; echo 'end' "
+        " ; "
+        " rm -rf " + output_directory + " ; mkdir " + output_directory + " "
+        ") "
+        "| ../../aspect -- >/dev/null ";
+
+    const int ret = system (command.c_str());
+    if (ret!=0)
+      std::cout << "system() returned error " << ret << std::endl;
+  }
+}
+
+/*
+ * Launch the following function when this plugin is created. Launch ASPECT
+ * with the direct and the tree evaluation method, compare the results and
+ * then terminate the outer ASPECT run.
+ */
+int f()
+{
+  std::cout << "* running with the direct method:" << std::endl;
+  run_aspect ("output1.tmp", "direct", "0.3");
+
+  std::cout << "* running with the tree method:" << std::endl;
+  run_aspect ("output2.tmp", "tree", "0.3");
+  run_aspect ("output3.tmp", "tree", "0");
+
+  std::cout << "* now comparing:" << std::endl;
+
+  // the error of the tree method decreases with the square of the
+  // opening angle, and an opening angle of zero is equivalent to the
+  // direct method up to round-off
+  std::cout << "Tree method with opening angle 0.3 within 0.09 of the direct method: "
+            << (compare_gravity_files ("output-gravity_tree/output2.tmp/output_gravity/gravity-00000",
+                                       "output-gravity_tree/output1.tmp/output_gravity/gravity-00000",
+                                       0.3*0.3)
+                ? "yes" : "no")
+            << std::endl;
+  std::cout << "Tree method with opening angle 0 equal to the direct method: "
+            << (compare_gravity_files ("output-gravity_tree/output3.tmp/output_gravity/gravity-00000",
+                                       "output-gravity_tree/output1.tmp/output_gravity/gravity-00000",
+                                       1e-10)
+                ? "yes" : "no")
+            << std::endl;
+
+  // terminate current process:
+  exit (0);
+  return 42;
+}
+
+
+// run this function by initializing a global variable by it
+int i = f();
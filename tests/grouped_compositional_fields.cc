@@ -0,0 +1,139 @@
+#include <aspect/simulator.h>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  /**
+   * Read all rows of a statistics file.
+   */
+  std::vector<std::vector<double> >
+  read_statistics_file (const std::string &filename)
+  {
+    std::ifstream in (filename.c_str());
+    std::vector<std::vector<double> > rows;
+
+    std::string line;
+    while (std::getline(in, line))
+      {
+        if (line.size() == 0 || line[0] == '#')
+          continue;
+
+        std::istringstream line_stream (line);
+        std::vector<double> row;
+        double value;
+        while (line_stream >> value)
+          row.push_back (value);
+        rows.push_back (row);
+      }
+
+    return rows;
+  }
+
+
+  /**
+   * Return whether two numbers agree up to a relative tolerance, using
+   * an absolute tolerance for values close to zero.
+   */
+  bool
+  close (const double a,
+         const double b)
+  {
+    return std::fabs(a - b) <= 1e-8 * std::max(1., std::max(std::fabs(a), std::fabs(b)));
+  }
+
+
+  /**
+   * Run the model of this test with or without grouping of compositional
+   * fields and write its output into the given directory.
+   */
+  void
+  run_aspect (const std::string &output_directory,
+              const std::string &group_fields)
+  {
+    const std::string command
+      = "cd output-grouped_compositional_fields ; "
+        "(cat " ASPECT_SOURCE_DIR "/tests/grouped_compositional_fields.prm "
+        " ; "
+        " echo 'set Output directory = " + output_directory + "' "
+        " ; "
+        " echo 'subsection Solver parameters' ; "
+        " echo 'subsection Advection solver parameters' ; "
+        " echo 'set Group compatible compositional fields = " + group_fields + "' ; "
+        " echo 'end' ; echo 'end' "
+        " ; "
+        " rm -rf " + output_directory + " ; mkdir " + output_directory + " "
+        ") "
+        "| ../../aspect -- >/dev/null ";
+
+    const int ret = system (command.c_str());
+    if (ret!=0)
+      std::cout << "system() returned error " << ret << std::endl;
+  }
+}
+
+/*
+ * Launch the following function when this plugin is created. Launch ASPECT
+ * with and without grouping of compositional fields, compare the results
+ * and then terminate the outer ASPECT run.
+ */
+int f()
+{
+  std::cout << "* running without grouping:" << std::endl;
+  run_aspect ("output1.tmp", "false");
+
+  std::cout << "* running with grouping:" << std::endl;
+  run_aspect ("output2.tmp", "true");
+
+  std::cout << "* now comparing:" << std::endl;
+
+  const std::vector<std::vector<double> > ungrouped
+    = read_statistics_file ("output-grouped_compositional_fields/output1.tmp/statistics");
+  const std::vector<std::vector<double> > grouped
+    = read_statistics_file ("output-grouped_compositional_fields/output2.tmp/statistics");
+
+  // the statistics contain the solver iterations and the minimum, maximum
+  // and mass of both fields in every time step
+  bool same_statistics = (grouped.size() == ungrouped.size() && grouped.size() > 1);
+  for (unsigned int i=0; same_statistics && i<grouped.size(); ++i)
+    {
+      if (grouped[i].size() != ungrouped[i].size())
+        same_statistics = false;
+      else
+        for (unsigned int j=0; j<grouped[i].size(); ++j)
+          if (!close (grouped[i][j], ungrouped[i][j]))
+            same_statistics = false;
+    }
+  std::cout << "Same statistics with and without grouping: "
+            << (same_statistics ? "yes" : "no") << std::endl;
+
+  // columns 9 and 10 are the iterations of the two composition solvers,
+  // columns 18-20 and 21-23 the statistics of the two fields
+  bool identical_fields = (grouped.size() > 1);
+  for (unsigned int i=0; identical_fields && i<grouped.size(); ++i)
+    {
+      if (grouped[i].size() < 23)
+        identical_fields = false;
+      else if (!close (grouped[i][8], grouped[i][9]))
+        identical_fields = false;
+      else
+        for (unsigned int j=17; j<20; ++j)
+          if (!close (grouped[i][j], grouped[i][j+3]))
+            identical_fields = false;
+    }
+  std::cout << "Both fields identical with grouping: "
+            << (identical_fields ? "yes" : "no") << std::endl;
+
+  // terminate current process:
+  exit (0);
+  return 42;
+}
+
+
+// run this function by initializing a global variable by it
+int i = f();
@@ -0,0 +1,16 @@
+#!/usr/bin/env perl
+
+# Only compare the material statistics, which must be the same as in the
+# material_statistics test.
+$filename=$ARGV[0];
+while(<STDIN>)
+{
+    if ($filename eq "screen-output")
+    {
+	print $_ if (/Average density \/ Average viscosity \/ Total mass/);
+    }
+    else
+    {
+	print $_;
+    }
+}
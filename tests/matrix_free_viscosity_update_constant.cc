@@ -0,0 +1 @@
+#include "compressibility.cc"
@@ -0,0 +1,17 @@
+#!/usr/bin/env perl
+
+# Only compare the velocities, which must be the same as in the
+# periodic_box test. The number of Stokes iterations differs because
+# of the different preconditioner.
+$filename=$ARGV[0];
+while(<STDIN>)
+{
+    if ($filename eq "screen-output")
+    {
+	print $_ if (/RMS, max velocity/);
+    }
+    else
+    {
+	print $_;
+    }
+}
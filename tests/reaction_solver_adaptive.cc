@@ -0,0 +1,193 @@
+#include "../benchmarks/operator_splitting/exponential_decay/exponential_decay.cc"
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  /**
+   * Read the columns with the given names from a statistics file.
+   */
+  std::vector<std::vector<double> >
+  read_statistics_columns (const std::string &filename,
+                           const std::vector<std::string> &column_names)
+  {
+    std::ifstream in (filename.c_str());
+    std::vector<unsigned int> column_indices (column_names.size(), dealii::numbers::invalid_unsigned_int);
+    std::vector<std::vector<double> > rows;
+
+    std::string line;
+    while (std::getline(in, line))
+      {
+        if (line.size() == 0)
+          continue;
+
+        // header lines have the form '# <column>: <name>'
+        if (line[0] == '#')
+          {
+            const std::string::size_type colon = line.find(':');
+            if (colon != std::string::npos)
+              for (unsigned int i=0; i<column_names.size(); ++i)
+                if (line.substr(colon+2) == column_names[i])
+                  column_indices[i] = std::stoi(line.substr(1, colon-1)) - 1;
+            continue;
+          }
+
+        std::istringstream line_stream (line);
+        std::vector<double> columns;
+        double value;
+        while (line_stream >> value)
+          columns.push_back (value);
+
+        std::vector<double> row;
+        for (const unsigned int index : column_indices)
+          if (index < columns.size())
+            row.push_back (columns[index]);
+        if (row.size() == column_names.size())
+          rows.push_back (row);
+      }
+
+    return rows;
+  }
+
+
+  /**
+   * Return the total number of reaction steps of a model run, as reported
+   * in its log file.
+   */
+  unsigned int
+  count_reaction_steps (const std::string &filename)
+  {
+    std::ifstream in (filename.c_str());
+    unsigned int n_steps = 0;
+
+    std::string line;
+    while (std::getline(in, line))
+      if (line.find("Solving composition reactions...") != std::string::npos)
+        {
+          const std::string::size_type end = line.find(" substep(s)");
+          const std::string::size_type begin = line.rfind(' ', end-1);
+          if (end != std::string::npos && begin != std::string::npos)
+            n_steps += std::stoi(line.substr(begin+1, end-begin-1));
+        }
+
+    return n_steps;
+  }
+
+
+  /**
+   * Run the model of this test with the given reaction solver and write
+   * its output into the given directory. The inner runs load the plugins
+   * of this test from the same library, so tell them not to start the
+   * test again.
+   */
+  void
+  run_aspect (const std::string &output_directory,
+              const std::string &reaction_solver_type)
+  {
+    const std::string command
+      = "cd output-reaction_solver_adaptive ; "
+        "(cat " ASPECT_SOURCE_DIR "/tests/reaction_solver_adaptive.prm "
+        " ; "
+        " echo 'set Additional shared libraries = ../libreaction_solver_adaptive.so' "
+        " ; "
+        " echo 'set Output directory = " + output_directory + "' "
+        " ; "
+        " echo 'subsection Solver parameters' ; "
+        " echo 'subsection Operator splitting parameters' ; "
+        " echo 'set Reaction solver type = " + reaction_solver_type + "' ; "
+        " echo 'end' ; echo 'end' "
+        " ; "
+        " rm -rf " + output_directory + " ; mkdir " + output_directory + " "
+        ") "
+        "| ASPECT_TEST_INNER_RUN=1 ../../aspect -- >/dev/null ";
+
+    const int ret = system (command.c_str());
+    if (ret!=0)
+      std::cout << "system() returned error " << ret << std::endl;
+  }
+
+
+  /**
+   * Return whether the compositional field of a model run agrees with the
+   * analytical solution for exponential decay with a half life of 10 up
+   * to the given tolerance in all time steps. The domain has an area of 1,
+   * so the mass of the field is equal to its value.
+   */
+  bool
+  matches_analytical_solution (const std::vector<std::vector<double> > &rows,
+                               const double tolerance)
+  {
+    if (rows.size() < 2)
+      return false;
+
+    for (const auto &row : rows)
+      if (std::fabs(row[1] - std::exp(-std::log(2.) * row[0] / 10.)) > tolerance)
+        return false;
+
+    return true;
+  }
+}
+
+/*
+ * Launch the following function when this plugin is created. Launch ASPECT
+ * with the fixed step and the adaptive reaction solver, compare the results
+ * and then terminate the outer ASPECT run.
+ */
+int f()
+{
+  if (std::getenv("ASPECT_TEST_INNER_RUN") != nullptr)
+    return 0;
+
+  std::cout << "* running with the fixed step solver:" << std::endl;
+  run_aspect ("output1.tmp", "fixed step");
+
+  std::cout << "* running with the adaptive solver:" << std::endl;
+  run_aspect ("output2.tmp", "adaptive");
+
+  std::cout << "* now comparing:" << std::endl;
+
+  const std::vector<std::string> columns = {"Time (seconds)", "Global mass for composition C_1"};
+  const std::vector<std::vector<double> > fixed_step
+    = read_statistics_columns ("output-reaction_solver_adaptive/output1.tmp/statistics", columns);
+  const std::vector<std::vector<double> > adaptive
+    = read_statistics_columns ("output-reaction_solver_adaptive/output2.tmp/statistics", columns);
+
+  std::cout << "Fixed step solver within 1e-3 of the analytical solution: "
+            << (matches_analytical_solution (fixed_step, 1e-3) ? "yes" : "no")
+            << std::endl;
+  std::cout << "Adaptive solver within 1e-3 of the analytical solution: "
+            << (matches_analytical_solution (adaptive, 1e-3) ? "yes" : "no")
+            << std::endl;
+
+  bool same_solution = (adaptive.size() == fixed_step.size() && adaptive.size() > 1);
+  for (unsigned int i=0; same_solution && i<adaptive.size(); ++i)
+    if (adaptive[i][0] != fixed_step[i][0]
+        || std::fabs(adaptive[i][1] - fixed_step[i][1]) > 1e-3)
+      same_solution = false;
+  std::cout << "Adaptive solver within 1e-3 of the fixed step solver: "
+            << (same_solution ? "yes" : "no")
+            << std::endl;
+
+  const unsigned int fixed_step_reaction_steps
+    = count_reaction_steps ("output-reaction_solver_adaptive/output1.tmp/log.txt");
+  const unsigned int adaptive_reaction_steps
+    = count_reaction_steps ("output-reaction_solver_adaptive/output2.tmp/log.txt");
+  std::cout << "Adaptive solver needs fewer reaction steps: "
+            << (adaptive_reaction_steps > 0 && adaptive_reaction_steps < fixed_step_reaction_steps
+                ? "yes" : "no")
+            << std::endl;
+
+  // terminate current process:
+  exit (0);
+  return 42;
+}
+
+
+// run this function by initializing a global variable by it
+int i = f();
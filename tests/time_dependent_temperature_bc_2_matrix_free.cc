@@ -0,0 +1 @@
+#include "time_dependent_temperature_bc_2.cc"
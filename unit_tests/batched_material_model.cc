@@ -0,0 +1,144 @@
+/*
+  Copyright (C) 2026 by the authors of the ASPECT code.
+
+  This file is part of ASPECT.
+
+  ASPECT is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2, or (at your option)
+  any later version.
+
+  ASPECT is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with ASPECT; see the file LICENSE.  If not see
+  <http://www.gnu.org/licenses/>.
+*/
+
+#include "common.h"
+#include <aspect/material_model/interface.h>
+
+// Tests for the functions used to evaluate the material model for several
+// sets of inputs at once: concatenating MaterialModelInputs objects, and
+// copying a range of points out of the concatenated MaterialModelOutputs.
+
+namespace
+{
+  using namespace dealii;
+  using namespace aspect::MaterialModel;
+
+  template <int dim>
+  void fill_inputs (MaterialModelInputs<dim> &in,
+                    const double offset)
+  {
+    for (unsigned int q=0; q<in.n_evaluation_points(); ++q)
+      {
+        in.position[q] = Point<dim>();
+        in.position[q][0] = offset + q;
+        in.temperature[q] = offset + q + 0.1;
+        in.pressure[q] = offset + q + 0.2;
+        in.pressure_gradient[q] = Tensor<1,dim>();
+        in.velocity[q] = Tensor<1,dim>();
+        in.velocity[q][1] = offset + q + 0.3;
+        for (unsigned int c=0; c<in.composition[q].size(); ++c)
+          in.composition[q][c] = offset + q + 0.4 + c;
+        in.strain_rate[q] = SymmetricTensor<2,dim>();
+        in.strain_rate[q][0][0] = offset + q + 0.5;
+      }
+  }
+}
+
+
+TEST_CASE("MaterialModelInputs concatenation")
+{
+  const int dim=2;
+
+  MaterialModelInputs<dim> in1(2,2);
+  MaterialModelInputs<dim> in2(3,2);
+  fill_inputs(in1, 0.);
+  fill_inputs(in2, 10.);
+  in1.requested_properties = MaterialProperties::viscosity;
+  in2.requested_properties = MaterialProperties::density;
+
+  const std::vector<const MaterialModelInputs<dim> *> inputs = {&in1, &in2};
+  const MaterialModelInputs<dim> in(inputs);
+
+  REQUIRE(in.n_evaluation_points() == 5);
+  REQUIRE(in.requested_properties == (MaterialProperties::viscosity | MaterialProperties::density));
+  REQUIRE(in.current_cell.state() != IteratorState::valid);
+
+  for (unsigned int q=0; q<5; ++q)
+    {
+      const MaterialModelInputs<dim> &source = (q < 2 ? in1 : in2);
+      const unsigned int source_q = (q < 2 ? q : q-2);
+
+      INFO("point " << q);
+      REQUIRE(in.position[q] == source.position[source_q]);
+      REQUIRE(in.temperature[q] == source.temperature[source_q]);
+      REQUIRE(in.pressure[q] == source.pressure[source_q]);
+      REQUIRE(in.velocity[q] == source.velocity[source_q]);
+      REQUIRE(in.composition[q] == source.composition[source_q]);
+      REQUIRE(in.strain_rate[q] == source.strain_rate[source_q]);
+    }
+}
+
+
+TEST_CASE("MaterialModelInputs concatenation without strain rate")
+{
+  const int dim=2;
+
+  MaterialModelInputs<dim> in1(2,1);
+  MaterialModelInputs<dim> in2(1,1);
+  fill_inputs(in1, 0.);
+  fill_inputs(in2, 10.);
+  in1.strain_rate.resize(0);
+  in2.strain_rate.resize(0);
+
+  const std::vector<const MaterialModelInputs<dim> *> inputs = {&in1, &in2};
+  const MaterialModelInputs<dim> in(inputs);
+
+  REQUIRE(in.n_evaluation_points() == 3);
+  REQUIRE(in.strain_rate.size() == 0);
+  REQUIRE(in.temperature[2] == in2.temperature[0]);
+}
+
+
+TEST_CASE("MaterialModelOutputs copy_points_from")
+{
+  const int dim=2;
+
+  MaterialModelOutputs<dim> source(5,2);
+  for (unsigned int q=0; q<5; ++q)
+    {
+      source.viscosities[q] = 1. + q;
+      source.densities[q] = 2. + q;
+      source.thermal_expansion_coefficients[q] = 3. + q;
+      source.specific_heat[q] = 4. + q;
+      source.thermal_conductivities[q] = 5. + q;
+      source.compressibilities[q] = 6. + q;
+      source.entropy_derivative_pressure[q] = 7. + q;
+      source.entropy_derivative_temperature[q] = 8. + q;
+      source.reaction_terms[q][0] = 9. + q;
+      source.reaction_terms[q][1] = 10. + q;
+    }
+
+  MaterialModelOutputs<dim> out(3,2);
+  out.copy_points_from(source, 2);
+
+  for (unsigned int q=0; q<3; ++q)
+    {
+      INFO("point " << q);
+      REQUIRE(out.viscosities[q] == source.viscosities[q+2]);
+      REQUIRE(out.densities[q] == source.densities[q+2]);
+      REQUIRE(out.thermal_expansion_coefficients[q] == source.thermal_expansion_coefficients[q+2]);
+      REQUIRE(out.specific_heat[q] == source.specific_heat[q+2]);
+      REQUIRE(out.thermal_conductivities[q] == source.thermal_conductivities[q+2]);
+      REQUIRE(out.compressibilities[q] == source.compressibilities[q+2]);
+      REQUIRE(out.entropy_derivative_pressure[q] == source.entropy_derivative_pressure[q+2]);
+      REQUIRE(out.entropy_derivative_temperature[q] == source.entropy_derivative_temperature[q+2]);
+      REQUIRE(out.reaction_terms[q] == source.reaction_terms[q+2]);
+    }
+}
@@ -20,7 +20,11 @@
 
 #include "common.h"
 #include <aspect/particle/property/interface.h>
+#include <aspect/particle/tensor_product_evaluator.h>
 #include <deal.II/base/parameter_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_dgp.h>
 
 TEST_CASE("Particle Manager plugin names")
 {
@@ -52,3 +56,62 @@ TEST_CASE("Particle Manager plugin names")
   REQUIRE(manager.get_plugin_index_by_name("composition") == 0);
   REQUIRE(manager.get_plugin_index_by_name("position") == 1);
 }
+
+
+namespace
+{
+  // Compare the values and gradients computed by the TensorProductEvaluator
+  // with the ones computed from the shape functions of the element.
+  template <int dim>
+  void check_tensor_product_evaluator(const dealii::FiniteElement<dim> &fe)
+  {
+    REQUIRE(aspect::Particle::internal::TensorProductEvaluator<dim>::is_supported(fe) == true);
+    const aspect::Particle::internal::TensorProductEvaluator<dim> evaluator(fe);
+
+    const unsigned int n_components = 2;
+    std::vector<double> dof_values(n_components * fe.dofs_per_cell);
+    for (unsigned int i=0; i<dof_values.size(); ++i)
+      dof_values[i] = std::sin(1.0 + i);
+
+    // use a number of points that is not a multiple of the SIMD width
+    std::vector<dealii::Point<dim> > points;
+    for (unsigned int p=0; p<7; ++p)
+      {
+        dealii::Point<dim> point;
+        for (unsigned int d=0; d<dim; ++d)
+          point[d] = 0.5 + 0.45 * std::sin(3.0 * p + d);
+        points.push_back(point);
+      }
+
+    std::vector<double> values;
+    std::vector<dealii::Tensor<1,dim> > gradients;
+    evaluator.evaluate(n_components, dof_values, points, values, &gradients);
+
+    for (unsigned int p=0; p<points.size(); ++p)
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          double value = 0;
+          dealii::Tensor<1,dim> gradient;
+          for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+            {
+              value += dof_values[c * fe.dofs_per_cell + i] * fe.shape_value(i, points[p]);
+              gradient += dof_values[c * fe.dofs_per_cell + i] * fe.shape_grad(i, points[p]);
+            }
+
+          REQUIRE(values[p * n_components + c] == Approx(value).margin(1e-12));
+          for (unsigned int d=0; d<dim; ++d)
+            REQUIRE(gradients[p * n_components + c][d] == Approx(gradient[d]).margin(1e-12));
+        }
+  }
+}
+
+TEST_CASE("Particle TensorProductEvaluator")
+{
+  check_tensor_product_evaluator(dealii::FE_Q<2>(1));
+  check_tensor_product_evaluator(dealii::FE_Q<2>(2));
+  check_tensor_product_evaluator(dealii::FE_Q<3>(2));
+  check_tensor_product_evaluator(dealii::FE_DGQ<2>(0));
+  check_tensor_product_evaluator(dealii::FE_DGQ<3>(1));
+
+  REQUIRE(aspect::Particle::internal::TensorProductEvaluator<2>::is_supported(dealii::FE_DGP<2>(1)) == false);
+}
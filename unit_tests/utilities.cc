@@ -147,3 +147,30 @@ TEST_CASE("Utilities::AsciiDataLookup manual dim=2 equid")
   REQUIRE(lookup.get_data(Point<2>(1.0,6.0),0) == Approx(5.0));
   REQUIRE(lookup.get_data(Point<2>(1.5,6.0),0) == Approx(5.5));
 }
+
+
+TEST_CASE("Utilities::real_spherical_harmonics")
+{
+  const unsigned int max_degree = 30;
+  const std::vector<double> colatitudes = {0., 0.3, 1.2, dealii::numbers::PI/2., 2.9, dealii::numbers::PI};
+  const std::vector<double> longitudes = {0., 1., 4.};
+
+  std::vector<std::vector<double> > cosine_components;
+  std::vector<std::vector<double> > sine_components;
+
+  for (const double theta : colatitudes)
+    for (const double phi : longitudes)
+      {
+        aspect::Utilities::real_spherical_harmonics(max_degree, theta, phi,
+                                                    cosine_components, sine_components);
+
+        for (unsigned int l=0; l<=max_degree; ++l)
+          for (unsigned int m=0; m<=l; ++m)
+            {
+              INFO("check l=" << l << " m=" << m << " theta=" << theta << " phi=" << phi);
+              const std::pair<double,double> expected = aspect::Utilities::real_spherical_harmonic(l, m, theta, phi);
+              REQUIRE(cosine_components[l][m] == Approx(expected.first).margin(1e-12));
+              REQUIRE(sine_components[l][m] == Approx(expected.second).margin(1e-12));
+            }
+      }
+}